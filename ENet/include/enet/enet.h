@@ -26,6 +26,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <time.h>
 
@@ -118,6 +119,7 @@
 	#include <string.h>
 	#include <errno.h>
 	#include <fcntl.h>
+	#include <sys/mman.h>
 
 	#ifdef __APPLE__
 		#include <mach/clock.h>
@@ -129,6 +131,36 @@
 		#define MSG_NOSIGNAL 0
 	#endif
 
+	/* Batched I/O needs the GNU extensions of libc, which the translation unit holding the implementation
+	   must ask for with _GNU_SOURCE before its first libc header; enet.c does. Without them it falls back to one call per datagram. */
+	#if defined(__linux__) && defined(__USE_GNU) && !defined(ENET_NO_MMSG)
+		#define ENET_MMSG
+		#include <netinet/udp.h>
+
+		#ifndef SOL_UDP
+			#define SOL_UDP 17
+		#endif
+
+		#ifndef UDP_SEGMENT
+			#define UDP_SEGMENT 103
+		#endif
+
+		#ifndef UDP_GRO
+			#define UDP_GRO 104
+		#endif
+
+		#if !defined(ENET_NO_IO_URING) && defined(__has_include)
+			#if __has_include(<linux/io_uring.h>)
+				#include <linux/io_uring.h>
+
+				#ifdef IORING_RECV_MULTISHOT
+					#define ENET_IO_URING
+					#include <sys/syscall.h>
+				#endif
+			#endif
+		#endif
+	#endif
+
 	#ifdef MSG_MAXIOVLEN
 		#define ENET_BUFFER_MAXIMUM MSG_MAXIOVLEN
 	#endif
@@ -217,6 +249,25 @@ extern "C" {
 	#define enet_list_front(list) ((void*)(list)->sentinel.next)
 	#define enet_list_back(list) ((void*)(list)->sentinel.previous)
 
+	enum {
+		ENET_SEQUENCE_RING_MINIMUM_SIZE = 64,
+		ENET_SEQUENCE_RING_MAXIMUM_SIZE = 65536
+	};
+
+	/* Entries indexed by a 16-bit sequence number stored at sequenceOffset inside each entry. */
+	typedef struct _ENetSequenceRing {
+		void** entries;
+		uint32_t capacity;
+		uint32_t count;
+		uint32_t sequenceOffset;
+	} ENetSequenceRing;
+
+	extern void enet_sequence_ring_init(ENetSequenceRing*, size_t);
+	extern void enet_sequence_ring_clear(ENetSequenceRing*);
+	extern void* enet_sequence_ring_find(const ENetSequenceRing*, uint16_t);
+	extern int enet_sequence_ring_insert(ENetSequenceRing*, uint16_t, void*);
+	extern void enet_sequence_ring_remove(ENetSequenceRing*, uint16_t, const void*);
+
 	#define enet_in6_equal(a, b) (memcmp(&a, &b, sizeof(struct in6_addr)) == 0)
 
 /*
@@ -228,15 +279,17 @@ extern "C" {
 */
 
 	enum {
-		ENET_PROTOCOL_MINIMUM_MTU             = 576,
-		ENET_PROTOCOL_MAXIMUM_MTU             = 4096,
-		ENET_PROTOCOL_MAXIMUM_PACKET_COMMANDS = 32,
-		ENET_PROTOCOL_MINIMUM_WINDOW_SIZE     = 4096,
-		ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE     = 65536,
-		ENET_PROTOCOL_MINIMUM_CHANNEL_COUNT   = 1,
-		ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT   = 255,
-		ENET_PROTOCOL_MAXIMUM_PEER_ID         = 0xFFF,
-		ENET_PROTOCOL_MAXIMUM_FRAGMENT_COUNT  = 1024 * 1024
+		ENET_PROTOCOL_MINIMUM_MTU                = 576,
+		ENET_PROTOCOL_MAXIMUM_MTU                = 4096,
+		ENET_PROTOCOL_MAXIMUM_PACKET_COMMANDS    = 32,
+		ENET_PROTOCOL_MINIMUM_WINDOW_SIZE        = 4096,
+		ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE        = 65536,
+		ENET_PROTOCOL_MINIMUM_CHANNEL_COUNT      = 1,
+		ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT      = 255,
+		ENET_PROTOCOL_MAXIMUM_PEER_ID            = 0xFFF,
+		ENET_PROTOCOL_MAXIMUM_EXTENDED_PEER_ID   = 0xFFFF,
+		ENET_PROTOCOL_MAXIMUM_FRAGMENT_COUNT     = 1024 * 1024,
+		ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES = 4
 	};
 
 	typedef enum _ENetProtocolCommand {
@@ -253,17 +306,23 @@ extern "C" {
 		ENET_PROTOCOL_COMMAND_BANDWIDTH_LIMIT          = 10,
 		ENET_PROTOCOL_COMMAND_THROTTLE_CONFIGURE       = 11,
 		ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE_FRAGMENT = 12,
-		ENET_PROTOCOL_COMMAND_COUNT                    = 13,
+		ENET_PROTOCOL_COMMAND_SELECTIVE_ACKNOWLEDGE    = 13,
+		ENET_PROTOCOL_COMMAND_SEND_PARITY              = 14,
+		ENET_PROTOCOL_COMMAND_PROBE_MTU                = 15,
+		ENET_PROTOCOL_COMMAND_COUNT                    = 16,
 		ENET_PROTOCOL_COMMAND_MASK                     = 0x0F
 	} ENetProtocolCommand;
 
 	typedef enum _ENetProtocolFlag {
-		ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE = (1 << 7),
-		ENET_PROTOCOL_COMMAND_FLAG_UNSEQUENCED = (1 << 6),
-		ENET_PROTOCOL_HEADER_FLAG_SENT_TIME    = (1 << 14),
-		ENET_PROTOCOL_HEADER_FLAG_MASK         = ENET_PROTOCOL_HEADER_FLAG_SENT_TIME,
-		ENET_PROTOCOL_HEADER_SESSION_MASK      = (3 << 12),
-		ENET_PROTOCOL_HEADER_SESSION_SHIFT     = 12
+		ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE           = (1 << 7),
+		ENET_PROTOCOL_COMMAND_FLAG_UNSEQUENCED           = (1 << 6),
+		ENET_PROTOCOL_COMMAND_FLAG_EXTENDED_PEER_ID      = (1 << 5),
+		ENET_PROTOCOL_COMMAND_FLAG_SELECTIVE_ACKNOWLEDGE = (1 << 4),
+		ENET_PROTOCOL_HEADER_FLAG_SENT_TIME              = (1 << 14),
+		ENET_PROTOCOL_HEADER_FLAG_EXTENDED_PEER_ID       = (1 << 15),
+		ENET_PROTOCOL_HEADER_FLAG_MASK                   = ENET_PROTOCOL_HEADER_FLAG_SENT_TIME | ENET_PROTOCOL_HEADER_FLAG_EXTENDED_PEER_ID,
+		ENET_PROTOCOL_HEADER_SESSION_MASK                = (3 << 12),
+		ENET_PROTOCOL_HEADER_SESSION_SHIFT               = 12
 	} ENetProtocolFlag;
 
 	#ifdef _MSC_VER
@@ -292,6 +351,19 @@ extern "C" {
 		uint16_t receivedSentTime;
 	} ENET_PACKED ENetProtocolAcknowledge;
 
+	typedef struct _ENetProtocolAcknowledgeRange {
+		uint16_t startSequenceNumber;
+		uint16_t endSequenceNumber;
+	} ENET_PACKED ENetProtocolAcknowledgeRange;
+
+	/* Everything up to receivedReliableSequenceNumber, plus the listed ranges, has reached the receiver on this channel. */
+	typedef struct _ENetProtocolSelectiveAcknowledge {
+		ENetProtocolCommandHeader header;
+		uint16_t receivedReliableSequenceNumber;
+		uint16_t rangeCount;
+		ENetProtocolAcknowledgeRange ranges[ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES];
+	} ENET_PACKED ENetProtocolSelectiveAcknowledge;
+
 	typedef struct _ENetProtocolConnect {
 		ENetProtocolCommandHeader header;
 		uint16_t outgoingPeerID;
@@ -374,9 +446,32 @@ extern "C" {
 		uint32_t fragmentOffset;
 	} ENET_PACKED ENetProtocolSendFragment;
 
+	/* Identifies an unreliable command by its sequence numbers, or an unsequenced command by its group. */
+	typedef struct _ENetProtocolParityMember {
+		uint16_t reliableSequenceNumber;
+		uint16_t unreliableSequenceNumber;
+	} ENET_PACKED ENetProtocolParityMember;
+
+	/* Followed by memberCount members, then the XOR of their payloads with each zero-padded to the longest. */
+	typedef struct _ENetProtocolSendParity {
+		ENetProtocolCommandHeader header;
+		uint8_t memberCommand;
+		uint8_t memberCount;
+		uint16_t lengthParity;
+		uint16_t dataLength;
+	} ENET_PACKED ENetProtocolSendParity;
+
+	/* A probe is followed by dataLength bytes of padding that fill a datagram of probeSize; the echo confirming it carries none. */
+	typedef struct _ENetProtocolProbeMtu {
+		ENetProtocolCommandHeader header;
+		uint16_t probeSize;
+		uint16_t dataLength;
+	} ENET_PACKED ENetProtocolProbeMtu;
+
 	typedef union _ENetProtocol {
 		ENetProtocolCommandHeader header;
 		ENetProtocolAcknowledge acknowledge;
+		ENetProtocolSelectiveAcknowledge selectiveAcknowledge;
 		ENetProtocolConnect connect;
 		ENetProtocolVerifyConnect verifyConnect;
 		ENetProtocolDisconnect disconnect;
@@ -385,6 +480,8 @@ extern "C" {
 		ENetProtocolSendUnreliable sendUnreliable;
 		ENetProtocolSendUnsequenced sendUnsequenced;
 		ENetProtocolSendFragment sendFragment;
+		ENetProtocolSendParity sendParity;
+		ENetProtocolProbeMtu probeMtu;
 		ENetProtocolBandwidthLimit bandwidthLimit;
 		ENetProtocolThrottleConfigure throttleConfigure;
 	} ENET_PACKED ENetProtocol;
@@ -414,16 +511,17 @@ extern "C" {
 	} ENetSocketWait;
 
 	typedef enum _ENetSocketOption {
-		ENET_SOCKOPT_NONBLOCK    = 1,
-		ENET_SOCKOPT_BROADCAST   = 2,
-		ENET_SOCKOPT_RCVBUF      = 3,
-		ENET_SOCKOPT_SNDBUF      = 4,
-		ENET_SOCKOPT_REUSEADDR   = 5,
-		ENET_SOCKOPT_RCVTIMEO    = 6,
-		ENET_SOCKOPT_SNDTIMEO    = 7,
-		ENET_SOCKOPT_ERROR       = 8,
-		ENET_SOCKOPT_NODELAY     = 9,
-		ENET_SOCKOPT_IPV6_V6ONLY = 10
+		ENET_SOCKOPT_NONBLOCK     = 1,
+		ENET_SOCKOPT_BROADCAST    = 2,
+		ENET_SOCKOPT_RCVBUF       = 3,
+		ENET_SOCKOPT_SNDBUF       = 4,
+		ENET_SOCKOPT_REUSEADDR    = 5,
+		ENET_SOCKOPT_RCVTIMEO     = 6,
+		ENET_SOCKOPT_SNDTIMEO     = 7,
+		ENET_SOCKOPT_ERROR        = 8,
+		ENET_SOCKOPT_NODELAY      = 9,
+		ENET_SOCKOPT_IPV6_V6ONLY  = 10,
+		ENET_SOCKOPT_DONTFRAGMENT = 11
 	} ENetSocketOption;
 
 	typedef enum _ENetSocketShutdown {
@@ -444,6 +542,34 @@ extern "C" {
 		uint16_t port;
 	} ENetAddress;
 
+	typedef enum _ENetHostOffload {
+		ENET_HOST_OFFLOAD_NONE = 0,
+		ENET_HOST_OFFLOAD_GSO  = (1 << 0),
+		ENET_HOST_OFFLOAD_GRO  = (1 << 1)
+	} ENetHostOffload;
+
+	/* io_uring trades the per-call syscalls of the socket path for ring bookkeeping; on a single flow it is not faster than
+	   batched sockets, so measure before choosing it. SQPOLL adds a kernel thread that polls the submission ring and needs a
+	   core to itself: with one CPU online it only takes turns with the service thread, so the host uses plain io_uring then. */
+	typedef enum _ENetHostBackend {
+		ENET_HOST_BACKEND_SOCKET          = 0,
+		ENET_HOST_BACKEND_IO_URING        = 1,
+		ENET_HOST_BACKEND_IO_URING_SQPOLL = 2
+	} ENetHostBackend;
+
+	/* How a host keeps what it sends each peer within what the path carries. */
+	typedef enum _ENetCongestionControl {
+		ENET_CONGESTION_CONTROL_THROTTLE = 0,
+		ENET_CONGESTION_CONTROL_DELAY    = 1
+	} ENetCongestionControl;
+
+	/* How enet_crc64 walks its input; all give the same checksum. */
+	typedef enum _ENetCrc64Method {
+		ENET_CRC64_BYTEWISE = 0,
+		ENET_CRC64_SLICED   = 1,
+		ENET_CRC64_FOLDED   = 2
+	} ENetCrc64Method;
+
 	typedef enum _ENetPacketFlag {
 		ENET_PACKET_FLAG_NONE                  = 0,
 		ENET_PACKET_FLAG_RELIABLE              = (1 << 0),
@@ -469,6 +595,7 @@ extern "C" {
 	typedef struct _ENetAcknowledgement {
 		ENetListNode acknowledgementList;
 		uint32_t sentTime;
+		uint32_t receivedTime;
 		ENetProtocol command;
 	} ENetAcknowledgement;
 
@@ -482,6 +609,9 @@ extern "C" {
 		uint32_t fragmentOffset;
 		uint16_t fragmentLength;
 		uint16_t sendAttempts;
+		uint16_t laterAcknowledgements;
+		uint16_t inTransit;
+		uint16_t datagramSize;
 		ENetProtocol command;
 		ENetPacket* packet;
 	} ENetOutgoingCommand;
@@ -514,9 +644,24 @@ extern "C" {
 		ENET_HOST_BUFFER_SIZE_MIN              = 256 * 1024,
 		ENET_HOST_BUFFER_SIZE_MAX              = 1024 * 1024,
 		ENET_HOST_BANDWIDTH_THROTTLE_INTERVAL  = 1000,
+		ENET_HOST_CONNECT_COOKIE_INTERVAL      = 10000,
 		ENET_HOST_DEFAULT_MTU                  = 1280,
+		ENET_HOST_DEFAULT_RECEIVE_BUDGET       = 256,
 		ENET_HOST_DEFAULT_MAXIMUM_PACKET_SIZE  = 32 * 1024 * 1024,
 		ENET_HOST_DEFAULT_MAXIMUM_WAITING_DATA = 32 * 1024 * 1024,
+		ENET_HOST_DEFAULT_IO_BATCH_SIZE        = 32,
+		ENET_HOST_MAXIMUM_IO_BATCH_SIZE        = 256,
+		ENET_IO_BATCH_GRO_BUFFER_SIZE          = 65535,
+		ENET_IO_BATCH_GSO_MAXIMUM_SIZE         = 65507,
+		ENET_IO_BATCH_GSO_MAXIMUM_SEGMENTS     = 64,
+		ENET_IO_RING_ENTRIES                   = 256,
+		ENET_IO_RING_BUFFER_COUNT              = 256,
+		ENET_IO_RING_SEND_SLOTS                = 128,
+		ENET_IO_RING_SQPOLL_IDLE               = 100,
+		ENET_TIMER_WHEEL_LEVELS                = 4,
+		ENET_TIMER_WHEEL_SLOT_BITS             = 6,
+		ENET_TIMER_WHEEL_SLOTS                 = 1 << ENET_TIMER_WHEEL_SLOT_BITS,
+		ENET_HOST_PEER_TRIM_THRESHOLD          = 64 * 1024,
 		ENET_PEER_DEFAULT_ROUND_TRIP_TIME      = 1,
 		ENET_PEER_DEFAULT_PACKET_THROTTLE      = 32,
 		ENET_PEER_PACKET_THROTTLE_THRESHOLD    = 40,
@@ -525,19 +670,73 @@ extern "C" {
 		ENET_PEER_PACKET_THROTTLE_ACCELERATION = 2,
 		ENET_PEER_PACKET_THROTTLE_DECELERATION = 2,
 		ENET_PEER_PACKET_THROTTLE_INTERVAL     = 5000,
+		ENET_PEER_PACKET_LOSS_SCALE            = (1 << 16),
+		ENET_PEER_PACKET_LOSS_INTERVAL         = 1000,
+		ENET_PEER_DEFAULT_SEND_RATE            = 256 * 1024,
+		ENET_PEER_MINIMUM_SEND_RATE            = 16 * 1024,
+		ENET_PEER_MAXIMUM_SEND_RATE            = 1 << 30,
+		ENET_PEER_CONGESTION_TARGET_DELAY      = 25,
+		ENET_PEER_CONGESTION_MINIMUM_INTERVAL  = 10,
+		ENET_PEER_BASE_DELAY_INTERVAL          = 10000,
+		ENET_PEER_PACING_BURST                 = 4,
+		ENET_PEER_MTU_PROBE_ATTEMPTS           = 3,
+		ENET_PEER_MTU_PROBE_GRANULARITY        = 32,
+		ENET_PEER_MTU_RAISE_INTERVAL           = 600000,
+		ENET_PEER_MTU_BLACK_HOLE_LOSSES        = 3,
 		ENET_PEER_WINDOW_SIZE_SCALE            = 64 * 1024,
 		ENET_PEER_TIMEOUT_LIMIT                = 32,
 		ENET_PEER_TIMEOUT_MINIMUM              = 5000,
 		ENET_PEER_TIMEOUT_MAXIMUM              = 30000,
+		ENET_PEER_FAST_RETRANSMIT_THRESHOLD    = 3,
+		ENET_PEER_ACKNOWLEDGEMENT_THRESHOLD    = 8,
+		ENET_PEER_ACKNOWLEDGEMENT_DELAY_LIMIT  = 200,
 		ENET_PEER_PING_INTERVAL                = 250,
 		ENET_PEER_UNSEQUENCED_WINDOWS          = 64,
 		ENET_PEER_UNSEQUENCED_WINDOW_SIZE      = 1024,
 		ENET_PEER_FREE_UNSEQUENCED_WINDOWS     = 32,
 		ENET_PEER_RELIABLE_WINDOWS             = 16,
 		ENET_PEER_RELIABLE_WINDOW_SIZE         = 0x1000,
-		ENET_PEER_FREE_RELIABLE_WINDOWS        = 8
+		ENET_PEER_FREE_RELIABLE_WINDOWS        = 8,
+		ENET_PEER_PARITY_MINIMUM_GROUP         = 2,
+		ENET_PEER_PARITY_MAXIMUM_GROUP         = 8,
+		ENET_PEER_PARITY_INTERLEAVE            = 8,
+		ENET_PEER_PARITY_HOLD                  = 10,
+		ENET_PEER_PARITY_HISTORY               = ENET_PEER_PARITY_INTERLEAVE * ENET_PEER_PARITY_MAXIMUM_GROUP
 	};
 
+	/* Parity over the unreliable commands sent on a channel since its last parity command. */
+	typedef struct _ENetParityGroup {
+		uint8_t memberCommand;
+		uint8_t memberCount;
+		uint8_t groupSize;
+		uint16_t dataLength;
+		uint16_t lengthParity;
+		ENetProtocolParityMember members[ENET_PEER_PARITY_MAXIMUM_GROUP];
+		uint8_t data[ENET_PROTOCOL_MAXIMUM_MTU];
+	} ENetParityGroup;
+
+	/* The groups of a channel, which the commands sharing a datagram are spread across since a dropped datagram takes all of them. */
+	typedef struct _ENetParityGroups {
+		uint32_t datagram;
+		uint8_t nextGroup;
+		ENetParityGroup groups[ENET_PEER_PARITY_INTERLEAVE];
+	} ENetParityGroups;
+
+	typedef struct _ENetParityRecord {
+		uint8_t command;
+		uint16_t reliableSequenceNumber;
+		uint16_t unreliableSequenceNumber;
+		size_t dataLength;
+		size_t dataCapacity;
+		uint8_t* data;
+	} ENetParityRecord;
+
+	/* The unreliable commands most recently received on a channel, kept to rebuild one that a parity command finds missing. */
+	typedef struct _ENetParityHistory {
+		uint32_t nextRecord;
+		ENetParityRecord records[ENET_PEER_PARITY_HISTORY];
+	} ENetParityHistory;
+
 	typedef struct _ENetChannel {
 		uint16_t outgoingReliableSequenceNumber;
 		uint16_t outgoingUnreliableSequenceNumber;
@@ -545,37 +744,52 @@ extern "C" {
 		uint16_t reliableWindows[ENET_PEER_RELIABLE_WINDOWS];
 		uint16_t incomingReliableSequenceNumber;
 		uint16_t incomingUnreliableSequenceNumber;
+		uint16_t acknowledgedReliableSequenceNumber;
 		ENetList incomingReliableCommands;
 		ENetList incomingUnreliableCommands;
+		ENetSequenceRing incomingReliableIndex;
+		ENetSequenceRing sentReliableIndex;
+		uint8_t parity;
+		ENetParityGroups* outgoingParity;
+		ENetParityHistory* incomingParity;
 	} ENetChannel;
 
+	typedef enum _ENetPeerSendState {
+		ENET_PEER_SEND_NONE   = 0,
+		ENET_PEER_SEND_ACTIVE = 1,
+		ENET_PEER_SEND_TIMER  = 2
+	} ENetPeerSendState;
+
+	/* Fields are grouped by access: connection lookup and per-packet state first, then throttle and RTT, then queues, with statistics and user data last. */
 	typedef struct _ENetPeer {
 		ENetListNode dispatchList;
-		struct _ENetHost* host;
+		ENetPeerState state;
+		uint32_t connectID;
 		uint16_t outgoingPeerID;
 		uint16_t incomingPeerID;
-		uint32_t connectID;
 		uint8_t outgoingSessionID;
 		uint8_t incomingSessionID;
+		uint8_t selectiveAcknowledge;
+		uint8_t connectChallenged;
 		ENetAddress address;
-		void* data;
-		ENetPeerState state;
-		ENetChannel* channels;
-		size_t channelCount;
+		ENetListNode slotList;
+		uint32_t mtu;
+		uint32_t mtuSearchLimit;
+		uint32_t mtuProbeSize;
+		uint32_t mtuProbeAttempts;
+		uint32_t mtuProbeTime;
+		uint32_t mtuBlackHoleLosses;
+		uint32_t mtuLossTime;
+		uint32_t mtuLossSize;
+		struct _ENetHost* host;
+		uint32_t lastReceiveTime;
+		uint32_t lastSendTime;
+		uint32_t incomingDataTotal;
+		uint32_t outgoingDataTotal;
 		uint32_t incomingBandwidth;
 		uint32_t outgoingBandwidth;
 		uint32_t incomingBandwidthThrottleEpoch;
 		uint32_t outgoingBandwidthThrottleEpoch;
-		uint32_t incomingDataTotal;
-		uint64_t totalDataReceived;
-		uint32_t outgoingDataTotal;
-		uint64_t totalDataSent;
-		uint32_t lastSendTime;
-		uint32_t lastReceiveTime;
-		uint32_t nextTimeout;
-		uint32_t earliestTimeout;
-		uint64_t totalPacketsSent;
-		uint64_t totalPacketsLost;
 		uint32_t packetThrottle;
 		uint32_t packetThrottleThreshold;
 		uint32_t packetThrottleLimit;
@@ -584,31 +798,66 @@ extern "C" {
 		uint32_t packetThrottleAcceleration;
 		uint32_t packetThrottleDeceleration;
 		uint32_t packetThrottleInterval;
-		uint32_t pingInterval;
-		uint32_t timeoutLimit;
-		uint32_t timeoutMinimum;
-		uint32_t timeoutMaximum;
+		uint32_t packetLoss;
+		uint32_t packetLossEpoch;
+		uint32_t packetsSent;
+		uint32_t packetsLost;
+		uint32_t sendRate;
+		uint32_t baseRoundTripTime;
+		uint32_t baseRoundTripTimeEpoch;
+		uint32_t congestionEpoch;
+		uint32_t congestionDelay;
+		uint32_t congestionDataSent;
+		uint32_t congestionDecreaseTime;
+		uint32_t congestionQueueDelay;
+		uint32_t congestionDataAcknowledged;
+		uint8_t congestionLimited;
+		uint32_t deliveryRate;
+		int32_t pacingCredit;
+		uint32_t pacingTime;
+		uint32_t nextTimeout;
+		uint32_t earliestTimeout;
+		uint32_t windowSize;
+		uint32_t reliableDataInTransit;
 		uint32_t lastRoundTripTime;
 		uint32_t lowestRoundTripTime;
 		uint32_t lastRoundTripTimeVariance;
 		uint32_t highestRoundTripTimeVariance;
 		uint32_t roundTripTime;
 		uint32_t roundTripTimeVariance;
-		uint32_t mtu;
-		uint32_t windowSize;
-		uint32_t reliableDataInTransit;
+		uint32_t remoteAcknowledgementDelay;
+		uint32_t pingInterval;
+		uint32_t timeoutLimit;
+		uint32_t timeoutMinimum;
+		uint32_t timeoutMaximum;
 		uint16_t outgoingReliableSequenceNumber;
+		uint16_t incomingUnsequencedGroup;
+		uint16_t outgoingUnsequencedGroup;
+		ENetChannel* channels;
+		size_t channelCount;
+		ENetListNode sendList;
 		ENetList acknowledgements;
+		uint32_t acknowledgementCount;
+		uint8_t acknowledgeImmediately;
 		ENetList sentReliableCommands;
+		ENetSequenceRing sentSystemIndex;
 		ENetList sentUnreliableCommands;
 		ENetList outgoingCommands;
 		ENetList dispatchedCommands;
+		ENetPeerSendState sendState;
+		uint32_t nextSendCheck;
 		int needsDispatch;
-		uint16_t incomingUnsequencedGroup;
-		uint16_t outgoingUnsequencedGroup;
-		uint32_t unsequencedWindow[ENET_PEER_UNSEQUENCED_WINDOW_SIZE / 32];
+		uint32_t dispatchEpoch;
+		uint32_t dispatchCount;
 		uint32_t eventData;
+		void* data;
+		uint64_t totalDataReceived;
+		uint64_t totalDataSent;
+		uint64_t totalPacketsSent;
+		uint64_t totalPacketsLost;
+		uint64_t totalPacketsRepaired;
 		size_t totalWaitingData;
+		uint32_t unsequencedWindow[ENET_PEER_UNSEQUENCED_WINDOW_SIZE / 32];
 	} ENetPeer;
 
 	typedef enum _ENetEventType {
@@ -631,6 +880,25 @@ extern "C" {
 
 	typedef int (ENET_CALLBACK *ENetInterceptCallback)(ENetEvent* event, ENetAddress* address, uint8_t* receivedData, int receivedDataLength);
 
+	typedef uint32_t (ENET_CALLBACK *ENetTimeSource)(void);
+
+	typedef struct _ENetIoBatch ENetIoBatch;
+	typedef struct _ENetIoRing ENetIoRing;
+
+	typedef struct _ENetHostMemoryUsage {
+		size_t peerSlots;
+		size_t usedPeerSlots;
+		size_t connectedPeers;
+		size_t reservedBytes;
+		size_t usedBytes;
+	} ENetHostMemoryUsage;
+
+	typedef struct _ENetHostBudgetStats {
+		uint64_t receiveBudgetExhausted;
+		uint64_t sendBudgetExhausted;
+		uint64_t peerDispatchLimitReached;
+	} ENetHostBudgetStats;
+
 	typedef struct _ENetHost {
 		ENetSocket socket;
 		ENetAddress address;
@@ -638,14 +906,32 @@ extern "C" {
 		uint32_t outgoingBandwidth;
 		uint32_t bandwidthThrottleEpoch;
 		uint32_t mtu;
+		uint32_t maximumMtu;
 		uint32_t randomSeed;
 		int recalculateBandwidthLimits;
 		uint8_t preventConnections;
+		uint8_t selectiveAcknowledge;
+		uint32_t acknowledgementDelay;
+		uint32_t acknowledgementThreshold;
+		ENetCongestionControl congestionControl;
 		ENetPeer* peers;
 		size_t peerCount;
+		size_t peerSlotCount;
+		size_t peerSlotBytes;
+		ENetList freePeerSlots[2];
+		ENetList* addressBuckets;
+		size_t addressBucketMask;
+		uint64_t addressHashKey[2];
 		size_t channelLimit;
 		uint32_t serviceTime;
+		uint32_t receiveTime;
+		uint32_t receiveGap;
 		ENetList dispatchQueue;
+		ENetList deferredDispatchQueue;
+		uint32_t dispatchEpoch;
+		ENetList activePeers;
+		ENetList timerWheel[ENET_TIMER_WHEEL_LEVELS][ENET_TIMER_WHEEL_SLOTS];
+		uint32_t timerWheelTime;
 		int continueSending;
 		size_t packetSize;
 		uint16_t headerFlags;
@@ -666,8 +952,19 @@ extern "C" {
 		size_t connectedPeers;
 		size_t bandwidthLimitedPeers;
 		size_t duplicatePeers;
+		uint8_t connectCookies;
+		uint64_t connectCookieKey[2];
+		uint32_t receiveBudget;
+		uint32_t sendBudget;
+		uint32_t peerDispatchLimit;
+		ENetHostBudgetStats budgetStats;
 		size_t maximumPacketSize;
 		size_t maximumWaitingData;
+		size_t ioBatchSize;
+		ENetIoBatch* ioBatch;
+		uint32_t udpOffload;
+		ENetIoRing* ioRing;
+		ENetHostBackend backend;
 	} ENetHost;
 
 /*
@@ -684,7 +981,10 @@ extern "C" {
 	ENET_API ENetVersion enet_linked_version(void);
 	ENET_API int enet_array_is_zeroed(const uint8_t*, int);
 	ENET_API uint32_t enet_time_get(void);
+	ENET_API void enet_time_set_source(ENetTimeSource);
 	ENET_API uint64_t enet_crc64(const ENetBuffer*, int);
+	ENET_API int enet_crc64_set_method(ENetCrc64Method);
+	ENET_API ENetCrc64Method enet_crc64_get_method(void);
 
 	ENET_API ENetPacket* enet_packet_create(const void*, size_t, uint32_t);
 	ENET_API ENetPacket* enet_packet_create_offset(const void*, size_t, size_t, uint32_t);
@@ -700,10 +1000,18 @@ extern "C" {
 	ENET_API void enet_peer_disconnect_now(ENetPeer*, uint32_t);
 	ENET_API void enet_peer_disconnect_later(ENetPeer*, uint32_t);
 	ENET_API void enet_peer_throttle_configure(ENetPeer*, uint32_t, uint32_t, uint32_t, uint32_t);
+	ENET_API void enet_peer_channel_parity(ENetPeer*, uint8_t, uint8_t);
 
 	ENET_API ENetHost* enet_host_create(const ENetAddress*, size_t, size_t, uint32_t, uint32_t, int);
+	ENET_API ENetHost* enet_host_create_with_backend(const ENetAddress*, size_t, size_t, uint32_t, uint32_t, int, ENetHostBackend);
 	ENET_API void enet_host_destroy(ENetHost*);
 	ENET_API void enet_host_prevent_connections(ENetHost*, uint8_t);
+	ENET_API void enet_host_selective_acknowledge(ENetHost*, uint8_t);
+	ENET_API void enet_host_acknowledgement_delay(ENetHost*, uint32_t, uint32_t);
+	ENET_API void enet_host_service_budget(ENetHost*, uint32_t, uint32_t, uint32_t);
+	ENET_API void enet_host_congestion_control(ENetHost*, ENetCongestionControl);
+	ENET_API void enet_host_mtu_discovery(ENetHost*, uint32_t);
+	ENET_API void enet_host_connect_cookies(ENetHost*, const uint8_t*);
 	ENET_API ENetPeer* enet_host_connect(ENetHost*, const ENetAddress*, size_t, uint32_t);
 	ENET_API int enet_host_check_events(ENetHost*, ENetEvent*);
 	ENET_API int enet_host_service(ENetHost*, ENetEvent*, uint32_t);
@@ -713,6 +1021,8 @@ extern "C" {
 	ENET_API void enet_host_broadcast_selective(ENetHost*, uint8_t, ENetPacket*, ENetPeer**, size_t);
 	ENET_API void enet_host_channel_limit(ENetHost*, size_t);
 	ENET_API void enet_host_bandwidth_limit(ENetHost*, uint32_t, uint32_t);
+	ENET_API int enet_host_set_io_batch_size(ENetHost*, size_t);
+	ENET_API uint32_t enet_host_set_udp_offload(ENetHost*, uint32_t);
 
 	ENET_API int enet_address_set_ip(ENetAddress*, const char*);
 	ENET_API int enet_address_set_hostname(ENetAddress*, const char*);
@@ -751,6 +1061,12 @@ extern "C" {
 	ENET_API void enet_host_set_max_duplicate_peers(ENetHost*, uint16_t);
 	ENET_API void enet_host_set_intercept_callback(ENetHost*, ENetInterceptCallback);
 	ENET_API void enet_host_set_checksum_callback(ENetHost*, ENetChecksumCallback);
+	ENET_API size_t enet_host_get_io_batch_size(const ENetHost*);
+	ENET_API uint32_t enet_host_get_udp_offload(const ENetHost*);
+	ENET_API ENetHostBackend enet_host_get_backend(const ENetHost*);
+	ENET_API ENetCongestionControl enet_host_get_congestion_control(const ENetHost*);
+	ENET_API void enet_host_get_memory_usage(const ENetHost*, ENetHostMemoryUsage*);
+	ENET_API void enet_host_get_budget_stats(const ENetHost*, ENetHostBudgetStats*);
 
 	ENET_API uint32_t enet_peer_get_id(const ENetPeer*);
 	ENET_API int enet_peer_get_ip(const ENetPeer*, char*, size_t);
@@ -763,7 +1079,10 @@ extern "C" {
 	ENET_API uint32_t enet_peer_get_lastreceivetime(const ENetPeer*);
 	ENET_API uint64_t enet_peer_get_packets_sent(const ENetPeer*);
 	ENET_API uint64_t enet_peer_get_packets_lost(const ENetPeer*);
+	ENET_API uint64_t enet_peer_get_packets_repaired(const ENetPeer*);
+	ENET_API float enet_peer_get_packet_loss(const ENetPeer*);
 	ENET_API float enet_peer_get_packets_throttle(const ENetPeer*);
+	ENET_API uint32_t enet_peer_get_bandwidth_estimate(const ENetPeer*);
 	ENET_API uint64_t enet_peer_get_bytes_sent(const ENetPeer*);
 	ENET_API uint64_t enet_peer_get_bytes_received(const ENetPeer*);
 	ENET_API void* enet_peer_get_data(const ENetPeer*);
@@ -779,9 +1098,27 @@ extern "C" {
 
 	extern void enet_host_bandwidth_throttle(ENetHost*);
 	extern uint64_t enet_host_random_seed(void);
+	extern ENetPeer* enet_host_grow_peer_slots(ENetHost*);
+	extern void enet_host_trim_peer_slots(ENetHost*);
+	extern ENetPeer* enet_host_acquire_peer_slot(ENetHost*, int);
+	extern void enet_host_index_peer(ENetHost*, ENetPeer*);
+	extern void enet_host_release_peer_slot(ENetHost*, ENetPeer*);
+
+	extern void enet_timer_wheel_schedule(ENetHost*, ENetPeer*, uint32_t);
+	extern void enet_timer_wheel_advance(ENetHost*);
+	extern uint32_t enet_timer_wheel_next_deadline(ENetHost*, uint32_t);
+
+	extern size_t enet_memory_page_size(void);
+	extern void* enet_memory_reserve(size_t);
+	extern int enet_memory_commit(void*, size_t);
+	extern void enet_memory_discard(void*, size_t);
+	extern void enet_memory_release(void*, size_t);
 
 	extern int enet_peer_throttle(ENetPeer*, uint32_t);
+	extern void enet_peer_delay_control(ENetPeer*, uint32_t);
+	extern void enet_peer_delay_loss(ENetPeer*, uint32_t);
 	extern void enet_peer_reset_queues(ENetPeer*);
+	extern void enet_peer_mark_active(ENetPeer*);
 	extern void enet_peer_setup_outgoing_command(ENetPeer*, ENetOutgoingCommand*);
 	extern ENetOutgoingCommand* enet_peer_queue_outgoing_command(ENetPeer*, const ENetProtocol*, ENetPacket*, uint32_t, uint16_t);
 	extern ENetIncomingCommand* enet_peer_queue_incoming_command(ENetPeer*, const ENetProtocol*, const void*, size_t, uint32_t, uint32_t);
@@ -793,6 +1130,25 @@ extern "C" {
 
 	extern size_t enet_protocol_command_size(uint8_t);
 
+	extern int enet_socket_message_too_large(void);
+
+	extern ENetIoBatch* enet_io_batch_create(size_t, uint32_t);
+	extern void enet_io_batch_destroy(ENetIoBatch*);
+	extern int enet_io_batch_pending(const ENetIoBatch*);
+	extern uint32_t enet_io_batch_probe_offload(ENetSocket, uint32_t);
+	extern uint32_t enet_io_batch_get_offload(const ENetIoBatch*);
+	extern int enet_io_batch_receive(ENetSocket, ENetIoBatch*, size_t, ENetAddress*, uint8_t**);
+	extern int enet_io_batch_send(ENetSocket, ENetIoBatch*, const ENetAddress*, const ENetBuffer*, size_t);
+	extern int enet_io_batch_flush(ENetSocket, ENetIoBatch*);
+
+	extern ENetIoRing* enet_io_ring_create(ENetSocket, int);
+	extern void enet_io_ring_destroy(ENetIoRing*);
+	extern int enet_io_ring_pending(const ENetIoRing*);
+	extern int enet_io_ring_receive(ENetSocket, ENetIoRing*, size_t, ENetAddress*, uint8_t**);
+	extern int enet_io_ring_send(ENetSocket, ENetIoRing*, const ENetAddress*, const ENetBuffer*, size_t);
+	extern int enet_io_ring_flush(ENetIoRing*);
+	extern int enet_io_ring_wait(ENetSocket, ENetIoRing*, uint32_t*, uint64_t);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1097,6 +1453,100 @@ extern "C" {
 		return size;
 	}
 
+/*
+=======================================================================
+
+	Sequence ring
+
+=======================================================================
+*/
+
+	#define enet_sequence_ring_entry_sequence(ring, entry) (*(const uint16_t*)((const uint8_t*)(entry) + (ring)->sequenceOffset))
+
+	void enet_sequence_ring_init(ENetSequenceRing* ring, size_t sequenceOffset) {
+		ring->entries = NULL;
+		ring->capacity = 0;
+		ring->count = 0;
+		ring->sequenceOffset = (uint32_t)sequenceOffset;
+	}
+
+	void enet_sequence_ring_clear(ENetSequenceRing* ring) {
+		if (ring->entries != NULL)
+			enet_free(ring->entries);
+
+		ring->entries = NULL;
+		ring->capacity = 0;
+		ring->count = 0;
+	}
+
+	void* enet_sequence_ring_find(const ENetSequenceRing* ring, uint16_t sequenceNumber) {
+		void* entry;
+
+		if (ring->capacity == 0)
+			return NULL;
+
+		entry = ring->entries[sequenceNumber & (ring->capacity - 1)];
+
+		return entry != NULL && enet_sequence_ring_entry_sequence(ring, entry) == sequenceNumber ? entry : NULL;
+	}
+
+	/* Entries that do not share a slot at one capacity cannot share one at twice that capacity, so rehashing never collides. */
+	static int enet_sequence_ring_grow(ENetSequenceRing* ring) {
+		uint32_t capacity = ring->capacity > 0 ? ring->capacity * 2 : ENET_SEQUENCE_RING_MINIMUM_SIZE;
+		void** entries;
+		uint32_t slot;
+
+		if (capacity > ENET_SEQUENCE_RING_MAXIMUM_SIZE)
+			return -1;
+
+		entries = (void**)enet_malloc(capacity * sizeof(void*));
+
+		if (entries == NULL)
+			return -1;
+
+		memset(entries, 0, capacity * sizeof(void*));
+
+		for (slot = 0; slot < ring->capacity; ++slot) {
+			if (ring->entries[slot] != NULL)
+				entries[enet_sequence_ring_entry_sequence(ring, ring->entries[slot]) & (capacity - 1)] = ring->entries[slot];
+		}
+
+		if (ring->entries != NULL)
+			enet_free(ring->entries);
+
+		ring->entries = entries;
+		ring->capacity = capacity;
+
+		return 0;
+	}
+
+	/* The sequence number must not already be in the ring. */
+	int enet_sequence_ring_insert(ENetSequenceRing* ring, uint16_t sequenceNumber, void* entry) {
+		while (ring->capacity == 0 || ring->entries[sequenceNumber & (ring->capacity - 1)] != NULL) {
+			if (enet_sequence_ring_grow(ring) < 0)
+				return -1;
+		}
+
+		ring->entries[sequenceNumber & (ring->capacity - 1)] = entry;
+		++ring->count;
+
+		return 0;
+	}
+
+	void enet_sequence_ring_remove(ENetSequenceRing* ring, uint16_t sequenceNumber, const void* entry) {
+		void** slot;
+
+		if (ring->capacity == 0)
+			return;
+
+		slot = &ring->entries[sequenceNumber & (ring->capacity - 1)];
+
+		if (*slot == entry) {
+			*slot = NULL;
+			--ring->count;
+		}
+	}
+
 /*
 =======================================================================
 
@@ -1211,9 +1661,19 @@ extern "C" {
 		}
 	#endif
 
+	static ENetTimeSource enet_time_source = NULL;
+
+	/* Replaces the monotonic clock for every host, so a test or simulation can decide when time passes; NULL restores it. Set it while no host is being serviced. */
+	void enet_time_set_source(ENetTimeSource source) {
+		enet_time_source = source;
+	}
+
 	uint32_t enet_time_get(void) {
 		static uint64_t start_time_ns = 0;
 
+		if (enet_time_source != NULL)
+			return enet_time_source();
+
 		struct timespec ts;
 
 		#ifdef CLOCK_MONOTONIC_RAW
@@ -1247,6 +1707,19 @@ extern "C" {
 =======================================================================
 */
 
+	#if (defined(__x86_64__) || defined(_M_X64)) && !defined(ENET_NO_CLMUL)
+		#define ENET_CRC64_CLMUL
+
+		#ifdef _MSC_VER
+			#define ENET_CRC64_TARGET
+		#else
+			#include <cpuid.h>
+			#include <wmmintrin.h>
+
+			#define ENET_CRC64_TARGET __attribute__((target("pclmul")))
+		#endif
+	#endif
+
 	typedef uint64_t enet_checksum;
 
 	static const uint64_t crcTable[256] = {
@@ -1380,16 +1853,135 @@ extern "C" {
 		UINT64_C(0x536fa08fdfd90e51), UINT64_C(0x29b7d047efec8728),
 	};
 
+	/* crcSliceTable[n][i] advances the CRC of byte i by n + 1 further zero bytes; filled by enet_initialize. */
+	static uint64_t crcSliceTable[7][256];
+
+	static ENetCrc64Method crcMethod = ENET_CRC64_BYTEWISE;
+
+	#ifdef ENET_CRC64_CLMUL
+		/* Fold multipliers x^n mod P for the reflected polynomial, and the Barrett constants floor(x^128 / P) and P, all bit-reflected. */
+		#define ENET_CRC64_FOLD_127 UINT64_C(0x381d0015c96f4444)
+		#define ENET_CRC64_FOLD_191 UINT64_C(0xd9d7be7d505da32c)
+		#define ENET_CRC64_FOLD_511 UINT64_C(0xf49784a634f014e4)
+		#define ENET_CRC64_FOLD_575 UINT64_C(0xaf86efb16d9ab4fb)
+		#define ENET_CRC64_BARRETT_MU UINT64_C(0x3e6cfa329aef9f77)
+		#define ENET_CRC64_BARRETT_POLY UINT64_C(0x2b5926535897936b)
+
+		static int enet_crc64_clmul_supported(void) {
+			#ifdef _MSC_VER
+				int registers[4];
+
+				__cpuid(registers, 1);
+
+				return (registers[2] & (1 << 1)) != 0;
+			#else
+				unsigned int eax, ebx, ecx, edx;
+
+				if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+					return 0;
+
+				return (ecx & bit_PCLMUL) != 0;
+			#endif
+		}
+
+		ENET_CRC64_TARGET static __m128i enet_crc64_fold(__m128i value, __m128i multipliers, __m128i next) {
+			__m128i low = _mm_clmulepi64_si128(value, multipliers, 0x00);
+			__m128i high = _mm_clmulepi64_si128(value, multipliers, 0x11);
+
+			return _mm_xor_si128(_mm_xor_si128(low, high), next);
+		}
+
+		/* Folds four 16-byte lanes in parallel, then one lane at a time, and reduces the last lane to 64 bits; length is a multiple of 16. */
+		ENET_CRC64_TARGET static uint64_t enet_crc64_folded(uint64_t crc, const uint8_t* data, size_t length) {
+			const __m128i fold128 = _mm_set_epi64x((long long)ENET_CRC64_FOLD_127, (long long)ENET_CRC64_FOLD_191);
+			const __m128i fold512 = _mm_set_epi64x((long long)ENET_CRC64_FOLD_511, (long long)ENET_CRC64_FOLD_575);
+			const __m128i barrett = _mm_set_epi64x((long long)ENET_CRC64_BARRETT_POLY, (long long)ENET_CRC64_BARRETT_MU);
+			const uint8_t* dataEnd = &data[length];
+			__m128i lane0, lane1, lane2, lane3, reduced;
+
+			lane0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_cvtsi64_si128((long long)crc));
+			data += 16;
+
+			if (length >= 64) {
+				lane1 = _mm_loadu_si128((const __m128i*)data);
+				lane2 = _mm_loadu_si128((const __m128i*)(data + 16));
+				lane3 = _mm_loadu_si128((const __m128i*)(data + 32));
+				data += 48;
+
+				while (dataEnd - data >= 64) {
+					lane0 = enet_crc64_fold(lane0, fold512, _mm_loadu_si128((const __m128i*)data));
+					lane1 = enet_crc64_fold(lane1, fold512, _mm_loadu_si128((const __m128i*)(data + 16)));
+					lane2 = enet_crc64_fold(lane2, fold512, _mm_loadu_si128((const __m128i*)(data + 32)));
+					lane3 = enet_crc64_fold(lane3, fold512, _mm_loadu_si128((const __m128i*)(data + 48)));
+					data += 64;
+				}
+
+				lane0 = enet_crc64_fold(lane0, fold128, lane1);
+				lane0 = enet_crc64_fold(lane0, fold128, lane2);
+				lane0 = enet_crc64_fold(lane0, fold128, lane3);
+			}
+
+			for (; data < dataEnd; data += 16) {
+				lane0 = enet_crc64_fold(lane0, fold128, _mm_loadu_si128((const __m128i*)data));
+			}
+
+			lane0 = _mm_xor_si128(_mm_clmulepi64_si128(lane0, fold128, 0x10), _mm_srli_si128(lane0, 8));
+			reduced = _mm_clmulepi64_si128(lane0, barrett, 0x00);
+			reduced = _mm_xor_si128(_mm_clmulepi64_si128(reduced, barrett, 0x10), _mm_slli_si128(reduced, 8));
+
+			return (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(_mm_xor_si128(lane0, reduced), 8));
+		}
+	#endif
+
+	static void enet_crc64_initialize(void) {
+		int slice, index;
+
+		for (index = 0; index < 256; ++index) {
+			uint64_t crc = crcTable[index];
+
+			for (slice = 0; slice < 7; ++slice) {
+				crc = (crc >> 8) ^ crcTable[(uint8_t)crc];
+				crcSliceTable[slice][index] = crc;
+			}
+		}
+
+		crcMethod = ENET_CRC64_SLICED;
+
+		#ifdef ENET_CRC64_CLMUL
+			if (enet_crc64_clmul_supported())
+				crcMethod = ENET_CRC64_FOLDED;
+		#endif
+	}
+
+	/* Carry-less multiplication folds runs of 16 bytes where the processor has it; eight bytes at a time are looked up in the slice tables otherwise. */
+	static uint64_t enet_crc64_update(uint64_t crc, const uint8_t* data, size_t length) {
+		#ifdef ENET_CRC64_CLMUL
+			if (crcMethod == ENET_CRC64_FOLDED && length >= 16) {
+				crc = enet_crc64_folded(crc, data, length & ~(size_t)15);
+				data += length & ~(size_t)15;
+				length &= 15;
+			}
+		#endif
+
+		if (crcMethod != ENET_CRC64_BYTEWISE) {
+			for (; length >= 8; data += 8, length -= 8) {
+				crc ^= (uint64_t)data[0] | (uint64_t)data[1] << 8 | (uint64_t)data[2] << 16 | (uint64_t)data[3] << 24 | (uint64_t)data[4] << 32 | (uint64_t)data[5] << 40 | (uint64_t)data[6] << 48 | (uint64_t)data[7] << 56;
+				crc = crcSliceTable[6][(uint8_t)crc] ^ crcSliceTable[5][(uint8_t)(crc >> 8)] ^ crcSliceTable[4][(uint8_t)(crc >> 16)] ^ crcSliceTable[3][(uint8_t)(crc >> 24)] ^ crcSliceTable[2][(uint8_t)(crc >> 32)] ^ crcSliceTable[1][(uint8_t)(crc >> 40)] ^ crcSliceTable[0][(uint8_t)(crc >> 48)] ^ crcTable[crc >> 56];
+			}
+		}
+
+		while (length-- > 0) {
+			crc = (crc >> 8) ^ crcTable[(uint8_t)crc ^ *data++];
+		}
+
+		return crc;
+	}
+
 	uint64_t enet_crc64(const ENetBuffer* buffers, int bufferCount) {
 		uint64_t crc = 0xFFFFFFFFFFFFFFFF;
 
 		while (bufferCount-- > 0) {
-			const uint8_t* data = (const uint8_t*)buffers->data;
-			const uint8_t* dataEnd = &data[buffers->dataLength];
-
-			while (data < dataEnd) {
-				crc = (crc >> 8) ^ crcTable[(uint8_t)crc ^* data++];
-			}
+			crc = enet_crc64_update(crc, (const uint8_t*)buffers->data, buffers->dataLength);
 
 			++buffers;
 		}
@@ -1397,6 +1989,86 @@ extern "C" {
 		return ENET_HOST_TO_NET_64(~crc);
 	}
 
+	/* Overrides the method enet_initialize picked, for comparing them; fails for one the processor or build lacks. Call after enet_initialize. */
+	int enet_crc64_set_method(ENetCrc64Method method) {
+		switch (method) {
+			case ENET_CRC64_BYTEWISE:
+			case ENET_CRC64_SLICED:
+				break;
+
+			case ENET_CRC64_FOLDED:
+				#ifdef ENET_CRC64_CLMUL
+					if (enet_crc64_clmul_supported())
+						break;
+				#endif
+
+				return -1;
+
+			default:
+				return -1;
+		}
+
+		crcMethod = method;
+
+		return 0;
+	}
+
+	ENetCrc64Method enet_crc64_get_method(void) {
+		return crcMethod;
+	}
+
+	#define ENET_SIPHASH_ROTATE(value, bits) (((value) << (bits)) | ((value) >> (64 - (bits))))
+
+	#define ENET_SIPHASH_ROUND(v0, v1, v2, v3) \
+		v0 += v1; v1 = ENET_SIPHASH_ROTATE(v1, 13); v1 ^= v0; v0 = ENET_SIPHASH_ROTATE(v0, 32); \
+		v2 += v3; v3 = ENET_SIPHASH_ROTATE(v3, 16); v3 ^= v2; \
+		v0 += v3; v3 = ENET_SIPHASH_ROTATE(v3, 21); v3 ^= v0; \
+		v2 += v1; v1 = ENET_SIPHASH_ROTATE(v1, 17); v1 ^= v2; v2 = ENET_SIPHASH_ROTATE(v2, 32)
+
+	/* SipHash-2-4, a keyed hash short inputs cannot be forged against without the key. */
+	static uint64_t enet_siphash(const uint64_t key[2], const uint8_t* data, size_t length) {
+		uint64_t v0 = key[0] ^ UINT64_C(0x736f6d6570736575);
+		uint64_t v1 = key[1] ^ UINT64_C(0x646f72616e646f6d);
+		uint64_t v2 = key[0] ^ UINT64_C(0x6c7967656e657261);
+		uint64_t v3 = key[1] ^ UINT64_C(0x7465646279746573);
+		uint64_t word = (uint64_t)length << 56;
+		size_t index;
+
+		for (; length >= 8; data += 8, length -= 8) {
+			uint64_t block = 0;
+
+			for (index = 0; index < 8; ++index) {
+				block |= (uint64_t)data[index] << (8 * index);
+			}
+
+			v3 ^= block;
+			ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+			ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+			v0 ^= block;
+		}
+
+		for (index = 0; index < length; ++index) {
+			word |= (uint64_t)data[index] << (8 * index);
+		}
+
+		v3 ^= word;
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+		v0 ^= word;
+		v2 ^= 0xFF;
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+		ENET_SIPHASH_ROUND(v0, v1, v2, v3);
+
+		return v0 ^ v1 ^ v2 ^ v3;
+	}
+
+	/* Keyed per host so a sender cannot choose addresses that pile into one bucket; the port is left out so every peer behind an address shares a chain. */
+	static uint64_t enet_host_address_hash(const ENetHost* host, const ENetAddress* address) {
+		return enet_siphash(host->addressHashKey, (const uint8_t*)&address->ipv6, sizeof(struct in6_addr));
+	}
+
 /*
 =======================================================================
 
@@ -1498,19 +2170,37 @@ extern "C" {
 		sizeof(ENetProtocolSendUnsequenced),
 		sizeof(ENetProtocolBandwidthLimit),
 		sizeof(ENetProtocolThrottleConfigure),
-		sizeof(ENetProtocolSendFragment)
+		sizeof(ENetProtocolSendFragment),
+		sizeof(ENetProtocolSelectiveAcknowledge),
+		sizeof(ENetProtocolSendParity),
+		sizeof(ENetProtocolProbeMtu)
 	};
 
 	size_t enet_protocol_command_size(uint8_t commandNumber) {
 		return commandSizes[commandNumber & ENET_PROTOCOL_COMMAND_MASK];
 	}
 
+	/* 0xFFF means "no peer" on the wire, so slots from 0xFFF up take the next id. */
+	static uint16_t enet_peer_id_from_index(size_t index) {
+		return (uint16_t)(index < ENET_PROTOCOL_MAXIMUM_PEER_ID ? index : index + 1);
+	}
+
+	static size_t enet_peer_index_from_id(uint16_t peerID) {
+		return peerID < ENET_PROTOCOL_MAXIMUM_PEER_ID ? peerID : peerID - 1;
+	}
+
+	#define enet_peer_from_slot_list(node) ((ENetPeer*)((uint8_t*)(node) - offsetof(ENetPeer, slotList)))
+
 	static void enet_protocol_change_state(ENetHost* host, ENetPeer* peer, ENetPeerState state) {
 		if (state == ENET_PEER_STATE_CONNECTED || state == ENET_PEER_STATE_DISCONNECT_LATER)
 			enet_peer_on_connect(peer);
 		else
 			enet_peer_on_disconnect(peer);
 
+		/* A peer waiting to probe its path starts as soon as it is connected. */
+		if (state == ENET_PEER_STATE_CONNECTED && peer->mtuProbeSize != 0)
+			enet_peer_mark_active(peer);
+
 		peer->state = state;
 	}
 
@@ -1562,10 +2252,24 @@ extern "C" {
 					event->type = ENET_EVENT_TYPE_RECEIVE;
 					event->peer = peer;
 
+					if (peer->dispatchEpoch != host->dispatchEpoch) {
+						peer->dispatchEpoch = host->dispatchEpoch;
+						peer->dispatchCount = 0;
+					}
+
+					++peer->dispatchCount;
+
+					/* A peer with more to deliver rejoins the back of the queue, or sits out until the next service iteration once it reaches the host's limit. */
 					if (!enet_list_empty(&peer->dispatchedCommands)) {
 						peer->needsDispatch = 1;
 
-						enet_list_insert(enet_list_end(&host->dispatchQueue), &peer->dispatchList);
+						if (host->peerDispatchLimit != 0 && peer->dispatchCount >= host->peerDispatchLimit) {
+							enet_list_insert(enet_list_end(&host->deferredDispatchQueue), &peer->dispatchList);
+
+							++host->budgetStats.peerDispatchLimitReached;
+						} else {
+							enet_list_insert(enet_list_end(&host->dispatchQueue), &peer->dispatchList);
+						}
 					}
 
 					return 1;
@@ -1664,43 +2368,97 @@ extern "C" {
 			enet_peer_disconnect(peer, peer->eventData);
 	}
 
-	static ENetProtocolCommand enet_protocol_remove_sent_reliable_command(ENetPeer* peer, uint16_t reliableSequenceNumber, uint8_t channelID) {
-		ENetOutgoingCommand* outgoingCommand = NULL;
-		ENetListIterator currentCommand;
-		ENetProtocolCommand commandNumber;
+	static int enet_protocol_sequence_in_range(uint16_t sequenceNumber, uint16_t startSequenceNumber, uint16_t endSequenceNumber) {
+		return (uint16_t)(sequenceNumber - startSequenceNumber) <= (uint16_t)(endSequenceNumber - startSequenceNumber);
+	}
 
-		int wasSent = 1;
+	/* The path no longer carries the confirmed MTU, so new fragments are cut at the minimum and the search resumes below the size that stopped getting through. */
+	static void enet_protocol_mtu_black_hole(ENetHost* host, ENetPeer* peer) {
+		peer->mtuBlackHoleLosses = 0;
 
-		for (currentCommand = enet_list_begin(&peer->sentReliableCommands); currentCommand != enet_list_end(&peer->sentReliableCommands); currentCommand = enet_list_next(currentCommand)) {
-			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+		if (peer->mtu <= ENET_PROTOCOL_MINIMUM_MTU)
+			return;
 
-			if (outgoingCommand->reliableSequenceNumber == reliableSequenceNumber && outgoingCommand->command.header.channelID == channelID)
-				break;
-		}
+		peer->mtuSearchLimit = peer->mtu;
+		peer->mtu = ENET_PROTOCOL_MINIMUM_MTU;
+		peer->mtuProbeSize = 0;
+		peer->mtuProbeAttempts = 0;
+		peer->mtuProbeTime = host->serviceTime;
+	}
 
-		if (currentCommand == enet_list_end(&peer->sentReliableCommands)) {
-			for (currentCommand = enet_list_begin(&peer->outgoingCommands); currentCommand != enet_list_end(&peer->outgoingCommands); currentCommand = enet_list_next(currentCommand)) {
-				outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+	/*
+		Counts a lost reliable command that went out in a datagram above the minimum MTU and within the confirmed one, once per send time.
+		ENET_PEER_MTU_BLACK_HOLE_LOSSES of those with no datagram as large as the smallest of them acknowledged in between mean the path has shrunk.
+	*/
+	static void enet_protocol_note_mtu_loss(ENetHost* host, ENetPeer* peer, const ENetOutgoingCommand* outgoingCommand) {
+		if (host->maximumMtu == 0 || outgoingCommand->datagramSize <= ENET_PROTOCOL_MINIMUM_MTU || outgoingCommand->datagramSize > peer->mtu || outgoingCommand->sentTime == peer->mtuLossTime)
+			return;
 
-				if (outgoingCommand->sendAttempts < 1)
-					return ENET_PROTOCOL_COMMAND_NONE;
+		peer->mtuLossTime = outgoingCommand->sentTime;
 
-				if (outgoingCommand->reliableSequenceNumber == reliableSequenceNumber && outgoingCommand->command.header.channelID == channelID)
-					break;
-			}
+		if (peer->mtuBlackHoleLosses == 0 || outgoingCommand->datagramSize < peer->mtuLossSize)
+			peer->mtuLossSize = outgoingCommand->datagramSize;
+
+		if (++peer->mtuBlackHoleLosses >= ENET_PEER_MTU_BLACK_HOLE_LOSSES)
+			enet_protocol_mtu_black_hole(host, peer);
+	}
+
+	/*
+		Credits outgoingCommand with count commands that were sent after it and have since been delivered, and requeues it at insertPosition once that marks it as lost.
+		Only a first transmission that has been outstanding for a round trip is retransmitted early, so reordering cannot turn into a retransmission storm.
+	*/
+	static void enet_protocol_count_later_acknowledgements(ENetPeer* peer, ENetOutgoingCommand* outgoingCommand, size_t count, ENetListIterator insertPosition) {
+		outgoingCommand->laterAcknowledgements = (uint16_t)ENET_MIN(outgoingCommand->laterAcknowledgements + count, ENET_PEER_FAST_RETRANSMIT_THRESHOLD);
+
+		if (outgoingCommand->laterAcknowledgements < ENET_PEER_FAST_RETRANSMIT_THRESHOLD || outgoingCommand->sendAttempts > 1 || ENET_TIME_DIFFERENCE(peer->host->serviceTime, outgoingCommand->sentTime) < peer->roundTripTime + peer->remoteAcknowledgementDelay)
+			return;
+
+		if (outgoingCommand->packet != NULL)
+			peer->reliableDataInTransit -= outgoingCommand->fragmentLength;
+
+		++peer->totalPacketsLost;
+		++peer->packetsLost;
+		outgoingCommand->laterAcknowledgements = 0;
+		enet_protocol_note_mtu_loss(peer->host, peer, outgoingCommand);
+
+		if (peer->host->congestionControl == ENET_CONGESTION_CONTROL_DELAY)
+			enet_peer_delay_loss(peer, outgoingCommand->sentTime);
+
+		outgoingCommand->inTransit = 0;
+
+		enet_list_insert(insertPosition, enet_list_remove(&outgoingCommand->outgoingCommandList));
+	}
+
+	/* Every command sent before acknowledgedCommand has been overtaken by it. */
+	static void enet_protocol_note_later_acknowledgement(ENetPeer* peer, ENetListIterator acknowledgedCommand) {
+		ENetOutgoingCommand* outgoingCommand;
+		ENetListIterator currentCommand, insertPosition;
+		currentCommand = enet_list_begin(&peer->sentReliableCommands);
+		insertPosition = enet_list_begin(&peer->outgoingCommands);
 
-			if (currentCommand == enet_list_end(&peer->outgoingCommands))
-				return ENET_PROTOCOL_COMMAND_NONE;
+		while (currentCommand != acknowledgedCommand) {
+			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+			currentCommand = enet_list_next(currentCommand);
 
-			wasSent = 0;
+			enet_protocol_count_later_acknowledgements(peer, outgoingCommand, 1, insertPosition);
 		}
+	}
 
-		if (outgoingCommand == NULL)
-			return ENET_PROTOCOL_COMMAND_NONE;
+	static ENetSequenceRing* enet_protocol_sent_reliable_index(ENetPeer* peer, uint8_t channelID) {
+		if (channelID == 0xFF)
+			return &peer->sentSystemIndex;
+
+		return channelID < peer->channelCount ? &peer->channels[channelID].sentReliableIndex : NULL;
+	}
+
+	static ENetProtocolCommand enet_protocol_release_sent_reliable_command(ENetPeer* peer, ENetOutgoingCommand* outgoingCommand) {
+		ENetProtocolCommand commandNumber;
+		ENetSequenceRing* sentIndex;
+		uint8_t channelID = outgoingCommand->command.header.channelID;
 
 		if (channelID < peer->channelCount) {
 			ENetChannel* channel = &peer->channels[channelID];
-			uint16_t reliableWindow = reliableSequenceNumber / ENET_PEER_RELIABLE_WINDOW_SIZE;
+			uint16_t reliableWindow = outgoingCommand->reliableSequenceNumber / ENET_PEER_RELIABLE_WINDOW_SIZE;
 
 			if (channel->reliableWindows[reliableWindow] > 0) {
 				--channel->reliableWindows[reliableWindow];
@@ -1710,12 +2468,17 @@ extern "C" {
 			}
 		}
 
+		sentIndex = enet_protocol_sent_reliable_index(peer, channelID);
+
+		if (sentIndex != NULL)
+			enet_sequence_ring_remove(sentIndex, outgoingCommand->reliableSequenceNumber, outgoingCommand);
+
 		commandNumber = (ENetProtocolCommand)(outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK);
 
 		enet_list_remove(&outgoingCommand->outgoingCommandList);
 
 		if (outgoingCommand->packet != NULL) {
-			if (wasSent)
+			if (outgoingCommand->inTransit)
 				peer->reliableDataInTransit -= outgoingCommand->fragmentLength;
 
 			--outgoingCommand->packet->referenceCount;
@@ -1729,6 +2492,36 @@ extern "C" {
 
 		enet_free(outgoingCommand);
 
+		return commandNumber;
+	}
+
+	/* Every reliable command that has been sent at least once stays indexed until it is acknowledged, whether it is in transit or queued for retransmission. */
+	static ENetProtocolCommand enet_protocol_remove_sent_reliable_command(ENetPeer* peer, uint16_t reliableSequenceNumber, uint8_t channelID) {
+		ENetOutgoingCommand* outgoingCommand;
+		ENetSequenceRing* sentIndex;
+		ENetProtocolCommand commandNumber;
+
+		sentIndex = enet_protocol_sent_reliable_index(peer, channelID);
+
+		if (sentIndex == NULL)
+			return ENET_PROTOCOL_COMMAND_NONE;
+
+		outgoingCommand = (ENetOutgoingCommand*)enet_sequence_ring_find(sentIndex, reliableSequenceNumber);
+
+		if (outgoingCommand == NULL)
+			return ENET_PROTOCOL_COMMAND_NONE;
+
+		if (outgoingCommand->inTransit && peer->selectiveAcknowledge)
+			enet_protocol_note_later_acknowledgement(peer, &outgoingCommand->outgoingCommandList);
+
+		if (outgoingCommand->packet != NULL)
+			peer->congestionDataAcknowledged += outgoingCommand->fragmentLength;
+
+		if (peer->mtuBlackHoleLosses > 0 && outgoingCommand->datagramSize >= peer->mtuLossSize)
+			peer->mtuBlackHoleLosses = 0;
+
+		commandNumber = enet_protocol_release_sent_reliable_command(peer, outgoingCommand);
+
 		if (enet_list_empty(&peer->sentReliableCommands))
 			return commandNumber;
 
@@ -1738,31 +2531,134 @@ extern "C" {
 		return commandNumber;
 	}
 
+	/*
+		With discovery on, a peer sends at the minimum MTU until a probe of the negotiated size is echoed back.
+		The search then continues up to the host's maximum, which may lie above the negotiated size if the remote host discovers too.
+	*/
+	static void enet_protocol_start_mtu_discovery(ENetHost* host, ENetPeer* peer) {
+		uint32_t probeSize = ENET_MIN(peer->mtu, host->maximumMtu);
+
+		peer->mtuSearchLimit = host->maximumMtu + 1;
+		peer->mtuProbeSize = probeSize > ENET_PROTOCOL_MINIMUM_MTU ? probeSize : 0;
+		peer->mtuProbeAttempts = 0;
+		peer->mtu = ENET_PROTOCOL_MINIMUM_MTU;
+	}
+
+	/* The cookie for a connect binds its source address and the client's peer id to an interval of ENET_HOST_CONNECT_COOKIE_INTERVAL milliseconds. */
+	static uint32_t enet_protocol_connect_cookie(ENetHost* host, const ENetProtocol* command, uint32_t interval) {
+		uint8_t input[sizeof(struct in6_addr) + 2 * sizeof(uint16_t) + sizeof(uint32_t)];
+
+		memcpy(input, &host->receivedAddress.ipv6, sizeof(struct in6_addr));
+		memcpy(&input[sizeof(struct in6_addr)], &host->receivedAddress.port, sizeof(uint16_t));
+		memcpy(&input[sizeof(struct in6_addr) + sizeof(uint16_t)], &command->connect.outgoingPeerID, sizeof(uint16_t));
+		memcpy(&input[sizeof(struct in6_addr) + 2 * sizeof(uint16_t)], &interval, sizeof(uint32_t));
+
+		return (uint32_t)enet_siphash(host->connectCookieKey, input, sizeof(input));
+	}
+
+	/* A client that has been challenged connects again with the cookie as its connect id, which stays valid for one to two intervals. */
+	static int enet_protocol_check_connect_cookie(ENetHost* host, const ENetProtocol* command) {
+		uint32_t interval = host->serviceTime / ENET_HOST_CONNECT_COOKIE_INTERVAL;
+
+		return command->connect.connectID == enet_protocol_connect_cookie(host, command, interval) || command->connect.connectID == enet_protocol_connect_cookie(host, command, interval - 1);
+	}
+
+	/*
+		Answers a connect without a valid cookie with a verify that assigns no peer id and carries the cookie as its connect id.
+		Nothing is kept, and the answer is no larger than the connect, so spoofed connects neither fill peer slots nor gain amplification.
+		The window size echoes the client's connect id, so only a host that saw the connect can challenge it.
+	*/
+	static void enet_protocol_send_connect_cookie(ENetHost* host, const ENetProtocol* command) {
+		uint8_t headerData[sizeof(ENetProtocolHeader) + sizeof(uint8_t) + sizeof(enet_checksum)];
+		ENetProtocolHeader* header = (ENetProtocolHeader*)headerData;
+		ENetProtocol verifyCommand;
+		ENetBuffer buffers[2];
+		uint16_t outgoingPeerID = ENET_NET_TO_HOST_16(command->connect.outgoingPeerID);
+		uint16_t headerFlags = 0;
+
+		buffers[0].data = headerData;
+		buffers[0].dataLength = (size_t)&((ENetProtocolHeader*)0)->sentTime;
+
+		if (outgoingPeerID > ENET_PROTOCOL_MAXIMUM_PEER_ID) {
+			headerFlags |= ENET_PROTOCOL_HEADER_FLAG_EXTENDED_PEER_ID;
+			headerData[buffers[0].dataLength++] = (uint8_t)(outgoingPeerID >> 12);
+		}
+
+		header->peerID = ENET_HOST_TO_NET_16((outgoingPeerID & ENET_PROTOCOL_MAXIMUM_PEER_ID) | headerFlags);
+
+		verifyCommand.header.command = ENET_PROTOCOL_COMMAND_VERIFY_CONNECT;
+		verifyCommand.header.channelID = 0xFF;
+		verifyCommand.header.reliableSequenceNumber = 0;
+		verifyCommand.verifyConnect.outgoingPeerID = ENET_HOST_TO_NET_16(ENET_PROTOCOL_MAXIMUM_PEER_ID);
+		verifyCommand.verifyConnect.incomingSessionID = command->connect.incomingSessionID;
+		verifyCommand.verifyConnect.outgoingSessionID = command->connect.outgoingSessionID;
+		verifyCommand.verifyConnect.mtu = command->connect.mtu;
+		verifyCommand.verifyConnect.windowSize = command->connect.connectID;
+		verifyCommand.verifyConnect.channelCount = command->connect.channelCount;
+		verifyCommand.verifyConnect.incomingBandwidth = ENET_HOST_TO_NET_32(host->incomingBandwidth);
+		verifyCommand.verifyConnect.outgoingBandwidth = ENET_HOST_TO_NET_32(host->outgoingBandwidth);
+		verifyCommand.verifyConnect.packetThrottleInterval = command->connect.packetThrottleInterval;
+		verifyCommand.verifyConnect.packetThrottleAcceleration = command->connect.packetThrottleAcceleration;
+		verifyCommand.verifyConnect.packetThrottleDeceleration = command->connect.packetThrottleDeceleration;
+		verifyCommand.verifyConnect.connectID = enet_protocol_connect_cookie(host, command, host->serviceTime / ENET_HOST_CONNECT_COOKIE_INTERVAL);
+
+		buffers[1].data = &verifyCommand;
+		buffers[1].dataLength = sizeof(ENetProtocolVerifyConnect);
+
+		/* The client still checks the datagram against the connect id it sent. */
+		if (host->checksumCallback != NULL) {
+			enet_checksum* checksum = (enet_checksum*)&headerData[buffers[0].dataLength];
+			*checksum = command->connect.connectID;
+			buffers[0].dataLength += sizeof(enet_checksum);
+			*checksum = host->checksumCallback(buffers, 2);
+		}
+
+		enet_socket_send(host->socket, &host->receivedAddress, buffers, 2);
+	}
+
 	static ENetPeer* enet_protocol_handle_connect(ENetHost* host, ENetProtocolHeader* header, ENetProtocol* command) {
 		uint8_t incomingSessionID, outgoingSessionID;
 		uint32_t mtu, windowSize;
 		ENetChannel* channel;
 		size_t channelCount, duplicatePeers = 0;
-		ENetPeer* currentPeer, *peer = NULL;
+		ENetList* bucket;
+		ENetListIterator currentSlot;
+		ENetPeer* currentPeer, *peer;
 		ENetProtocol verifyCommand;
 		channelCount = ENET_NET_TO_HOST_32(command->connect.channelCount);
 
 		if (channelCount < ENET_PROTOCOL_MINIMUM_CHANNEL_COUNT || channelCount > ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT)
 			return NULL;
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
-			if (currentPeer->state == ENET_PEER_STATE_DISCONNECTED) {
-				if (peer == NULL)
-					peer = currentPeer;
-			} else if (currentPeer->state != ENET_PEER_STATE_CONNECTING && enet_in6_equal(currentPeer->address.ipv6, host->receivedAddress.ipv6)) {
-				if (currentPeer->address.port == host->receivedAddress.port && currentPeer->connectID == command->connect.connectID)
-					return NULL;
+		if (host->connectCookies && !enet_protocol_check_connect_cookie(host, command)) {
+			enet_protocol_send_connect_cookie(host, command);
 
-				++duplicatePeers;
-			}
+			return NULL;
+		}
+
+		/* Only peers sharing the sender's address bucket can be a retransmitted connect or count toward the duplicate limit. */
+		bucket = &host->addressBuckets[enet_host_address_hash(host, &host->receivedAddress) & host->addressBucketMask];
+
+		for (currentSlot = enet_list_begin(bucket); currentSlot != enet_list_end(bucket); currentSlot = enet_list_next(currentSlot)) {
+			currentPeer = enet_peer_from_slot_list(currentSlot);
+
+			if (currentPeer->state == ENET_PEER_STATE_CONNECTING || !enet_in6_equal(currentPeer->address.ipv6, host->receivedAddress.ipv6))
+				continue;
+
+			if (currentPeer->address.port == host->receivedAddress.port && currentPeer->connectID == command->connect.connectID)
+				return NULL;
+
+			if (++duplicatePeers >= host->duplicatePeers)
+				return NULL;
 		}
 
-		if (peer == NULL || duplicatePeers >= host->duplicatePeers)
+		if (host->duplicatePeers == 0)
+			return NULL;
+
+		/* Peers that did not announce extended peer ids cannot address a slot id above 0xFFF. */
+		peer = enet_host_acquire_peer_slot(host, command->header.command & ENET_PROTOCOL_COMMAND_FLAG_EXTENDED_PEER_ID);
+
+		if (peer == NULL)
 			return NULL;
 
 		if (channelCount > host->channelLimit)
@@ -1777,9 +2673,13 @@ extern "C" {
 		peer->state = ENET_PEER_STATE_ACKNOWLEDGING_CONNECT;
 		peer->connectID = command->connect.connectID;
 		peer->address = host->receivedAddress;
+
+		enet_host_index_peer(host, peer);
+
 		peer->outgoingPeerID = ENET_NET_TO_HOST_16(command->connect.outgoingPeerID);
 		peer->incomingBandwidth = ENET_NET_TO_HOST_32(command->connect.incomingBandwidth);
 		peer->outgoingBandwidth = ENET_NET_TO_HOST_32(command->connect.outgoingBandwidth);
+		peer->selectiveAcknowledge = host->selectiveAcknowledge && (command->header.command & ENET_PROTOCOL_COMMAND_FLAG_SELECTIVE_ACKNOWLEDGE);
 		peer->packetThrottleInterval = ENET_NET_TO_HOST_32(command->connect.packetThrottleInterval);
 		peer->packetThrottleAcceleration = ENET_NET_TO_HOST_32(command->connect.packetThrottleAcceleration);
 		peer->packetThrottleDeceleration = ENET_NET_TO_HOST_32(command->connect.packetThrottleDeceleration);
@@ -1804,11 +2704,17 @@ extern "C" {
 			channel->outgoingUnreliableSequenceNumber = 0;
 			channel->incomingReliableSequenceNumber = 0;
 			channel->incomingUnreliableSequenceNumber = 0;
+			channel->acknowledgedReliableSequenceNumber = 0;
 
 			enet_list_clear(&channel->incomingReliableCommands);
 			enet_list_clear(&channel->incomingUnreliableCommands);
+			enet_sequence_ring_init(&channel->incomingReliableIndex, offsetof(ENetIncomingCommand, reliableSequenceNumber));
+			enet_sequence_ring_init(&channel->sentReliableIndex, offsetof(ENetOutgoingCommand, reliableSequenceNumber));
 
 			channel->usedReliableWindows = 0;
+			channel->parity = 0;
+			channel->outgoingParity = NULL;
+			channel->incomingParity = NULL;
 
 			memset(channel->reliableWindows, 0, sizeof(channel->reliableWindows));
 		}
@@ -1848,6 +2754,10 @@ extern "C" {
 			windowSize = ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE;
 
 		verifyCommand.header.command = ENET_PROTOCOL_COMMAND_VERIFY_CONNECT | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE;
+
+		if (peer->selectiveAcknowledge)
+			verifyCommand.header.command |= ENET_PROTOCOL_COMMAND_FLAG_SELECTIVE_ACKNOWLEDGE;
+
 		verifyCommand.header.channelID = 0xFF;
 		verifyCommand.verifyConnect.outgoingPeerID = ENET_HOST_TO_NET_16(peer->incomingPeerID);
 		verifyCommand.verifyConnect.incomingSessionID = incomingSessionID;
@@ -1862,6 +2772,9 @@ extern "C" {
 		verifyCommand.verifyConnect.packetThrottleDeceleration = ENET_HOST_TO_NET_32(peer->packetThrottleDeceleration);
 		verifyCommand.verifyConnect.connectID = peer->connectID;
 
+		if (host->maximumMtu != 0)
+			enet_protocol_start_mtu_discovery(host, peer);
+
 		enet_peer_queue_outgoing_command(peer, &verifyCommand, NULL, 0, 0);
 
 		return peer;
@@ -1885,18 +2798,39 @@ extern "C" {
 		return 0;
 	}
 
-	static int enet_protocol_handle_send_unsequenced(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
-		uint32_t unsequencedGroup, index;
-		size_t dataLength;
+	/* Keeps a copy of an unreliable or unsequenced command received on a channel that carries parity. */
+	static void enet_protocol_record_parity_member(ENetChannel* channel, const ENetProtocol* command, uint16_t unreliableSequenceNumber, const uint8_t* data, size_t dataLength) {
+		ENetParityHistory* history = channel->incomingParity;
+		ENetParityRecord* record = &history->records[history->nextRecord];
 
-		if (command->header.channelID >= peer->channelCount || (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER))
-			return -1;
+		if (dataLength > ENET_PROTOCOL_MAXIMUM_MTU)
+			return;
 
-		dataLength = ENET_NET_TO_HOST_16(command->sendUnsequenced.dataLength);
-		*currentData += dataLength;
+		if (record->dataCapacity < dataLength) {
+			uint8_t* recordData = (uint8_t*)enet_malloc(dataLength);
 
-		if (dataLength > host->maximumPacketSize || *currentData < host->receivedData || *currentData > &host->receivedData[host->receivedDataLength])
-			return -1;
+			if (recordData == NULL)
+				return;
+
+			if (record->data != NULL)
+				enet_free(record->data);
+
+			record->data = recordData;
+			record->dataCapacity = dataLength;
+		}
+
+		record->command = command->header.command & ENET_PROTOCOL_COMMAND_MASK;
+		record->reliableSequenceNumber = command->header.reliableSequenceNumber;
+		record->unreliableSequenceNumber = unreliableSequenceNumber;
+		record->dataLength = dataLength;
+
+		memcpy(record->data, data, dataLength);
+
+		history->nextRecord = (history->nextRecord + 1) % ENET_PEER_PARITY_HISTORY;
+	}
+
+	static int enet_protocol_accept_unsequenced(ENetPeer* peer, const ENetProtocol* command, const uint8_t* data, size_t dataLength) {
+		uint32_t unsequencedGroup, index;
 
 		unsequencedGroup = ENET_NET_TO_HOST_16(command->sendUnsequenced.unsequencedGroup);
 		index = unsequencedGroup % ENET_PEER_UNSEQUENCED_WINDOW_SIZE;
@@ -1917,7 +2851,7 @@ extern "C" {
 			return 0;
 		}
 
-		if (enet_peer_queue_incoming_command(peer, command, (const uint8_t*)command + sizeof(ENetProtocolSendUnsequenced), dataLength, ENET_PACKET_FLAG_UNSEQUENCED, 0) == NULL)
+		if (enet_peer_queue_incoming_command(peer, command, data, dataLength, ENET_PACKET_FLAG_UNSEQUENCED, 0) == NULL)
 			return -1;
 
 		peer->unsequencedWindow[index / 32] |= 1 << (index % 32);
@@ -1925,6 +2859,24 @@ extern "C" {
 		return 0;
 	}
 
+	static int enet_protocol_handle_send_unsequenced(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
+		size_t dataLength;
+
+		if (command->header.channelID >= peer->channelCount || (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER))
+			return -1;
+
+		dataLength = ENET_NET_TO_HOST_16(command->sendUnsequenced.dataLength);
+		*currentData += dataLength;
+
+		if (dataLength > host->maximumPacketSize || *currentData < host->receivedData || *currentData > &host->receivedData[host->receivedDataLength])
+			return -1;
+
+		if (peer->channels[command->header.channelID].incomingParity != NULL)
+			enet_protocol_record_parity_member(&peer->channels[command->header.channelID], command, ENET_NET_TO_HOST_16(command->sendUnsequenced.unsequencedGroup), (const uint8_t*)command + sizeof(ENetProtocolSendUnsequenced), dataLength);
+
+		return enet_protocol_accept_unsequenced(peer, command, (const uint8_t*)command + sizeof(ENetProtocolSendUnsequenced), dataLength);
+	}
+
 	static int enet_protocol_handle_send_unreliable(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
 		size_t dataLength;
 
@@ -1937,17 +2889,142 @@ extern "C" {
 		if (dataLength > host->maximumPacketSize || *currentData < host->receivedData || *currentData > &host->receivedData[host->receivedDataLength])
 			return -1;
 
+		if (peer->channels[command->header.channelID].incomingParity != NULL)
+			enet_protocol_record_parity_member(&peer->channels[command->header.channelID], command, ENET_NET_TO_HOST_16(command->sendUnreliable.unreliableSequenceNumber), (const uint8_t*)command + sizeof(ENetProtocolSendUnreliable), dataLength);
+
 		if (enet_peer_queue_incoming_command(peer, command, (const uint8_t*)command + sizeof(ENetProtocolSendUnreliable), dataLength, 0, 0) == NULL)
 			return -1;
 
 		return 0;
 	}
 
+	/*
+		Rebuilds the one member of a parity group that never arrived and delivers it as if it had; with two or more missing, the group is lost.
+		The history of a channel starts with its first parity command, so the groups open by then can only be recorded, not repaired.
+	*/
+	static int enet_protocol_handle_send_parity(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
+		const ENetParityRecord* records[ENET_PEER_PARITY_MAXIMUM_GROUP];
+		const ENetProtocolParityMember* members;
+		const ENetProtocolParityMember* missingMember = NULL;
+		uint8_t repairedData[sizeof(ENetProtocol) + ENET_PROTOCOL_MAXIMUM_MTU];
+		ENetProtocol* repairedCommand = (ENetProtocol*)repairedData;
+		uint8_t* repairedPayload = repairedData + sizeof(ENetProtocol);
+		ENetParityHistory* history;
+		ENetChannel* channel;
+		size_t dataLength, membersLength, parityLength, member, record, offset;
+		uint16_t repairedLength;
+		uint8_t memberCount, memberCommand;
+
+		if (command->header.channelID >= peer->channelCount || (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER))
+			return -1;
+
+		dataLength = ENET_NET_TO_HOST_16(command->sendParity.dataLength);
+		*currentData += dataLength;
+
+		if (dataLength > host->maximumPacketSize || *currentData < host->receivedData || *currentData > &host->receivedData[host->receivedDataLength])
+			return -1;
+
+		memberCount = command->sendParity.memberCount;
+		memberCommand = command->sendParity.memberCommand;
+		membersLength = memberCount * sizeof(ENetProtocolParityMember);
+
+		if (memberCount < ENET_PEER_PARITY_MINIMUM_GROUP || memberCount > ENET_PEER_PARITY_MAXIMUM_GROUP || membersLength > dataLength || (memberCommand != ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE && memberCommand != ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED))
+			return -1;
+
+		parityLength = dataLength - membersLength;
+
+		if (parityLength > ENET_PROTOCOL_MAXIMUM_MTU)
+			return -1;
+
+		channel = &peer->channels[command->header.channelID];
+
+		if (channel->incomingParity == NULL) {
+			channel->incomingParity = (ENetParityHistory*)enet_malloc(sizeof(ENetParityHistory));
+
+			if (channel->incomingParity != NULL)
+				memset(channel->incomingParity, 0, sizeof(ENetParityHistory));
+
+			return 0;
+		}
+
+		history = channel->incomingParity;
+		members = (const ENetProtocolParityMember*)((const uint8_t*)command + sizeof(ENetProtocolSendParity));
+
+		for (member = 0; member < memberCount; ++member) {
+			records[member] = NULL;
+
+			for (record = 0; record < ENET_PEER_PARITY_HISTORY; ++record) {
+				const ENetParityRecord* currentRecord = &history->records[record];
+
+				if (currentRecord->command == memberCommand && currentRecord->reliableSequenceNumber == ENET_NET_TO_HOST_16(members[member].reliableSequenceNumber) && currentRecord->unreliableSequenceNumber == ENET_NET_TO_HOST_16(members[member].unreliableSequenceNumber)) {
+					records[member] = currentRecord;
+
+					break;
+				}
+			}
+
+			if (records[member] == NULL) {
+				if (missingMember != NULL)
+					return 0;
+
+				missingMember = &members[member];
+			} else if (records[member]->dataLength > parityLength) {
+				return 0;
+			}
+		}
+
+		if (missingMember == NULL)
+			return 0;
+
+		/* A sequenced channel that has delivered a later command would discard the rebuilt one anyway. */
+		if (memberCommand == ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE && ENET_NET_TO_HOST_16(missingMember->reliableSequenceNumber) == channel->incomingReliableSequenceNumber && ENET_NET_TO_HOST_16(missingMember->unreliableSequenceNumber) <= channel->incomingUnreliableSequenceNumber)
+			return 0;
+
+		memcpy(repairedPayload, (const uint8_t*)members + membersLength, parityLength);
+		repairedLength = ENET_NET_TO_HOST_16(command->sendParity.lengthParity);
+
+		for (member = 0; member < memberCount; ++member) {
+			if (records[member] == NULL)
+				continue;
+
+			repairedLength ^= (uint16_t)records[member]->dataLength;
+
+			for (offset = 0; offset < records[member]->dataLength; ++offset) {
+				repairedPayload[offset] ^= records[member]->data[offset];
+			}
+		}
+
+		if (repairedLength > parityLength)
+			return 0;
+
+		repairedCommand->header.command = memberCommand;
+		repairedCommand->header.channelID = command->header.channelID;
+		repairedCommand->header.reliableSequenceNumber = ENET_NET_TO_HOST_16(missingMember->reliableSequenceNumber);
+
+		++peer->totalPacketsRepaired;
+
+		if (memberCommand == ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED) {
+			repairedCommand->header.command |= ENET_PROTOCOL_COMMAND_FLAG_UNSEQUENCED;
+			repairedCommand->sendUnsequenced.unsequencedGroup = missingMember->unreliableSequenceNumber;
+			repairedCommand->sendUnsequenced.dataLength = ENET_HOST_TO_NET_16(repairedLength);
+
+			return enet_protocol_accept_unsequenced(peer, repairedCommand, repairedPayload, repairedLength);
+		}
+
+		repairedCommand->sendUnreliable.unreliableSequenceNumber = missingMember->unreliableSequenceNumber;
+		repairedCommand->sendUnreliable.dataLength = ENET_HOST_TO_NET_16(repairedLength);
+
+		if (enet_peer_queue_incoming_command(peer, repairedCommand, repairedPayload, repairedLength, 0, 0) == NULL)
+			return -1;
+
+		return 0;
+	}
+
+
 	static int enet_protocol_handle_send_fragment(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
 		uint32_t fragmentNumber, fragmentCount, fragmentOffset, fragmentLength, startSequenceNumber, totalLength;
 		ENetChannel* channel;
 		uint16_t startWindow, currentWindow;
-		ENetListIterator currentCommand;
 		ENetIncomingCommand* startCommand = NULL;
 
 		if (command->header.channelID >= peer->channelCount || (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER))
@@ -1978,28 +3055,10 @@ extern "C" {
 		if (fragmentCount > ENET_PROTOCOL_MAXIMUM_FRAGMENT_COUNT || fragmentNumber >= fragmentCount || totalLength > host->maximumPacketSize || fragmentOffset >= totalLength || fragmentLength > totalLength - fragmentOffset)
 			return -1;
 
-		for (currentCommand = enet_list_previous(enet_list_end(&channel->incomingReliableCommands)); currentCommand != enet_list_end(&channel->incomingReliableCommands); currentCommand = enet_list_previous(currentCommand)) {
-			ENetIncomingCommand* incomingCommand = (ENetIncomingCommand*)currentCommand;
-
-			if (startSequenceNumber >= channel->incomingReliableSequenceNumber) {
-				if (incomingCommand->reliableSequenceNumber < channel->incomingReliableSequenceNumber)
-					continue;
-			} else if (incomingCommand->reliableSequenceNumber >= channel->incomingReliableSequenceNumber) {
-				break;
-			}
-
-			if (incomingCommand->reliableSequenceNumber <= startSequenceNumber) {
-				if (incomingCommand->reliableSequenceNumber < startSequenceNumber)
-					break;
-
-				if ((incomingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK) != ENET_PROTOCOL_COMMAND_SEND_FRAGMENT || totalLength != incomingCommand->packet->dataLength || fragmentCount != incomingCommand->fragmentCount)
-					return -1;
-
-				startCommand = incomingCommand;
+		startCommand = (ENetIncomingCommand*)enet_sequence_ring_find(&channel->incomingReliableIndex, (uint16_t)startSequenceNumber);
 
-				break;
-			}
-		}
+		if (startCommand != NULL && ((startCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK) != ENET_PROTOCOL_COMMAND_SEND_FRAGMENT || totalLength != startCommand->packet->dataLength || fragmentCount != startCommand->fragmentCount))
+			return -1;
 
 		if (startCommand == NULL) {
 			ENetProtocol hostCommand = *command;
@@ -2124,6 +3183,48 @@ extern "C" {
 		return 0;
 	}
 
+	/* A probe is echoed only if it arrived whole; the echo confirms the probed size to the peer that sent it. */
+	static int enet_protocol_handle_probe_mtu(ENetHost* host, ENetPeer* peer, const ENetProtocol* command, uint8_t** currentData) {
+		size_t dataLength;
+		uint16_t probeSize;
+		ENetProtocol echoCommand;
+
+		dataLength = ENET_NET_TO_HOST_16(command->probeMtu.dataLength);
+		*currentData += dataLength;
+
+		if (*currentData < host->receivedData || *currentData > &host->receivedData[host->receivedDataLength])
+			return -1;
+
+		if (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER)
+			return 0;
+
+		probeSize = ENET_NET_TO_HOST_16(command->probeMtu.probeSize);
+
+		if (dataLength > 0) {
+			if (host->receivedDataLength < probeSize)
+				return 0;
+
+			echoCommand.header.command = ENET_PROTOCOL_COMMAND_PROBE_MTU;
+			echoCommand.header.channelID = 0xFF;
+			echoCommand.probeMtu.probeSize = command->probeMtu.probeSize;
+			echoCommand.probeMtu.dataLength = 0;
+
+			enet_peer_queue_outgoing_command(peer, &echoCommand, NULL, 0, 0);
+
+			return 0;
+		}
+
+		if (probeSize == peer->mtuProbeSize && peer->mtuProbeAttempts > 0) {
+			peer->mtu = probeSize;
+			peer->mtuProbeSize = 0;
+			peer->mtuProbeAttempts = 0;
+
+			enet_peer_mark_active(peer);
+		}
+
+		return 0;
+	}
+
 	static int enet_protocol_handle_bandwidth_limit(ENetHost* host, ENetPeer* peer, const ENetProtocol* command) {
 		if (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER)
 			return -1;
@@ -2189,7 +3290,7 @@ extern "C" {
 	}
 
 	static int enet_protocol_handle_acknowledge(ENetHost* host, ENetEvent* event, ENetPeer* peer, const ENetProtocol* command) {
-		uint32_t roundTripTime, receivedSentTime, receivedReliableSequenceNumber;
+		uint32_t roundTripTime, receivedSentTime, receivedReliableSequenceNumber, acknowledgementDelay;
 		ENetProtocolCommand commandNumber;
 
 		if (peer->state == ENET_PEER_STATE_DISCONNECTED || peer->state == ENET_PEER_STATE_ZOMBIE)
@@ -2206,10 +3307,24 @@ extern "C" {
 
 		roundTripTime = ENET_TIME_DIFFERENCE(host->serviceTime, receivedSentTime);
 
+		/* A peer using selective acknowledgement reports how long it held the acknowledgement in place of the repeated sequence number. */
+		if (peer->selectiveAcknowledge) {
+			acknowledgementDelay = command->header.reliableSequenceNumber;
+			roundTripTime = acknowledgementDelay < roundTripTime ? roundTripTime - acknowledgementDelay : 0;
+
+			if (acknowledgementDelay >= peer->remoteAcknowledgementDelay)
+				peer->remoteAcknowledgementDelay = acknowledgementDelay;
+			else
+				peer->remoteAcknowledgementDelay -= (peer->remoteAcknowledgementDelay - acknowledgementDelay) / 8;
+		}
+
 		if (roundTripTime == 0)
 			roundTripTime = 1;
 
-		enet_peer_throttle(peer, roundTripTime);
+		if (host->congestionControl == ENET_CONGESTION_CONTROL_DELAY)
+			enet_peer_delay_control(peer, roundTripTime);
+		else
+			enet_peer_throttle(peer, roundTripTime);
 
 		if (peer->lastReceiveTime > 0) {
 			if (roundTripTime >= peer->roundTripTime) {
@@ -2255,6 +3370,9 @@ extern "C" {
 		receivedReliableSequenceNumber = ENET_NET_TO_HOST_16(command->acknowledge.receivedReliableSequenceNumber);
 		commandNumber = enet_protocol_remove_sent_reliable_command(peer, receivedReliableSequenceNumber, command->header.channelID);
 
+		/* The retransmission deadline the peer was scheduled on has moved. */
+		enet_peer_mark_active(peer);
+
 		switch (peer->state) {
 			case ENET_PEER_STATE_ACKNOWLEDGING_CONNECT:
 				if (commandNumber != ENET_PROTOCOL_COMMAND_VERIFY_CONNECT)
@@ -2285,29 +3403,209 @@ extern "C" {
 		return 0;
 	}
 
-	static int enet_protocol_handle_verify_connect(ENetHost* host, ENetEvent* event, ENetPeer* peer, const ENetProtocol* command) {
-		uint32_t mtu, windowSize;
-		size_t channelCount;
+	/*
+		Looks up every sequence number in [startSequenceNumber, endSequenceNumber] that is still indexed, releasing the commands already queued for retransmission.
+		Returns how many of the covered commands are in transit; spans wider than the index walk its slots instead.
+	*/
+	static size_t enet_protocol_scan_selective_acknowledge(ENetPeer* peer, ENetSequenceRing* sentIndex, uint16_t startSequenceNumber, uint16_t endSequenceNumber, size_t* released) {
+		ENetOutgoingCommand* outgoingCommand;
+		uint32_t span, index;
+		size_t inTransit = 0;
 
-		if (peer->state != ENET_PEER_STATE_CONNECTING)
+		span = (uint16_t)(endSequenceNumber - startSequenceNumber);
+
+		if (span >= 0x8000)
 			return 0;
 
-		channelCount = ENET_NET_TO_HOST_32(command->verifyConnect.channelCount);
+		for (index = 0; index <= span && index < sentIndex->capacity; ++index) {
+			if (span < sentIndex->capacity) {
+				outgoingCommand = (ENetOutgoingCommand*)enet_sequence_ring_find(sentIndex, (uint16_t)(startSequenceNumber + index));
+			} else {
+				outgoingCommand = (ENetOutgoingCommand*)sentIndex->entries[index];
 
-		if (channelCount < ENET_PROTOCOL_MINIMUM_CHANNEL_COUNT || channelCount > ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleInterval) != peer->packetThrottleInterval || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleAcceleration) != peer->packetThrottleAcceleration || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleDeceleration) != peer->packetThrottleDeceleration || command->verifyConnect.connectID != peer->connectID) {
-			peer->eventData = 0;
+				if (outgoingCommand != NULL && !enet_protocol_sequence_in_range(outgoingCommand->reliableSequenceNumber, startSequenceNumber, endSequenceNumber))
+					outgoingCommand = NULL;
+			}
 
-			enet_protocol_dispatch_state(host, peer, ENET_PEER_STATE_ZOMBIE);
+			if (outgoingCommand == NULL)
+				continue;
 
-			return -1;
+			if (outgoingCommand->inTransit) {
+				++inTransit;
+			} else {
+				enet_protocol_release_sent_reliable_command(peer, outgoingCommand);
+
+				++*released;
+			}
 		}
 
-		enet_protocol_remove_sent_reliable_command(peer, 1, 0xFF);
+		return inTransit;
+	}
+
+	/*
+		Removes every sent command the receiver reports as delivered. Nothing is sampled for the round trip time, since the report carries no send time.
+		The covered commands are found through the channel index; the sent list is then walked only up to the last delivered one, and each command still outstanding on the way counts the delivered ones sent after it toward fast retransmit.
+	*/
+	static int enet_protocol_handle_selective_acknowledge(ENetPeer* peer, const ENetProtocol* command) {
+		ENetOutgoingCommand* outgoingCommand;
+		ENetListIterator currentCommand, insertPosition;
+		ENetChannel* channel;
+		uint16_t receivedReliableSequenceNumber;
+		size_t rangeCount, rangeIndex, remaining = 0, released = 0;
+		int delivered;
+
+		if (peer->state == ENET_PEER_STATE_DISCONNECTED || peer->state == ENET_PEER_STATE_ZOMBIE)
+			return 0;
+
+		if (!peer->selectiveAcknowledge || command->header.channelID >= peer->channelCount)
+			return -1;
+
+		channel = &peer->channels[command->header.channelID];
+		receivedReliableSequenceNumber = ENET_NET_TO_HOST_16(command->selectiveAcknowledge.receivedReliableSequenceNumber);
+		rangeCount = ENET_MIN(ENET_NET_TO_HOST_16(command->selectiveAcknowledge.rangeCount), ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES);
+
+		if ((uint16_t)(receivedReliableSequenceNumber - channel->acknowledgedReliableSequenceNumber) < 0x8000) {
+			if (receivedReliableSequenceNumber != channel->acknowledgedReliableSequenceNumber)
+				remaining += enet_protocol_scan_selective_acknowledge(peer, &channel->sentReliableIndex, (uint16_t)(channel->acknowledgedReliableSequenceNumber + 1), receivedReliableSequenceNumber, &released);
+
+			channel->acknowledgedReliableSequenceNumber = receivedReliableSequenceNumber;
+		}
+
+		for (rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex) {
+			remaining += enet_protocol_scan_selective_acknowledge(peer, &channel->sentReliableIndex, ENET_NET_TO_HOST_16(command->selectiveAcknowledge.ranges[rangeIndex].startSequenceNumber), ENET_NET_TO_HOST_16(command->selectiveAcknowledge.ranges[rangeIndex].endSequenceNumber), &released);
+		}
+
+		currentCommand = enet_list_begin(&peer->sentReliableCommands);
+		insertPosition = enet_list_begin(&peer->outgoingCommands);
+
+		while (remaining > 0 && currentCommand != enet_list_end(&peer->sentReliableCommands)) {
+			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+			currentCommand = enet_list_next(currentCommand);
+			delivered = 0;
+
+			if (outgoingCommand->command.header.channelID == command->header.channelID) {
+				delivered = enet_protocol_sequence_in_range(outgoingCommand->reliableSequenceNumber, (uint16_t)(receivedReliableSequenceNumber - 0x7FFF), receivedReliableSequenceNumber);
+
+				for (rangeIndex = 0; !delivered && rangeIndex < rangeCount; ++rangeIndex) {
+					delivered = enet_protocol_sequence_in_range(outgoingCommand->reliableSequenceNumber, ENET_NET_TO_HOST_16(command->selectiveAcknowledge.ranges[rangeIndex].startSequenceNumber), ENET_NET_TO_HOST_16(command->selectiveAcknowledge.ranges[rangeIndex].endSequenceNumber));
+				}
+			}
+
+			if (delivered) {
+				enet_protocol_release_sent_reliable_command(peer, outgoingCommand);
+
+				--remaining;
+				++released;
+
+				continue;
+			}
+
+			enet_protocol_count_later_acknowledgements(peer, outgoingCommand, remaining, insertPosition);
+		}
+
+		if (released == 0)
+			return 0;
+
+		peer->earliestTimeout = 0;
+
+		if (!enet_list_empty(&peer->sentReliableCommands)) {
+			outgoingCommand = (ENetOutgoingCommand*)enet_list_front(&peer->sentReliableCommands);
+			peer->nextTimeout = outgoingCommand->sentTime + outgoingCommand->roundTripTimeout;
+		}
+
+		enet_peer_mark_active(peer);
+
+		if (peer->state == ENET_PEER_STATE_DISCONNECT_LATER && enet_list_empty(&peer->outgoingCommands) && enet_list_empty(&peer->sentReliableCommands))
+			enet_peer_disconnect(peer, peer->eventData);
+
+		return 0;
+	}
+
+	/* A connect challenged by the remote host is sent again at once, with the cookie as its connect id. */
+	static void enet_protocol_handle_connect_cookie(ENetPeer* peer, const ENetProtocol* command) {
+		ENetOutgoingCommand* outgoingCommand;
+		ENetListIterator currentCommand;
+
+		peer->connectID = command->verifyConnect.connectID;
+		peer->connectChallenged = 1;
+
+		for (currentCommand = enet_list_begin(&peer->outgoingCommands); currentCommand != enet_list_end(&peer->outgoingCommands); currentCommand = enet_list_next(currentCommand)) {
+			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+
+			if ((outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_CONNECT)
+				outgoingCommand->command.connect.connectID = peer->connectID;
+		}
+
+		for (currentCommand = enet_list_begin(&peer->sentReliableCommands); currentCommand != enet_list_end(&peer->sentReliableCommands); currentCommand = enet_list_next(currentCommand)) {
+			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+
+			if ((outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK) != ENET_PROTOCOL_COMMAND_CONNECT)
+				continue;
+
+			outgoingCommand->command.connect.connectID = peer->connectID;
+			outgoingCommand->laterAcknowledgements = 0;
+			outgoingCommand->inTransit = 0;
+
+			enet_list_insert(enet_list_begin(&peer->outgoingCommands), enet_list_remove(&outgoingCommand->outgoingCommandList));
+			enet_peer_mark_active(peer);
+
+			break;
+		}
+	}
+
+	static int enet_protocol_handle_verify_connect(ENetHost* host, ENetEvent* event, ENetPeer* peer, const ENetProtocol* command) {
+		ENetOutgoingCommand* connectCommand;
+		uint32_t mtu, windowSize, roundTripTime;
+		size_t channelCount;
+
+		if (peer->state != ENET_PEER_STATE_CONNECTING)
+			return 0;
+
+		/*
+			A challenge must echo the connect id it answers, and each connect attempt takes at most one.
+			Any other is dropped rather than failing the connect, since whoever sent it need not be the remote host.
+		*/
+		if (ENET_NET_TO_HOST_16(command->verifyConnect.outgoingPeerID) == ENET_PROTOCOL_MAXIMUM_PEER_ID) {
+			if (!peer->connectChallenged && command->verifyConnect.windowSize == peer->connectID)
+				enet_protocol_handle_connect_cookie(peer, command);
+
+			return 0;
+		}
+
+		channelCount = ENET_NET_TO_HOST_32(command->verifyConnect.channelCount);
+
+		if (channelCount < ENET_PROTOCOL_MINIMUM_CHANNEL_COUNT || channelCount > ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleInterval) != peer->packetThrottleInterval || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleAcceleration) != peer->packetThrottleAcceleration || ENET_NET_TO_HOST_32(command->verifyConnect.packetThrottleDeceleration) != peer->packetThrottleDeceleration || command->verifyConnect.connectID != peer->connectID) {
+			peer->eventData = 0;
+
+			enet_protocol_dispatch_state(host, peer, ENET_PEER_STATE_ZOMBIE);
+
+			return -1;
+		}
+
+		/*
+			The connect is answered rather than acknowledged, so without this the first data would go out on the default round trip time.
+			A retransmitted connect may be answered for any earlier send, and those all lie within its doubled timeout before the last one.
+			The first acknowledgement replaces the estimate either way.
+		*/
+		connectCommand = (ENetOutgoingCommand*)enet_sequence_ring_find(&peer->sentSystemIndex, 1);
+
+		if (connectCommand != NULL) {
+			roundTripTime = ENET_TIME_DIFFERENCE(host->serviceTime, connectCommand->sentTime);
+
+			if (connectCommand->sendAttempts > 1)
+				roundTripTime += connectCommand->roundTripTimeout;
+
+			peer->roundTripTime = ENET_MAX(roundTripTime, 1);
+			peer->roundTripTimeVariance = peer->roundTripTime / 2;
+		}
+
+		enet_protocol_remove_sent_reliable_command(peer, 1, 0xFF);
 
 		if (channelCount < peer->channelCount)
 			peer->channelCount = channelCount;
 
 		peer->outgoingPeerID = ENET_NET_TO_HOST_16(command->verifyConnect.outgoingPeerID);
+		peer->selectiveAcknowledge = host->selectiveAcknowledge && (command->header.command & ENET_PROTOCOL_COMMAND_FLAG_SELECTIVE_ACKNOWLEDGE);
 		peer->incomingSessionID = command->verifyConnect.incomingSessionID;
 		peer->outgoingSessionID = command->verifyConnect.outgoingSessionID;
 		mtu = ENET_NET_TO_HOST_32(command->verifyConnect.mtu);
@@ -2320,6 +3618,9 @@ extern "C" {
 		if (mtu < peer->mtu)
 			peer->mtu = mtu;
 
+		if (host->maximumMtu != 0)
+			enet_protocol_start_mtu_discovery(host, peer);
+
 		windowSize = ENET_NET_TO_HOST_32(command->verifyConnect.windowSize);
 
 		if (windowSize < ENET_PROTOCOL_MINIMUM_WINDOW_SIZE)
@@ -2345,7 +3646,7 @@ extern "C" {
 		ENetPeer* peer;
 		uint8_t* currentData;
 		size_t headerSize;
-		uint16_t peerID, flags;
+		uint16_t peerID, flags, expectedSequenceNumber;
 		uint8_t sessionID;
 
 		if (host->receivedDataLength < (size_t)&((ENetProtocolHeader*)0)->sentTime)
@@ -2358,17 +3659,26 @@ extern "C" {
 		peerID &= ~(ENET_PROTOCOL_HEADER_FLAG_MASK | ENET_PROTOCOL_HEADER_SESSION_MASK);
 		headerSize = (flags & ENET_PROTOCOL_HEADER_FLAG_SENT_TIME ? sizeof(ENetProtocolHeader) : (size_t)&((ENetProtocolHeader*)0)->sentTime);
 
+		/* Peer ids above 0xFFF carry their high bits in one byte after the base header. */
+		if (flags & ENET_PROTOCOL_HEADER_FLAG_EXTENDED_PEER_ID) {
+			if (host->receivedDataLength <= headerSize)
+				return 0;
+
+			peerID |= (uint16_t)host->receivedData[headerSize] << 12;
+			++headerSize;
+		}
+
 		if (host->checksumCallback != NULL)
 			headerSize += sizeof(enet_checksum);
 
 		if (peerID == ENET_PROTOCOL_MAXIMUM_PEER_ID) {
 			peer = NULL;
-		} else if (peerID >= host->peerCount) {
+		} else if (enet_peer_index_from_id(peerID) >= host->peerSlotCount) {
 			return 0;
 		} else {
-			peer = &host->peers[peerID];
+			peer = &host->peers[enet_peer_index_from_id(peerID)];
 
-			if (peer->state == ENET_PEER_STATE_DISCONNECTED || peer->state == ENET_PEER_STATE_ZOMBIE || ((!enet_in6_equal(host->receivedAddress.ipv6, peer->address.ipv6) || host->receivedAddress.port != peer->address.port) && peer->address.ipv4.ip.s_addr != INADDR_BROADCAST) || (peer->outgoingPeerID < ENET_PROTOCOL_MAXIMUM_PEER_ID && sessionID != peer->incomingSessionID))
+			if (peer->state == ENET_PEER_STATE_DISCONNECTED || peer->state == ENET_PEER_STATE_ZOMBIE || ((!enet_in6_equal(host->receivedAddress.ipv6, peer->address.ipv6) || host->receivedAddress.port != peer->address.port) && peer->address.ipv4.ip.s_addr != INADDR_BROADCAST) || (peer->outgoingPeerID != ENET_PROTOCOL_MAXIMUM_PEER_ID && sessionID != peer->incomingSessionID))
 				return 0;
 		}
 
@@ -2385,7 +3695,13 @@ extern "C" {
 		}
 
 		if (peer != NULL) {
-			peer->address.ipv6 = host->receivedAddress.ipv6;
+			/* Only a peer connected through a broadcast address can change address here. */
+			if (!enet_in6_equal(peer->address.ipv6, host->receivedAddress.ipv6)) {
+				peer->address.ipv6 = host->receivedAddress.ipv6;
+
+				enet_host_index_peer(host, peer);
+			}
+
 			peer->address.port = host->receivedAddress.port;
 			peer->incomingDataTotal += host->receivedDataLength;
 			peer->totalDataReceived += host->receivedDataLength;
@@ -2417,6 +3733,7 @@ extern "C" {
 				break;
 
 			command->header.reliableSequenceNumber = ENET_NET_TO_HOST_16(command->header.reliableSequenceNumber);
+			expectedSequenceNumber = peer != NULL && command->header.channelID < peer->channelCount ? peer->channels[command->header.channelID].incomingReliableSequenceNumber + 1 : 0;
 
 			switch (commandNumber) {
 				case ENET_PROTOCOL_COMMAND_ACKNOWLEDGE:
@@ -2480,6 +3797,18 @@ extern "C" {
 
 					break;
 
+				case ENET_PROTOCOL_COMMAND_SEND_PARITY:
+					if (enet_protocol_handle_send_parity(host, peer, command, &currentData))
+						goto commandError;
+
+					break;
+
+				case ENET_PROTOCOL_COMMAND_PROBE_MTU:
+					if (enet_protocol_handle_probe_mtu(host, peer, command, &currentData))
+						goto commandError;
+
+					break;
+
 				case ENET_PROTOCOL_COMMAND_BANDWIDTH_LIMIT:
 					if (enet_protocol_handle_bandwidth_limit(host, peer, command))
 						goto commandError;
@@ -2498,6 +3827,12 @@ extern "C" {
 
 					break;
 
+				case ENET_PROTOCOL_COMMAND_SELECTIVE_ACKNOWLEDGE:
+					if (enet_protocol_handle_selective_acknowledge(peer, command))
+						goto commandError;
+
+					break;
+
 				default:
 					goto commandError;
 			}
@@ -2524,7 +3859,12 @@ extern "C" {
 						break;
 
 					default:
-						enet_peer_queue_acknowledgement(peer, command, sentTime);
+						/*
+							Connection control commands are acknowledged at once, as is a reliable command that is repeated or arrives past a gap:
+							the sender is then either waiting to connect, has timed out, or needs the gap reported to retransmit early.
+						*/
+						if (enet_peer_queue_acknowledgement(peer, command, sentTime) != NULL && (command->header.channelID >= peer->channelCount || command->header.reliableSequenceNumber != expectedSequenceNumber))
+							peer->acknowledgeImmediately = 1;
 
 						break;
 				}
@@ -2541,13 +3881,27 @@ extern "C" {
 
 	static int enet_protocol_receive_incoming_commands(ENetHost* host, ENetEvent* event) {
 		int packets;
+		/* With discovery on, probes larger than the host's own MTU must still arrive whole. */
+		uint32_t receiveLimit = ENET_MAX(host->mtu, host->maximumMtu);
 
-		for (packets = 0; packets < 256; ++packets) {
+		/* How long what is read now may have sat in the socket unread, since the host last read it or waited on it. */
+		host->receiveGap = host->receiveTime != 0 ? ENET_TIME_DIFFERENCE(host->serviceTime, host->receiveTime) : 0;
+		host->receiveTime = host->serviceTime;
+
+		for (packets = 0; host->receiveBudget == 0 || packets < (int)host->receiveBudget; ++packets) {
 			int receivedLength;
-			ENetBuffer buffer;
-			buffer.data = host->packetData[0];
-			buffer.dataLength = host->mtu;
-			receivedLength = enet_socket_receive(host->socket, &host->receivedAddress, &buffer, 1);
+
+			if (host->ioRing != NULL) {
+				receivedLength = enet_io_ring_receive(host->socket, host->ioRing, receiveLimit, &host->receivedAddress, &host->receivedData);
+			} else if (host->ioBatch != NULL) {
+				receivedLength = enet_io_batch_receive(host->socket, host->ioBatch, receiveLimit, &host->receivedAddress, &host->receivedData);
+			} else {
+				ENetBuffer buffer;
+				buffer.data = host->packetData[0];
+				buffer.dataLength = receiveLimit;
+				receivedLength = enet_socket_receive(host->socket, &host->receivedAddress, &buffer, 1);
+				host->receivedData = host->packetData[0];
+			}
 
 			if (receivedLength == -2)
 				continue;
@@ -2558,7 +3912,6 @@ extern "C" {
 			if (receivedLength == 0)
 				return 0;
 
-			host->receivedData = host->packetData[0];
 			host->receivedDataLength = receivedLength;
 			host->totalReceivedData += receivedLength;
 			host->totalReceivedPackets++;
@@ -2591,25 +3944,161 @@ extern "C" {
 			}
 		}
 
+		/* Datagrams still queued are picked up after this iteration's sends; the service wait does not sleep on any left in the batch. */
+		++host->budgetStats.receiveBudgetExhausted;
+
 		return 0;
 	}
 
+	/*
+		Reports the in-order point of a channel and up to ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES runs of commands held behind a gap.
+		Probes the channel index upward from the next expected sequence number until every held command has been seen or the ranges are full.
+	*/
+	static void enet_protocol_fill_selective_acknowledge(ENetChannel* channel, uint8_t channelID, ENetProtocol* command) {
+		ENetIncomingCommand* incomingCommand;
+		uint16_t sequenceNumber, endSequenceNumber = 0;
+		uint32_t probed = 0, seen = 0;
+		size_t rangeCount = 0;
+
+		sequenceNumber = (uint16_t)(channel->incomingReliableSequenceNumber + 1);
+
+		while (seen < channel->incomingReliableIndex.count && probed < channel->incomingReliableIndex.capacity) {
+			incomingCommand = (ENetIncomingCommand*)enet_sequence_ring_find(&channel->incomingReliableIndex, sequenceNumber);
+
+			if (incomingCommand == NULL) {
+				++sequenceNumber;
+				++probed;
+
+				continue;
+			}
+
+			++seen;
+
+			/* A partial fragment set only says that some of its sequence numbers arrived. */
+			if (incomingCommand->fragmentsRemaining == 0) {
+				if (rangeCount > 0 && sequenceNumber == (uint16_t)(endSequenceNumber + 1)) {
+					endSequenceNumber = sequenceNumber + (incomingCommand->fragmentCount > 0 ? incomingCommand->fragmentCount - 1 : 0);
+					command->selectiveAcknowledge.ranges[rangeCount - 1].endSequenceNumber = ENET_HOST_TO_NET_16(endSequenceNumber);
+				} else {
+					if (rangeCount >= ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES)
+						break;
+
+					endSequenceNumber = sequenceNumber + (incomingCommand->fragmentCount > 0 ? incomingCommand->fragmentCount - 1 : 0);
+					command->selectiveAcknowledge.ranges[rangeCount].startSequenceNumber = ENET_HOST_TO_NET_16(sequenceNumber);
+					command->selectiveAcknowledge.ranges[rangeCount].endSequenceNumber = ENET_HOST_TO_NET_16(endSequenceNumber);
+					++rangeCount;
+				}
+			}
+
+			sequenceNumber += incomingCommand->fragmentCount > 1 ? incomingCommand->fragmentCount : 1;
+			probed += incomingCommand->fragmentCount > 1 ? incomingCommand->fragmentCount : 1;
+		}
+
+		memset(&command->selectiveAcknowledge.ranges[rangeCount], 0, (ENET_PROTOCOL_MAXIMUM_ACKNOWLEDGE_RANGES - rangeCount) * sizeof(ENetProtocolAcknowledgeRange));
+
+		command->header.command = ENET_PROTOCOL_COMMAND_SELECTIVE_ACKNOWLEDGE;
+		command->header.channelID = channelID;
+		command->header.reliableSequenceNumber = ENET_HOST_TO_NET_16(channel->incomingReliableSequenceNumber);
+		command->selectiveAcknowledge.receivedReliableSequenceNumber = ENET_HOST_TO_NET_16(channel->incomingReliableSequenceNumber);
+		command->selectiveAcknowledge.rangeCount = ENET_HOST_TO_NET_16((uint16_t)rangeCount);
+	}
+
+	/*
+		Acknowledgements to a peer using selective acknowledgement wait for the host's delay or threshold; everything else goes out on the next send pass.
+		A held acknowledgement the sender is waiting on to recover or to connect, or one that did not fit in the datagram it was meant to ride, is not held further.
+	*/
+	static int enet_protocol_acknowledgements_due(ENetHost* host, ENetPeer* peer) {
+		ENetAcknowledgement* acknowledgement;
+
+		if (host->acknowledgementDelay == 0 || !peer->selectiveAcknowledge || peer->state != ENET_PEER_STATE_CONNECTED || peer->acknowledgeImmediately || peer->acknowledgementCount >= host->acknowledgementThreshold)
+			return 1;
+
+		acknowledgement = (ENetAcknowledgement*)enet_list_front(&peer->acknowledgements);
+
+		return ENET_TIME_DIFFERENCE(host->serviceTime, acknowledgement->receivedTime) >= host->acknowledgementDelay;
+	}
+
+	/* The channel state sent in a selective acknowledgement implies every acknowledgement at or below the channel's in-order point. */
+	static int enet_protocol_acknowledgement_covered(ENetPeer* peer, const ENetAcknowledgement* acknowledgement) {
+		uint8_t channelID = acknowledgement->command.header.channelID;
+
+		return peer->selectiveAcknowledge && channelID < peer->channelCount && (uint16_t)(peer->channels[channelID].incomingReliableSequenceNumber - acknowledgement->command.header.reliableSequenceNumber) < 0x8000;
+	}
+
+	/*
+		With selective acknowledgement, each channel with pending acknowledgements covered by its in-order point is reported first.
+		Of the covered acknowledgements only the oldest is still sent, to carry a round trip time sample and the longest hold time; the rest are dropped.
+	*/
 	static void enet_protocol_send_acknowledgements(ENetHost* host, ENetPeer* peer) {
 		ENetProtocol* command = &host->commands[host->commandCount];
 		ENetBuffer* buffer = &host->buffers[host->bufferCount];
 		ENetAcknowledgement* acknowledgement;
 		ENetListIterator currentAcknowledgement;
 		uint16_t reliableSequenceNumber;
+		uint32_t acknowledgedChannels[(ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT + 31) / 32];
+		uint32_t reportedChannels[(ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT + 31) / 32];
+		uint32_t sampledChannels[(ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT + 31) / 32];
+		size_t channelID;
+
+		memset(acknowledgedChannels, 0, sizeof(acknowledgedChannels));
+		memset(reportedChannels, 0, sizeof(reportedChannels));
+		memset(sampledChannels, 0, sizeof(sampledChannels));
+
+		if (peer->selectiveAcknowledge) {
+			for (currentAcknowledgement = enet_list_begin(&peer->acknowledgements); currentAcknowledgement != enet_list_end(&peer->acknowledgements); currentAcknowledgement = enet_list_next(currentAcknowledgement)) {
+				acknowledgement = (ENetAcknowledgement*)currentAcknowledgement;
+
+				if (enet_protocol_acknowledgement_covered(peer, acknowledgement))
+					acknowledgedChannels[acknowledgement->command.header.channelID / 32] |= 1u << (acknowledgement->command.header.channelID % 32);
+			}
+
+			for (channelID = 0; channelID < peer->channelCount; ++channelID) {
+				if (!(acknowledgedChannels[channelID / 32] & (1u << (channelID % 32))))
+					continue;
+
+				if (command >= &host->commands[sizeof(host->commands) / sizeof(ENetProtocol)] || buffer >= &host->buffers[sizeof(host->buffers) / sizeof(ENetBuffer)] || peer->mtu - host->packetSize < sizeof(ENetProtocolSelectiveAcknowledge))
+					break;
+
+				enet_protocol_fill_selective_acknowledge(&peer->channels[channelID], (uint8_t)channelID, command);
+
+				buffer->data = command;
+				buffer->dataLength = sizeof(ENetProtocolSelectiveAcknowledge);
+				host->packetSize += buffer->dataLength;
+				reportedChannels[channelID / 32] |= 1u << (channelID % 32);
+
+				++command;
+				++buffer;
+			}
+
+			memset(acknowledgedChannels, 0, sizeof(acknowledgedChannels));
+		}
+
 		currentAcknowledgement = enet_list_begin(&peer->acknowledgements);
 
 		while (currentAcknowledgement != enet_list_end(&peer->acknowledgements)) {
+			acknowledgement = (ENetAcknowledgement*)currentAcknowledgement;
+			channelID = acknowledgement->command.header.channelID;
+
+			if ((reportedChannels[channelID / 32] & (1u << (channelID % 32))) && enet_protocol_acknowledgement_covered(peer, acknowledgement)) {
+				if (sampledChannels[channelID / 32] & (1u << (channelID % 32))) {
+					currentAcknowledgement = enet_list_next(currentAcknowledgement);
+
+					enet_list_remove(&acknowledgement->acknowledgementList);
+					enet_free(acknowledgement);
+					--peer->acknowledgementCount;
+
+					continue;
+				}
+
+				sampledChannels[channelID / 32] |= 1u << (channelID % 32);
+			}
+
 			if (command >= &host->commands[sizeof(host->commands) / sizeof(ENetProtocol)] || buffer >= &host->buffers[sizeof(host->buffers) / sizeof(ENetBuffer)] || peer->mtu - host->packetSize < sizeof(ENetProtocolAcknowledge)) {
 				host->continueSending = 1;
 
 				break;
 			}
 
-			acknowledgement = (ENetAcknowledgement*)currentAcknowledgement;
 			currentAcknowledgement = enet_list_next(currentAcknowledgement);
 			buffer->data = command;
 			buffer->dataLength = sizeof(ENetProtocolAcknowledge);
@@ -2621,20 +4110,58 @@ extern "C" {
 			command->acknowledge.receivedReliableSequenceNumber = reliableSequenceNumber;
 			command->acknowledge.receivedSentTime = ENET_HOST_TO_NET_16(acknowledgement->sentTime);
 
+			if (peer->selectiveAcknowledge)
+				command->header.reliableSequenceNumber = ENET_HOST_TO_NET_16((uint16_t)ENET_MIN(ENET_TIME_DIFFERENCE(host->serviceTime, acknowledgement->receivedTime), 0xFFFF));
+
 			if ((acknowledgement->command.header.command & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_DISCONNECT)
 				enet_protocol_dispatch_state(host, peer, ENET_PEER_STATE_ZOMBIE);
 
+			if (acknowledgement->command.header.channelID < peer->channelCount)
+				acknowledgedChannels[acknowledgement->command.header.channelID / 32] |= 1u << (acknowledgement->command.header.channelID % 32);
+
 			enet_list_remove(&acknowledgement->acknowledgementList);
 			enet_free(acknowledgement);
+			--peer->acknowledgementCount;
 
 			++command;
 			++buffer;
 		}
 
+		/* Repeating the channel state with every batch of acknowledgements lets a later datagram cover acknowledgements that were lost. */
+		for (channelID = 0; peer->selectiveAcknowledge && channelID < peer->channelCount; ++channelID) {
+			if (!(acknowledgedChannels[channelID / 32] & (1u << (channelID % 32))) || (reportedChannels[channelID / 32] & (1u << (channelID % 32))))
+				continue;
+
+			if (command >= &host->commands[sizeof(host->commands) / sizeof(ENetProtocol)] || buffer >= &host->buffers[sizeof(host->buffers) / sizeof(ENetBuffer)] || peer->mtu - host->packetSize < sizeof(ENetProtocolSelectiveAcknowledge))
+				break;
+
+			enet_protocol_fill_selective_acknowledge(&peer->channels[channelID], (uint8_t)channelID, command);
+
+			buffer->data = command;
+			buffer->dataLength = sizeof(ENetProtocolSelectiveAcknowledge);
+			host->packetSize += buffer->dataLength;
+
+			++command;
+			++buffer;
+		}
+
+		if (enet_list_empty(&peer->acknowledgements))
+			peer->acknowledgeImmediately = 0;
+
 		host->commandCount = command - host->commands;
 		host->bufferCount = buffer - host->buffers;
 	}
 
+	/* Delay-based congestion control deliberately keeps up to its target delay queued, so the timeout allows for it rather than retransmitting into the queue. */
+	static uint32_t enet_protocol_round_trip_timeout(ENetHost* host, ENetPeer* peer) {
+		uint32_t roundTripTimeout = peer->roundTripTime + 4 * peer->roundTripTimeVariance + peer->remoteAcknowledgementDelay;
+
+		if (host->congestionControl == ENET_CONGESTION_CONTROL_DELAY)
+			roundTripTimeout += ENET_PEER_CONGESTION_TARGET_DELAY;
+
+		return roundTripTimeout;
+	}
+
 	static int enet_protocol_check_timeouts(ENetHost* host, ENetPeer* peer, ENetEvent* event) {
 		ENetOutgoingCommand* outgoingCommand;
 		ENetListIterator currentCommand, insertPosition;
@@ -2661,8 +4188,21 @@ extern "C" {
 				peer->reliableDataInTransit -= outgoingCommand->fragmentLength;
 
 			++peer->totalPacketsLost;
-			outgoingCommand->roundTripTimeout = peer->roundTripTime + 4 * peer->roundTripTimeVariance;
-			outgoingCommand->roundTripTimeoutLimit = peer->timeoutLimit * outgoingCommand->roundTripTimeout;
+			++peer->packetsLost;
+			outgoingCommand->laterAcknowledgements = 0;
+			outgoingCommand->inTransit = 0;
+			enet_protocol_note_mtu_loss(host, peer, outgoingCommand);
+
+			/*
+				A peer that has been silent for a whole timeout is treated as overloaded, typically a burst that overflowed a socket buffer, and its wait doubles.
+				Retransmitting each round trip would keep that buffer full. The doubling stays below the limit so disconnect timing is unchanged.
+			*/
+			if (ENET_TIME_DIFFERENCE(host->serviceTime, peer->lastReceiveTime) >= outgoingCommand->roundTripTimeout) {
+				outgoingCommand->roundTripTimeout = ENET_MIN(outgoingCommand->roundTripTimeout * 2, outgoingCommand->roundTripTimeoutLimit - 1);
+			} else {
+				outgoingCommand->roundTripTimeout = enet_protocol_round_trip_timeout(host, peer);
+				outgoingCommand->roundTripTimeoutLimit = peer->timeoutLimit * outgoingCommand->roundTripTimeout;
+			}
 
 			enet_list_insert(insertPosition, enet_list_remove(&outgoingCommand->outgoingCommandList));
 
@@ -2675,75 +4215,391 @@ extern "C" {
 		return 0;
 	}
 
-	static int enet_protocol_check_outgoing_commands(ENetHost* host, ENetPeer* peer) {
-		ENetProtocol* command = &host->commands[host->commandCount];
-		ENetBuffer* buffer = &host->buffers[host->bufferCount];
-		ENetOutgoingCommand* outgoingCommand;
-		ENetListIterator currentCommand;
-		ENetChannel* channel = NULL;
-		uint16_t reliableWindow = 0;
-		size_t commandSize = 0;
-		int windowExceeded = 0, windowWrap = 0, canPing = 1;
-		currentCommand = enet_list_begin(&peer->outgoingCommands);
+	/* Once per interval, folds the share of reliable transmissions lost into a smoothed loss rate, and under the throttle records the rate the peer was sent. */
+	static void enet_protocol_update_send_statistics(ENetHost* host, ENetPeer* peer) {
+		uint32_t packetLoss, elapsed;
 
-		while (currentCommand != enet_list_end(&peer->outgoingCommands)) {
-			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+		if (peer->packetLossEpoch == 0) {
+			peer->packetLossEpoch = host->serviceTime;
 
-			if (outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) {
-				channel = outgoingCommand->command.header.channelID < peer->channelCount ? &peer->channels[outgoingCommand->command.header.channelID] : NULL;
-				reliableWindow = outgoingCommand->reliableSequenceNumber / ENET_PEER_RELIABLE_WINDOW_SIZE;
+			return;
+		}
 
-				if (channel != NULL) {
-					if (!windowWrap && outgoingCommand->sendAttempts < 1 && !(outgoingCommand->reliableSequenceNumber % ENET_PEER_RELIABLE_WINDOW_SIZE) && (channel->reliableWindows[(reliableWindow + ENET_PEER_RELIABLE_WINDOWS - 1) % ENET_PEER_RELIABLE_WINDOWS] >= ENET_PEER_RELIABLE_WINDOW_SIZE || channel->usedReliableWindows & ((((1 << (ENET_PEER_FREE_RELIABLE_WINDOWS + 2)) - 1) << reliableWindow) | (((1 << (ENET_PEER_FREE_RELIABLE_WINDOWS + 2)) - 1) >> (ENET_PEER_RELIABLE_WINDOWS - reliableWindow)))))
-						windowWrap = 1;
+		elapsed = ENET_TIME_DIFFERENCE(host->serviceTime, peer->packetLossEpoch);
 
-					if (windowWrap) {
-						currentCommand = enet_list_next(currentCommand);
+		if (elapsed < ENET_PEER_PACKET_LOSS_INTERVAL)
+			return;
 
-						continue;
-					}
-				}
+		if (peer->packetsSent > 0) {
+			packetLoss = (uint32_t)((uint64_t)ENET_MIN(peer->packetsLost, peer->packetsSent) * ENET_PEER_PACKET_LOSS_SCALE / peer->packetsSent);
+			peer->packetLoss -= peer->packetLoss / 4;
+			peer->packetLoss += packetLoss / 4;
+			peer->packetsSent = 0;
+			peer->packetsLost = 0;
+		}
 
-				if (outgoingCommand->packet != NULL) {
-					if (!windowExceeded) {
-						uint32_t windowSize = (peer->packetThrottle * peer->windowSize) / ENET_PEER_PACKET_THROTTLE_SCALE;
+		if (host->congestionControl == ENET_CONGESTION_CONTROL_THROTTLE) {
+			peer->sendRate = (uint32_t)((uint64_t)peer->congestionDataSent * 1000 / elapsed);
+			peer->congestionDataSent = 0;
+		}
 
-						if (peer->reliableDataInTransit + outgoingCommand->fragmentLength > ENET_MAX(windowSize, peer->mtu))
-							windowExceeded = 1;
-					}
+		peer->packetLossEpoch = host->serviceTime;
+	}
 
-					if (windowExceeded) {
-						currentCommand = enet_list_next(currentCommand);
+	/* Under delay-based control a peer is sent data only while it has pacing credit, refilled at its send rate up to a burst of ENET_PEER_PACING_BURST milliseconds. */
+	static int enet_protocol_pacing_allows(ENetHost* host, ENetPeer* peer) {
+		uint32_t elapsed;
 
-						continue;
-					}
-				}
+		if (host->congestionControl != ENET_CONGESTION_CONTROL_DELAY)
+			return 1;
 
-				canPing = 0;
-			}
+		/* The rate measured under the throttle may be zero if the host switched controllers. */
+		if (peer->sendRate < ENET_PEER_MINIMUM_SEND_RATE)
+			peer->sendRate = ENET_PEER_MINIMUM_SEND_RATE;
 
-			commandSize = commandSizes[outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK];
+		elapsed = ENET_TIME_DIFFERENCE(host->serviceTime, peer->pacingTime);
 
-			if (command >= &host->commands[sizeof(host->commands) / sizeof(ENetProtocol)] || buffer + 1 >= &host->buffers[sizeof(host->buffers) / sizeof(ENetBuffer)] || peer->mtu - host->packetSize < commandSize || (outgoingCommand->packet != NULL && (uint16_t)(peer->mtu - host->packetSize) < (uint16_t)(commandSize + outgoingCommand->fragmentLength))) {
-				host->continueSending = 1;
+		if (elapsed > 0) {
+			int64_t burst = ENET_MAX(2 * (int64_t)peer->mtu, (int64_t)peer->sendRate * ENET_PEER_PACING_BURST / 1000);
+			int64_t pacingCredit = peer->pacingCredit + (int64_t)peer->sendRate * elapsed / 1000;
 
-				break;
-			}
+			peer->pacingCredit = (int32_t)ENET_MIN(pacingCredit, burst);
+			peer->pacingTime = host->serviceTime;
+		}
 
-			currentCommand = enet_list_next(currentCommand);
+		if (peer->pacingCredit <= 0) {
+			peer->congestionLimited = 1;
 
-			if (outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) {
-				if (channel != NULL && outgoingCommand->sendAttempts < 1) {
-					channel->usedReliableWindows |= 1 << reliableWindow;
-					++channel->reliableWindows[reliableWindow];
-				}
+			return 0;
+		}
 
-				++outgoingCommand->sendAttempts;
+		return 1;
+	}
 
-				if (outgoingCommand->roundTripTimeout == 0) {
-					outgoingCommand->roundTripTimeout = peer->roundTripTime + 4 * peer->roundTripTimeVariance;
-					outgoingCommand->roundTripTimeoutLimit = peer->timeoutLimit * outgoingCommand->roundTripTimeout;
-				}
+	/* Data held back by pacing needs a delay sample every round trip to raise the rate, which unreliable data alone never draws, so such a peer is pinged that often. */
+	static uint32_t enet_protocol_ping_interval(ENetHost* host, ENetPeer* peer) {
+		if (host->congestionControl == ENET_CONGESTION_CONTROL_DELAY && !enet_list_empty(&peer->outgoingCommands))
+			return ENET_MIN(peer->pingInterval, ENET_MAX(peer->roundTripTime, ENET_PEER_CONGESTION_MINIMUM_INTERVAL));
+
+		return peer->pingInterval;
+	}
+
+	static uint8_t enet_protocol_padding[ENET_PROTOCOL_MAXIMUM_MTU];
+
+	/*
+		Picks the size to probe next, or 0 if none is due; the search halves the range between the confirmed MTU and the smallest size known to fail.
+		A size that goes unanswered after ENET_PEER_MTU_PROBE_ATTEMPTS round trip timeouts fails, and a converged search starts over every ENET_PEER_MTU_RAISE_INTERVAL milliseconds in case the path has grown.
+	*/
+	static uint32_t enet_protocol_select_mtu_probe(ENetHost* host, ENetPeer* peer) {
+		if (host->maximumMtu == 0 || peer->state != ENET_PEER_STATE_CONNECTED || peer->mtuSearchLimit == 0)
+			return 0;
+
+		if (peer->mtuProbeSize != 0 && peer->mtuProbeAttempts > 0) {
+			if (ENET_TIME_DIFFERENCE(host->serviceTime, peer->mtuProbeTime) < enet_protocol_round_trip_timeout(host, peer))
+				return 0;
+
+			if (peer->mtuProbeAttempts < ENET_PEER_MTU_PROBE_ATTEMPTS)
+				return peer->mtuProbeSize;
+
+			peer->mtuSearchLimit = peer->mtuProbeSize;
+			peer->mtuProbeSize = 0;
+			peer->mtuProbeAttempts = 0;
+		}
+
+		if (peer->mtuProbeSize == 0) {
+			if (peer->mtuSearchLimit <= peer->mtu + ENET_PEER_MTU_PROBE_GRANULARITY) {
+				if (ENET_TIME_DIFFERENCE(host->serviceTime, peer->mtuProbeTime) < ENET_PEER_MTU_RAISE_INTERVAL)
+					return 0;
+
+				peer->mtuSearchLimit = host->maximumMtu + 1;
+				peer->mtuProbeTime = host->serviceTime;
+
+				if (peer->mtuSearchLimit <= peer->mtu + ENET_PEER_MTU_PROBE_GRANULARITY)
+					return 0;
+			}
+
+			peer->mtuProbeSize = (peer->mtu + peer->mtuSearchLimit) / 2;
+			peer->mtuProbeAttempts = 0;
+		}
+
+		return peer->mtuProbeSize;
+	}
+
+	/* A probe is padded to its full size and sent in a datagram of its own, so it waits for a pass in which nothing else is queued for the peer. */
+	static int enet_protocol_add_mtu_probe(ENetHost* host, ENetPeer* peer) {
+		ENetProtocol* command = &host->commands[host->commandCount];
+		ENetBuffer* buffer = &host->buffers[host->bufferCount];
+		uint32_t probeSize = enet_protocol_select_mtu_probe(host, peer);
+		size_t paddingLength;
+
+		if (probeSize == 0)
+			return 0;
+
+		if (host->commandCount > 0) {
+			host->continueSending = 1;
+
+			return 0;
+		}
+
+		/* The probe carries a sent time so the header is its full size. */
+		host->headerFlags |= ENET_PROTOCOL_HEADER_FLAG_SENT_TIME;
+		paddingLength = probeSize - host->packetSize - sizeof(ENetProtocolProbeMtu);
+
+		command->header.command = ENET_PROTOCOL_COMMAND_PROBE_MTU;
+		command->header.channelID = 0xFF;
+		command->header.reliableSequenceNumber = 0;
+		command->probeMtu.probeSize = ENET_HOST_TO_NET_16((uint16_t)probeSize);
+		command->probeMtu.dataLength = ENET_HOST_TO_NET_16((uint16_t)paddingLength);
+
+		buffer->data = command;
+		buffer->dataLength = sizeof(ENetProtocolProbeMtu);
+		++buffer;
+		buffer->data = enet_protocol_padding;
+		buffer->dataLength = paddingLength;
+
+		host->commandCount = 1;
+		host->bufferCount += 2;
+		host->packetSize = probeSize;
+		host->continueSending = 1;
+
+		++peer->mtuProbeAttempts;
+		peer->mtuProbeTime = host->serviceTime;
+
+		return 1;
+	}
+
+	/* A parity command repairs one loss per group, so groups are sized to expect a loss in about one of every ten. */
+	static uint8_t enet_protocol_parity_group_size(const ENetPeer* peer) {
+		uint32_t groupSize;
+
+		if (peer->packetLoss * ENET_PEER_PARITY_MAXIMUM_GROUP * 10 <= ENET_PEER_PACKET_LOSS_SCALE)
+			return ENET_PEER_PARITY_MAXIMUM_GROUP;
+
+		groupSize = ENET_PEER_PACKET_LOSS_SCALE / (peer->packetLoss * 10);
+
+		return (uint8_t)ENET_MAX(groupSize, ENET_PEER_PARITY_MINIMUM_GROUP);
+	}
+
+	/* Parity commands bypass the sequence numbers and throttle of the channel, since nothing is lost if one is dropped. */
+	static ENetOutgoingCommand* enet_protocol_create_parity_command(ENetHost* host, uint8_t channelID, const ENetParityGroup* group) {
+		size_t membersLength = group->memberCount * sizeof(ENetProtocolParityMember);
+		ENetOutgoingCommand* outgoingCommand = (ENetOutgoingCommand*)enet_malloc(sizeof(ENetOutgoingCommand));
+
+		if (outgoingCommand == NULL)
+			return NULL;
+
+		outgoingCommand->packet = enet_packet_create(NULL, membersLength + group->dataLength, ENET_PACKET_FLAG_UNTHROTTLED);
+
+		if (outgoingCommand->packet == NULL) {
+			enet_free(outgoingCommand);
+
+			return NULL;
+		}
+
+		memcpy(outgoingCommand->packet->data, group->members, membersLength);
+		memcpy(outgoingCommand->packet->data + membersLength, group->data, group->dataLength);
+
+		++outgoingCommand->packet->referenceCount;
+
+		outgoingCommand->reliableSequenceNumber = 0;
+		outgoingCommand->unreliableSequenceNumber = 0;
+		outgoingCommand->sentTime = host->serviceTime;
+		outgoingCommand->roundTripTimeout = 0;
+		outgoingCommand->roundTripTimeoutLimit = 0;
+		outgoingCommand->fragmentOffset = 0;
+		outgoingCommand->fragmentLength = (uint16_t)outgoingCommand->packet->dataLength;
+		outgoingCommand->sendAttempts = 0;
+		outgoingCommand->laterAcknowledgements = 0;
+		outgoingCommand->inTransit = 0;
+		outgoingCommand->command.header.command = ENET_PROTOCOL_COMMAND_SEND_PARITY;
+		outgoingCommand->command.header.channelID = channelID;
+		outgoingCommand->command.header.reliableSequenceNumber = 0;
+		outgoingCommand->command.sendParity.memberCommand = group->memberCommand;
+		outgoingCommand->command.sendParity.memberCount = group->memberCount;
+		outgoingCommand->command.sendParity.lengthParity = ENET_HOST_TO_NET_16(group->lengthParity);
+		outgoingCommand->command.sendParity.dataLength = ENET_HOST_TO_NET_16(outgoingCommand->fragmentLength);
+
+		return outgoingCommand;
+	}
+
+	/*
+		Adds an unreliable or unsequenced command being sent to a parity group of its channel, starting from the first group with each datagram.
+		Returns the parity command of a group this completes, or of one cut short because the next member would not fit in its datagram.
+	*/
+	static ENetOutgoingCommand* enet_protocol_add_parity_member(ENetHost* host, ENetPeer* peer, const ENetOutgoingCommand* outgoingCommand) {
+		ENetOutgoingCommand* parityCommand = NULL;
+		ENetParityGroups* groups;
+		ENetParityGroup* group;
+		ENetChannel* channel;
+		const uint8_t* data;
+		uint8_t channelID = outgoingCommand->command.header.channelID, memberCommand = outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK;
+		size_t dataLength = outgoingCommand->fragmentLength, parityLimit, offset;
+
+		if (!peer->selectiveAcknowledge || channelID >= peer->channelCount || !peer->channels[channelID].parity || (memberCommand != ENET_PROTOCOL_COMMAND_SEND_UNRELIABLE && memberCommand != ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED))
+			return NULL;
+
+		channel = &peer->channels[channelID];
+
+		if (channel->outgoingParity == NULL) {
+			channel->outgoingParity = (ENetParityGroups*)enet_malloc(sizeof(ENetParityGroups));
+
+			if (channel->outgoingParity == NULL)
+				return NULL;
+
+			memset(channel->outgoingParity, 0, sizeof(ENetParityGroups));
+		}
+
+		groups = channel->outgoingParity;
+
+		if (groups->datagram != host->totalSentPackets) {
+			groups->datagram = host->totalSentPackets;
+			groups->nextGroup = 0;
+		}
+
+		group = &groups->groups[groups->nextGroup];
+		groups->nextGroup = (groups->nextGroup + 1) % ENET_PEER_PARITY_INTERLEAVE;
+		parityLimit = ENET_MIN(peer->mtu, ENET_PROTOCOL_MAXIMUM_MTU) - sizeof(ENetProtocolHeader) - sizeof(uint8_t) - sizeof(enet_checksum) - sizeof(ENetProtocolSendParity);
+
+		if (group->memberCount > 0 && (group->memberCommand != memberCommand || (group->memberCount + 1) * sizeof(ENetProtocolParityMember) + ENET_MAX(group->dataLength, dataLength) > parityLimit)) {
+			if (group->memberCount >= ENET_PEER_PARITY_MINIMUM_GROUP)
+				parityCommand = enet_protocol_create_parity_command(host, channelID, group);
+
+			group->memberCount = 0;
+		}
+
+		if (sizeof(ENetProtocolParityMember) + dataLength > parityLimit)
+			return parityCommand;
+
+		if (group->memberCount == 0) {
+			group->memberCommand = memberCommand;
+			group->groupSize = enet_protocol_parity_group_size(peer);
+			group->dataLength = 0;
+			group->lengthParity = 0;
+		}
+
+		if (dataLength > group->dataLength) {
+			memset(&group->data[group->dataLength], 0, dataLength - group->dataLength);
+
+			group->dataLength = (uint16_t)dataLength;
+		}
+
+		data = outgoingCommand->packet->data;
+
+		for (offset = 0; offset < dataLength; ++offset) {
+			group->data[offset] ^= data[offset];
+		}
+
+		group->lengthParity ^= (uint16_t)dataLength;
+		group->members[group->memberCount].reliableSequenceNumber = outgoingCommand->command.header.reliableSequenceNumber;
+		group->members[group->memberCount].unreliableSequenceNumber = memberCommand == ENET_PROTOCOL_COMMAND_SEND_UNSEQUENCED ? outgoingCommand->command.sendUnsequenced.unsequencedGroup : outgoingCommand->command.sendUnreliable.unreliableSequenceNumber;
+
+		if (++group->memberCount >= group->groupSize && parityCommand == NULL) {
+			parityCommand = enet_protocol_create_parity_command(host, channelID, group);
+
+			group->memberCount = 0;
+		}
+
+		return parityCommand;
+	}
+
+	/*
+		Parity commands wait at the front of the queue for the next datagram the peer is sent anyway, up to ENET_PEER_PARITY_HOLD ms,
+		rather than costing a datagram of their own. On a sequenced channel the next datagram is also the last chance to repair,
+		since a message rebuilt after a later one was delivered is dropped. Returns whether the queue holds only parity still within its hold.
+	*/
+	static int enet_protocol_parity_held(ENetHost* host, ENetPeer* peer) {
+		ENetListIterator currentCommand;
+
+		for (currentCommand = enet_list_begin(&peer->outgoingCommands); currentCommand != enet_list_end(&peer->outgoingCommands); currentCommand = enet_list_next(currentCommand)) {
+			const ENetOutgoingCommand* outgoingCommand = (const ENetOutgoingCommand*)currentCommand;
+
+			if ((outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK) != ENET_PROTOCOL_COMMAND_SEND_PARITY || ENET_TIME_DIFFERENCE(host->serviceTime, outgoingCommand->sentTime) >= ENET_PEER_PARITY_HOLD)
+				return 0;
+		}
+
+		return 1;
+	}
+
+	static int enet_protocol_check_outgoing_commands(ENetHost* host, ENetPeer* peer) {
+		ENetProtocol* command = &host->commands[host->commandCount];
+		ENetBuffer* buffer = &host->buffers[host->bufferCount];
+		ENetOutgoingCommand* outgoingCommand;
+		ENetListIterator currentCommand;
+		ENetChannel* channel = NULL;
+		ENetList parityCommands;
+		uint16_t reliableWindow = 0;
+		size_t commandSize = 0;
+		int windowExceeded = 0, windowWrap = 0, canPing = 1;
+		currentCommand = enet_list_begin(&peer->outgoingCommands);
+		enet_list_clear(&parityCommands);
+
+		while (currentCommand != enet_list_end(&peer->outgoingCommands)) {
+			outgoingCommand = (ENetOutgoingCommand*)currentCommand;
+
+			if (outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) {
+				channel = outgoingCommand->command.header.channelID < peer->channelCount ? &peer->channels[outgoingCommand->command.header.channelID] : NULL;
+				reliableWindow = outgoingCommand->reliableSequenceNumber / ENET_PEER_RELIABLE_WINDOW_SIZE;
+
+				if (channel != NULL) {
+					if (!windowWrap && outgoingCommand->sendAttempts < 1 && !(outgoingCommand->reliableSequenceNumber % ENET_PEER_RELIABLE_WINDOW_SIZE) && (channel->reliableWindows[(reliableWindow + ENET_PEER_RELIABLE_WINDOWS - 1) % ENET_PEER_RELIABLE_WINDOWS] >= ENET_PEER_RELIABLE_WINDOW_SIZE || channel->usedReliableWindows & ((((1 << (ENET_PEER_FREE_RELIABLE_WINDOWS + 2)) - 1) << reliableWindow) | (((1 << (ENET_PEER_FREE_RELIABLE_WINDOWS + 2)) - 1) >> (ENET_PEER_RELIABLE_WINDOWS - reliableWindow)))))
+						windowWrap = 1;
+
+					if (windowWrap) {
+						currentCommand = enet_list_next(currentCommand);
+
+						continue;
+					}
+				}
+
+				if (outgoingCommand->packet != NULL) {
+					if (!windowExceeded) {
+						uint32_t windowSize = (peer->packetThrottle * peer->windowSize) / ENET_PEER_PACKET_THROTTLE_SCALE;
+
+						if (peer->reliableDataInTransit + outgoingCommand->fragmentLength > ENET_MAX(windowSize, peer->mtu))
+							windowExceeded = 1;
+					}
+
+					if (windowExceeded) {
+						currentCommand = enet_list_next(currentCommand);
+
+						continue;
+					}
+				}
+
+				canPing = 0;
+			}
+
+			commandSize = commandSizes[outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_MASK];
+
+			/* A fragment cut before a black hole lowered the MTU no longer fits any datagram, so it goes out alone rather than never. */
+			if (command >= &host->commands[sizeof(host->commands) / sizeof(ENetProtocol)] || buffer + 1 >= &host->buffers[sizeof(host->buffers) / sizeof(ENetBuffer)] || host->packetSize >= peer->mtu || peer->mtu - host->packetSize < commandSize || (outgoingCommand->packet != NULL && (uint16_t)(peer->mtu - host->packetSize) < (uint16_t)(commandSize + outgoingCommand->fragmentLength) && command > host->commands)) {
+				host->continueSending = 1;
+
+				break;
+			}
+
+			if ((outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) && outgoingCommand->sendAttempts < 1) {
+				ENetSequenceRing* sentIndex = enet_protocol_sent_reliable_index(peer, outgoingCommand->command.header.channelID);
+
+				if (sentIndex != NULL && enet_sequence_ring_insert(sentIndex, outgoingCommand->reliableSequenceNumber, outgoingCommand) < 0)
+					break;
+			}
+
+			currentCommand = enet_list_next(currentCommand);
+
+			if (outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE) {
+				if (channel != NULL && outgoingCommand->sendAttempts < 1) {
+					channel->usedReliableWindows |= 1 << reliableWindow;
+					++channel->reliableWindows[reliableWindow];
+				}
+
+				++outgoingCommand->sendAttempts;
+				++peer->packetsSent;
+
+				if (outgoingCommand->roundTripTimeout == 0) {
+					outgoingCommand->roundTripTimeout = enet_protocol_round_trip_timeout(host, peer);
+					outgoingCommand->roundTripTimeoutLimit = peer->timeoutLimit * outgoingCommand->roundTripTimeout;
+				}
 
 				if (enet_list_empty(&peer->sentReliableCommands))
 					peer->nextTimeout = host->serviceTime + outgoingCommand->roundTripTimeout;
@@ -2751,6 +4607,7 @@ extern "C" {
 				enet_list_insert(enet_list_end(&peer->sentReliableCommands),
 				enet_list_remove(&outgoingCommand->outgoingCommandList));
 
+				outgoingCommand->inTransit = 1;
 				outgoingCommand->sentTime = host->serviceTime;
 				host->headerFlags |= ENET_PROTOCOL_HEADER_FLAG_SENT_TIME;
 				peer->reliableDataInTransit += outgoingCommand->fragmentLength;
@@ -2806,13 +4663,26 @@ extern "C" {
 				host->packetSize += outgoingCommand->fragmentLength;
 			} else if (!(outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE)) {
 				enet_free(outgoingCommand);
+
+				outgoingCommand = NULL;
 			}
 
 			++peer->totalPacketsSent;
 			++command;
 			++buffer;
+
+			if (outgoingCommand != NULL && outgoingCommand->packet != NULL && !(outgoingCommand->command.header.command & ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE)) {
+				ENetOutgoingCommand* parityCommand = enet_protocol_add_parity_member(host, peer, outgoingCommand);
+
+				if (parityCommand != NULL)
+					enet_list_insert(enet_list_end(&parityCommands), parityCommand);
+			}
 		}
 
+		/* Parity commands lead the next datagram, so losing this one cannot take one along with the member that completed its group. */
+		if (!enet_list_empty(&parityCommands))
+			enet_list_move(enet_list_begin(&peer->outgoingCommands), enet_list_begin(&parityCommands), enet_list_back(&parityCommands));
+
 		host->commandCount = command - host->commands;
 		host->bufferCount = buffer - host->buffers;
 
@@ -2822,112 +4692,405 @@ extern "C" {
 		return canPing;
 	}
 
-	static int enet_protocol_send_outgoing_commands(ENetHost* host, ENetEvent* event, int checkForTimeouts) {
-		uint8_t headerData[sizeof(ENetProtocolHeader) + sizeof(enet_checksum)];
-		ENetProtocolHeader* header = (ENetProtocolHeader*)headerData;
-		ENetPeer* currentPeer;
-		int sentLength;
-		host->continueSending = 1;
+	static int enet_protocol_flush_outgoing_datagrams(ENetHost* host) {
+		if (host->ioRing != NULL)
+			return enet_io_ring_flush(host->ioRing);
 
-		while (host->continueSending) {
-			for (host->continueSending = 0, currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
-				if (currentPeer->state == ENET_PEER_STATE_DISCONNECTED || currentPeer->state == ENET_PEER_STATE_ZOMBIE)
-					continue;
+		if (host->ioBatch == NULL)
+			return 0;
 
-				host->headerFlags = 0;
-				host->commandCount = 0;
-				host->bufferCount = 1;
-				host->packetSize = sizeof(ENetProtocolHeader);
+		return enet_io_batch_flush(host->socket, host->ioBatch);
+	}
 
-				if (host->checksumCallback != NULL)
-					host->packetSize += sizeof(enet_checksum);
+	#define enet_peer_from_send_list(node) ((ENetPeer*)((uint8_t*)(node) - offsetof(ENetPeer, sendList)))
 
-				if (!enet_list_empty(&currentPeer->acknowledgements))
-					enet_protocol_send_acknowledgements(host, currentPeer);
+	/*
+		Peers with nothing to send wait in a hierarchical timer wheel keyed on millisecond deadlines.
+		Each level has ENET_TIMER_WHEEL_SLOTS slots, and every level up is that many times coarser.
+		A slot holding later deadlines is cascaded into the finer levels when the wheel reaches it.
+	*/
+	void enet_timer_wheel_schedule(ENetHost* host, ENetPeer* peer, uint32_t deadline) {
+		uint32_t delta;
+		size_t level;
 
-				if (checkForTimeouts != 0 && !enet_list_empty(&currentPeer->sentReliableCommands) && ENET_TIME_GREATER_EQUAL(host->serviceTime, currentPeer->nextTimeout) && enet_protocol_check_timeouts(host, currentPeer, event) == 1) {
-					if (event != NULL && event->type != ENET_EVENT_TYPE_NONE)
-						return 1;
-					else
-						continue;
-				}
+		if (peer->sendState != ENET_PEER_SEND_NONE)
+			enet_list_remove(&peer->sendList);
 
-				if ((enet_list_empty(&currentPeer->outgoingCommands) || enet_protocol_check_outgoing_commands(host, currentPeer)) && enet_list_empty(&currentPeer->sentReliableCommands) && ENET_TIME_DIFFERENCE(host->serviceTime, currentPeer->lastReceiveTime) >= currentPeer->pingInterval && currentPeer->mtu - host->packetSize >= sizeof(ENetProtocolPing)) {
-					enet_peer_ping(currentPeer);
-					enet_protocol_check_outgoing_commands(host, currentPeer);
-				}
+		if (ENET_TIME_LESS_EQUAL(deadline, host->timerWheelTime)) {
+			enet_list_insert(enet_list_end(&host->activePeers), &peer->sendList);
 
-				if (host->commandCount == 0)
-					continue;
+			peer->sendState = ENET_PEER_SEND_ACTIVE;
 
-				host->buffers->data = headerData;
+			return;
+		}
 
-				if (host->headerFlags & ENET_PROTOCOL_HEADER_FLAG_SENT_TIME) {
-					header->sentTime = ENET_HOST_TO_NET_16(host->serviceTime & 0xFFFF);
-					host->buffers->dataLength = sizeof(ENetProtocolHeader);
-				} else {
-					host->buffers->dataLength = (size_t)&((ENetProtocolHeader*)0)->sentTime;
-				}
+		delta = deadline - host->timerWheelTime;
 
-				if (currentPeer->outgoingPeerID < ENET_PROTOCOL_MAXIMUM_PEER_ID)
-					host->headerFlags |= currentPeer->outgoingSessionID << ENET_PROTOCOL_HEADER_SESSION_SHIFT;
+		if (delta >= 1u << (ENET_TIMER_WHEEL_SLOT_BITS * ENET_TIMER_WHEEL_LEVELS)) {
+			delta = (1u << (ENET_TIMER_WHEEL_SLOT_BITS * ENET_TIMER_WHEEL_LEVELS)) - 1;
+			deadline = host->timerWheelTime + delta;
+		}
 
-				header->peerID = ENET_HOST_TO_NET_16(currentPeer->outgoingPeerID | host->headerFlags);
+		for (level = 0; level < ENET_TIMER_WHEEL_LEVELS - 1 && delta >= 1u << (ENET_TIMER_WHEEL_SLOT_BITS * (level + 1)); ++level);
 
-				if (host->checksumCallback != NULL) {
-					enet_checksum* checksum = (enet_checksum*)&headerData[host->buffers->dataLength];
-					*checksum = currentPeer->outgoingPeerID < ENET_PROTOCOL_MAXIMUM_PEER_ID ? currentPeer->connectID : 0;
-					host->buffers->dataLength += sizeof(enet_checksum);
-					*checksum = host->checksumCallback(host->buffers, host->bufferCount);
-				}
+		peer->nextSendCheck = deadline;
+		peer->sendState = ENET_PEER_SEND_TIMER;
 
-				currentPeer->lastSendTime = host->serviceTime;
-				sentLength = enet_socket_send(host->socket, &currentPeer->address, host->buffers, host->bufferCount);
+		enet_list_insert(enet_list_end(&host->timerWheel[level][(deadline >> (ENET_TIMER_WHEEL_SLOT_BITS * level)) & (ENET_TIMER_WHEEL_SLOTS - 1)]), &peer->sendList);
+	}
 
-				enet_protocol_remove_sent_unreliable_commands(currentPeer);
+	static void enet_timer_wheel_cascade(ENetHost* host, ENetList* slot) {
+		while (!enet_list_empty(slot)) {
+			ENetPeer* peer = enet_peer_from_send_list(enet_list_begin(slot));
 
-				if (sentLength < 0)
-					return -1;
+			enet_timer_wheel_schedule(host, peer, peer->nextSendCheck);
+		}
+	}
 
-				host->totalSentData += sentLength;
-				currentPeer->totalDataSent += sentLength;
-				host->totalSentPackets++;
+	/* Moves every peer whose deadline has passed onto the active list; the cost is one step per elapsed millisecond plus the peers that fire. */
+	void enet_timer_wheel_advance(ENetHost* host) {
+		size_t level, slot;
+
+		if (ENET_TIME_DIFFERENCE(host->serviceTime, host->timerWheelTime) >= 1u << (ENET_TIMER_WHEEL_SLOT_BITS * (ENET_TIMER_WHEEL_LEVELS - 1))) {
+			ENetList pending;
+
+			enet_list_clear(&pending);
+
+			for (level = 0; level < ENET_TIMER_WHEEL_LEVELS; ++level) {
+				for (slot = 0; slot < ENET_TIMER_WHEEL_SLOTS; ++slot) {
+					if (!enet_list_empty(&host->timerWheel[level][slot]))
+						enet_list_move(enet_list_end(&pending), enet_list_begin(&host->timerWheel[level][slot]), enet_list_back(&host->timerWheel[level][slot]));
+				}
 			}
-		}
 
-		return 0;
-	}
+			host->timerWheelTime = host->serviceTime;
+			enet_timer_wheel_cascade(host, &pending);
 
-	void enet_host_flush(ENetHost* host) {
-		host->serviceTime = enet_time_get();
+			return;
+		}
 
-		enet_protocol_send_outgoing_commands(host, NULL, 0);
-	}
+		while (ENET_TIME_LESS(host->timerWheelTime, host->serviceTime)) {
+			uint32_t time = ++host->timerWheelTime;
 
-	int enet_host_check_events(ENetHost* host, ENetEvent* event) {
-		if (event == NULL)
-			return -1;
+			for (level = 1; level < ENET_TIMER_WHEEL_LEVELS && (time & ((1u << (ENET_TIMER_WHEEL_SLOT_BITS * level)) - 1)) == 0; ++level);
 
-		event->type = ENET_EVENT_TYPE_NONE;
-		event->peer = NULL;
-		event->packet = NULL;
+			while (--level > 0) {
+				enet_timer_wheel_cascade(host, &host->timerWheel[level][(time >> (ENET_TIMER_WHEEL_SLOT_BITS * level)) & (ENET_TIMER_WHEEL_SLOTS - 1)]);
+			}
 
-		return enet_protocol_dispatch_incoming_commands(host, event);
+			enet_timer_wheel_cascade(host, &host->timerWheel[0][time & (ENET_TIMER_WHEEL_SLOTS - 1)]);
+		}
 	}
 
-	int enet_host_service(ENetHost* host, ENetEvent* event, uint32_t timeout) {
-		uint32_t waitCondition;
+	/* Earliest time the wheel can fire, or an active peer's retransmission falls due; the service wait never sleeps past it. */
+	uint32_t enet_timer_wheel_next_deadline(ENetHost* host, uint32_t limit) {
+		ENetListIterator currentNode;
+		size_t level, step;
 
-		if (event != NULL) {
-			event->type = ENET_EVENT_TYPE_NONE;
-			event->peer = NULL;
-			event->packet = NULL;
+		/*
+			A send pass cut short by the host's budget goes round again without waiting, and so does a receive pass that left
+			datagrams of the last batch in user space, which waiting on the drained socket would hold until new traffic arrives.
+		*/
+		if (host->continueSending || (host->ioBatch != NULL && enet_io_batch_pending(host->ioBatch)))
+			return host->serviceTime;
 
-			switch (enet_protocol_dispatch_incoming_commands(host, event)) {
-				case 1:
-					return 1;
+		for (currentNode = enet_list_begin(&host->activePeers); currentNode != enet_list_end(&host->activePeers); currentNode = enet_list_next(currentNode)) {
+			ENetPeer* peer = enet_peer_from_send_list(currentNode);
 
-				case -1:
+			if (!enet_list_empty(&peer->sentReliableCommands) && ENET_TIME_LESS(peer->nextTimeout, limit))
+				limit = peer->nextTimeout;
+		}
+
+		for (level = 0; level < ENET_TIMER_WHEEL_LEVELS; ++level) {
+			uint32_t shift = ENET_TIMER_WHEEL_SLOT_BITS * level;
+			uint32_t base = host->timerWheelTime >> shift;
+
+			for (step = 1; step <= ENET_TIMER_WHEEL_SLOTS; ++step) {
+				uint32_t time = (base + (uint32_t)step) << shift;
+
+				if (!ENET_TIME_LESS(time, limit))
+					break;
+
+				if (!enet_list_empty(&host->timerWheel[level][(base + step) & (ENET_TIMER_WHEEL_SLOTS - 1)])) {
+					limit = time;
+
+					break;
+				}
+			}
+		}
+
+		return limit;
+	}
+
+	/* Peers with nothing queued, or held back by pacing or held parity, leave the send list until a retransmission, ping, acknowledgement, pacing, parity or probe deadline falls due. */
+	static void enet_protocol_settle_active_peers(ENetHost* host) {
+		ENetListIterator currentNode = enet_list_begin(&host->activePeers);
+
+		while (currentNode != enet_list_end(&host->activePeers)) {
+			ENetPeer* peer = enet_peer_from_send_list(currentNode);
+			uint32_t deadline;
+
+			currentNode = enet_list_next(currentNode);
+
+			if (peer->state == ENET_PEER_STATE_DISCONNECTED || peer->state == ENET_PEER_STATE_ZOMBIE) {
+				enet_list_remove(&peer->sendList);
+
+				peer->sendState = ENET_PEER_SEND_NONE;
+
+				continue;
+			}
+
+			if (!enet_list_empty(&peer->sentUnreliableCommands) || (!enet_list_empty(&peer->outgoingCommands) && enet_protocol_pacing_allows(host, peer) && !enet_protocol_parity_held(host, peer)))
+				continue;
+
+			if (!enet_list_empty(&peer->acknowledgements) && enet_protocol_acknowledgements_due(host, peer))
+				continue;
+
+			if (host->maximumMtu != 0 && peer->state == ENET_PEER_STATE_CONNECTED && peer->mtuProbeSize != 0 && peer->mtuProbeAttempts == 0)
+				continue;
+
+			deadline = enet_list_empty(&peer->sentReliableCommands) ? peer->lastReceiveTime + peer->pingInterval : peer->nextTimeout;
+
+			/* A probe in flight is sent again, or given up on, after a round trip timeout. */
+			if (host->maximumMtu != 0 && peer->mtuProbeSize != 0 && peer->mtuProbeAttempts > 0) {
+				uint32_t probeDeadline = peer->mtuProbeTime + enet_protocol_round_trip_timeout(host, peer);
+
+				if (ENET_TIME_LESS(probeDeadline, deadline))
+					deadline = probeDeadline;
+			}
+
+			/* Held acknowledgements fall due at the end of the host's delay. */
+			if (!enet_list_empty(&peer->acknowledgements)) {
+				uint32_t acknowledgementDeadline = ((ENetAcknowledgement*)enet_list_front(&peer->acknowledgements))->receivedTime + host->acknowledgementDelay;
+
+				if (ENET_TIME_LESS(acknowledgementDeadline, deadline))
+					deadline = acknowledgementDeadline;
+			}
+
+			/* Held parity goes out on its own once the oldest has waited its hold. */
+			if (!enet_list_empty(&peer->outgoingCommands) && enet_protocol_parity_held(host, peer)) {
+				ENetListIterator currentCommand;
+
+				for (currentCommand = enet_list_begin(&peer->outgoingCommands); currentCommand != enet_list_end(&peer->outgoingCommands); currentCommand = enet_list_next(currentCommand)) {
+					uint32_t parityDeadline = ((ENetOutgoingCommand*)currentCommand)->sentTime + ENET_PEER_PARITY_HOLD;
+
+					if (ENET_TIME_LESS(parityDeadline, deadline))
+						deadline = parityDeadline;
+				}
+			}
+
+			/* A peer held back by pacing waits until its credit is refilled. */
+			if (!enet_list_empty(&peer->outgoingCommands) && !enet_protocol_pacing_allows(host, peer)) {
+				uint32_t pacingDeadline = peer->pacingTime + (uint32_t)(((uint64_t)(1 - peer->pacingCredit) * 1000 + peer->sendRate - 1) / peer->sendRate);
+
+				if (ENET_TIME_LESS(pacingDeadline, deadline))
+					deadline = pacingDeadline;
+			}
+
+			/* Already due: stay put, rather than re-append to the list being walked. */
+			if (ENET_TIME_LESS_EQUAL(deadline, host->timerWheelTime))
+				continue;
+
+			enet_timer_wheel_schedule(host, peer, deadline);
+		}
+	}
+
+	static int enet_protocol_send_outgoing_commands(ENetHost* host, ENetEvent* event, int checkForTimeouts) {
+		uint8_t headerData[sizeof(ENetProtocolHeader) + sizeof(uint8_t) + sizeof(enet_checksum)];
+		ENetProtocolHeader* header = (ENetProtocolHeader*)headerData;
+		ENetListIterator currentNode, sentReliableBack;
+		ENetPeer* currentPeer;
+		int sentLength, probing;
+		uint32_t sentDatagrams = 0;
+		host->continueSending = 1;
+
+		enet_timer_wheel_advance(host);
+
+		while (host->continueSending && (host->sendBudget == 0 || sentDatagrams < host->sendBudget)) {
+			for (host->continueSending = 0, currentNode = enet_list_begin(&host->activePeers); currentNode != enet_list_end(&host->activePeers);) {
+				currentPeer = enet_peer_from_send_list(currentNode);
+				currentNode = enet_list_next(currentNode);
+
+				if (currentPeer->state == ENET_PEER_STATE_DISCONNECTED || currentPeer->state == ENET_PEER_STATE_ZOMBIE)
+					continue;
+
+				host->headerFlags = 0;
+				host->commandCount = 0;
+				host->bufferCount = 1;
+				host->packetSize = sizeof(ENetProtocolHeader);
+
+				if (currentPeer->outgoingPeerID > ENET_PROTOCOL_MAXIMUM_PEER_ID)
+					host->packetSize += sizeof(uint8_t);
+
+				if (host->checksumCallback != NULL)
+					host->packetSize += sizeof(enet_checksum);
+
+				if (!enet_list_empty(&currentPeer->acknowledgements) && enet_protocol_acknowledgements_due(host, currentPeer))
+					enet_protocol_send_acknowledgements(host, currentPeer);
+
+				if (checkForTimeouts != 0 && !enet_list_empty(&currentPeer->sentReliableCommands) && ENET_TIME_GREATER_EQUAL(host->serviceTime, currentPeer->nextTimeout) && enet_protocol_check_timeouts(host, currentPeer, event) == 1) {
+					if (event != NULL && event->type != ENET_EVENT_TYPE_NONE) {
+						enet_protocol_flush_outgoing_datagrams(host);
+
+						return 1;
+					} else {
+						continue;
+					}
+				}
+
+				sentReliableBack = enet_list_back(&currentPeer->sentReliableCommands);
+				probing = enet_protocol_add_mtu_probe(host, currentPeer);
+
+				if (!probing && enet_protocol_pacing_allows(host, currentPeer) && (enet_list_empty(&currentPeer->outgoingCommands) || (host->commandCount == 0 && enet_protocol_parity_held(host, currentPeer)) || enet_protocol_check_outgoing_commands(host, currentPeer)) && enet_list_empty(&currentPeer->sentReliableCommands) && ENET_TIME_DIFFERENCE(host->serviceTime, currentPeer->lastReceiveTime) >= enet_protocol_ping_interval(host, currentPeer) && currentPeer->mtu - host->packetSize >= sizeof(ENetProtocolPing)) {
+					enet_peer_ping(currentPeer);
+					enet_protocol_check_outgoing_commands(host, currentPeer);
+				}
+
+				/* Held acknowledgements ride along with any datagram the peer is sent anyway; those that do not fit lead the next one. */
+				if (!probing && host->commandCount > 0 && !enet_list_empty(&currentPeer->acknowledgements)) {
+					enet_protocol_send_acknowledgements(host, currentPeer);
+
+					if (!enet_list_empty(&currentPeer->acknowledgements))
+						currentPeer->acknowledgeImmediately = 1;
+				}
+
+				if (host->commandCount == 0)
+					continue;
+
+				enet_protocol_update_send_statistics(host, currentPeer);
+
+				/* Reliable commands remember the size of the datagram they went out in, for black hole detection. */
+				if (host->maximumMtu != 0) {
+					for (sentReliableBack = enet_list_next(sentReliableBack); sentReliableBack != enet_list_end(&currentPeer->sentReliableCommands); sentReliableBack = enet_list_next(sentReliableBack)) {
+						((ENetOutgoingCommand*)sentReliableBack)->datagramSize = (uint16_t)host->packetSize;
+					}
+				}
+
+				host->buffers->data = headerData;
+
+				if (host->headerFlags & ENET_PROTOCOL_HEADER_FLAG_SENT_TIME) {
+					header->sentTime = ENET_HOST_TO_NET_16(host->serviceTime & 0xFFFF);
+					host->buffers->dataLength = sizeof(ENetProtocolHeader);
+				} else {
+					host->buffers->dataLength = (size_t)&((ENetProtocolHeader*)0)->sentTime;
+				}
+
+				if (currentPeer->outgoingPeerID != ENET_PROTOCOL_MAXIMUM_PEER_ID)
+					host->headerFlags |= currentPeer->outgoingSessionID << ENET_PROTOCOL_HEADER_SESSION_SHIFT;
+
+				if (currentPeer->outgoingPeerID > ENET_PROTOCOL_MAXIMUM_PEER_ID) {
+					host->headerFlags |= ENET_PROTOCOL_HEADER_FLAG_EXTENDED_PEER_ID;
+					headerData[host->buffers->dataLength++] = (uint8_t)(currentPeer->outgoingPeerID >> 12);
+				}
+
+				header->peerID = ENET_HOST_TO_NET_16((currentPeer->outgoingPeerID & ENET_PROTOCOL_MAXIMUM_PEER_ID) | host->headerFlags);
+
+				if (host->checksumCallback != NULL) {
+					enet_checksum* checksum = (enet_checksum*)&headerData[host->buffers->dataLength];
+					*checksum = currentPeer->outgoingPeerID != ENET_PROTOCOL_MAXIMUM_PEER_ID ? currentPeer->connectID : 0;
+					host->buffers->dataLength += sizeof(enet_checksum);
+					*checksum = host->checksumCallback(host->buffers, host->bufferCount);
+				}
+
+				currentPeer->lastSendTime = host->serviceTime;
+
+				/* A probe is sent on its own, so the socket refusing one too large for the local interface is seen here rather than failing a batch. */
+				if (probing)
+					sentLength = enet_socket_send(host->socket, &currentPeer->address, host->buffers, host->bufferCount);
+				else if (host->ioRing != NULL)
+					sentLength = enet_io_ring_send(host->socket, host->ioRing, &currentPeer->address, host->buffers, host->bufferCount);
+				else if (host->ioBatch != NULL)
+					sentLength = enet_io_batch_send(host->socket, host->ioBatch, &currentPeer->address, host->buffers, host->bufferCount);
+				else
+					sentLength = enet_socket_send(host->socket, &currentPeer->address, host->buffers, host->bufferCount);
+
+				/*
+					Under discovery the socket refuses datagrams larger than the path it knows of; that is no host error.
+					A probe of that size fails at once, and any other datagram means the confirmed MTU no longer holds, so it counts as lost.
+				*/
+				if (sentLength < 0 && host->maximumMtu != 0 && enet_socket_message_too_large()) {
+					if (probing) {
+						currentPeer->mtuSearchLimit = currentPeer->mtuProbeSize;
+						currentPeer->mtuProbeSize = 0;
+						currentPeer->mtuProbeAttempts = 0;
+					} else {
+						enet_protocol_mtu_black_hole(host, currentPeer);
+					}
+
+					sentLength = 0;
+				}
+
+				enet_protocol_remove_sent_unreliable_commands(currentPeer);
+
+				if (sentLength < 0) {
+					enet_protocol_flush_outgoing_datagrams(host);
+
+					return -1;
+				}
+
+				host->totalSentData += sentLength;
+				currentPeer->totalDataSent += sentLength;
+				currentPeer->congestionDataSent += sentLength;
+
+				if (host->congestionControl == ENET_CONGESTION_CONTROL_DELAY)
+					currentPeer->pacingCredit -= sentLength;
+
+				host->totalSentPackets++;
+
+				/*
+					Peers served so far move behind the rest, so the next pass starts with the peers this one cut off.
+					continueSending stays set, which keeps the service wait from sleeping on the remainder.
+				*/
+				if (host->sendBudget != 0 && ++sentDatagrams >= host->sendBudget) {
+					if (enet_list_previous(currentNode) != enet_list_end(&host->activePeers))
+						enet_list_move(enet_list_end(&host->activePeers), enet_list_begin(&host->activePeers), enet_list_previous(currentNode));
+
+					host->continueSending = 1;
+					++host->budgetStats.sendBudgetExhausted;
+
+					break;
+				}
+			}
+		}
+
+		enet_protocol_settle_active_peers(host);
+
+		return enet_protocol_flush_outgoing_datagrams(host);
+	}
+
+	void enet_host_flush(ENetHost* host) {
+		host->serviceTime = enet_time_get();
+
+		enet_protocol_send_outgoing_commands(host, NULL, 0);
+	}
+
+	int enet_host_check_events(ENetHost* host, ENetEvent* event) {
+		if (event == NULL)
+			return -1;
+
+		event->type = ENET_EVENT_TYPE_NONE;
+		event->peer = NULL;
+		event->packet = NULL;
+
+		return enet_protocol_dispatch_incoming_commands(host, event);
+	}
+
+	int enet_host_service(ENetHost* host, ENetEvent* event, uint32_t timeout) {
+		uint32_t waitCondition, deadline;
+
+		if (host->peerSlotCount > 0 && host->peers[host->peerSlotCount - 1].state == ENET_PEER_STATE_DISCONNECTED)
+			enet_host_trim_peer_slots(host);
+
+		if (event != NULL) {
+			event->type = ENET_EVENT_TYPE_NONE;
+			event->peer = NULL;
+			event->packet = NULL;
+
+			switch (enet_protocol_dispatch_incoming_commands(host, event)) {
+				case 1:
+					return 1;
+
+				case -1:
 					#ifdef ENET_DEBUG
 						perror("Error dispatching incoming packets");
 					#endif
@@ -2943,6 +5106,12 @@ extern "C" {
 		timeout += host->serviceTime;
 
 		do {
+			/* Each iteration gives peers that reached the dispatch limit a fresh allowance, behind the peers already queued. */
+			++host->dispatchEpoch;
+
+			if (!enet_list_empty(&host->deferredDispatchQueue))
+				enet_list_move(enet_list_end(&host->dispatchQueue), enet_list_begin(&host->deferredDispatchQueue), enet_list_back(&host->deferredDispatchQueue));
+
 			if (ENET_TIME_DIFFERENCE(host->serviceTime, host->bandwidthThrottleEpoch) >= ENET_HOST_BANDWIDTH_THROTTLE_INTERVAL)
 				enet_host_bandwidth_throttle(host);
 
@@ -3018,17 +5187,25 @@ extern "C" {
 					return 0;
 
 				waitCondition = ENET_SOCKET_WAIT_RECEIVE | ENET_SOCKET_WAIT_INTERRUPT;
+				deadline = enet_timer_wheel_next_deadline(host, timeout);
 
-				if (enet_socket_wait(host->socket, &waitCondition, ENET_TIME_DIFFERENCE(timeout, host->serviceTime)) != 0)
+				if (host->ioRing != NULL) {
+					if (enet_io_ring_wait(host->socket, host->ioRing, &waitCondition, ENET_TIME_DIFFERENCE(deadline, host->serviceTime)) != 0)
+						return -1;
+				} else if (enet_socket_wait(host->socket, &waitCondition, ENET_TIME_DIFFERENCE(deadline, host->serviceTime)) != 0) {
 					return -1;
+				}
 			}
 
 			while (waitCondition & ENET_SOCKET_WAIT_INTERRUPT);
 
+			/* A datagram arriving during the wait ends it, so nothing has sat unread. */
 			host->serviceTime = enet_time_get();
+			host->receiveTime = host->serviceTime;
 		}
 
-		while (waitCondition & ENET_SOCKET_WAIT_RECEIVE);
+		/* A timer deadline ends the wait early; go round again to fire it unless the caller's timeout is up too. */
+		while ((waitCondition & ENET_SOCKET_WAIT_RECEIVE) || ENET_TIME_LESS(host->serviceTime, timeout));
 
 		return 0;
 	}
@@ -3078,6 +5255,88 @@ extern "C" {
 		return 0;
 	}
 
+	/* Samples arriving within two round trips of a cut were sent before it took effect, so they cannot justify another. */
+	static int enet_peer_delay_decrease_allowed(ENetPeer* peer) {
+		return peer->congestionDecreaseTime == 0 || ENET_TIME_DIFFERENCE(peer->host->serviceTime, peer->congestionDecreaseTime) >= 2 * peer->roundTripTime;
+	}
+
+	/* No cut takes the rate below half of what the path recently delivered, so a cut on a stall or a random loss is undone within a few round trips instead of compounding. */
+	static uint32_t enet_peer_delay_floor(ENetPeer* peer) {
+		return ENET_MIN(ENET_MAX(peer->deliveryRate / 2, ENET_PEER_MINIMUM_SEND_RATE), peer->sendRate);
+	}
+
+	/*
+		The lowest recent round trip time is taken as the delay of the path with empty queues. Once per round trip, the send rate grows while the lowest sample stays within ENET_PEER_CONGESTION_TARGET_DELAY of it, and shrinks in proportion to any excess.
+		Queues are kept short rather than filled until packets drop, and the rate only grows while pacing held data back or the peer is sent at least half of it.
+		An acknowledgement read late because the host was not serviced would look like queueing, so the time it may have sat unread is taken off before the sample counts.
+	*/
+	void enet_peer_delay_control(ENetPeer* peer, uint32_t rtt) {
+		uint32_t serviceTime = peer->host->serviceTime, sendRate = peer->sendRate, elapsed, queueDelay, sample, deliveryRate;
+
+		if (peer->baseRoundTripTime == 0 || rtt < peer->baseRoundTripTime) {
+			peer->baseRoundTripTime = rtt;
+			peer->baseRoundTripTimeEpoch = serviceTime;
+		}
+
+		sample = ENET_MAX(rtt > peer->host->receiveGap ? rtt - peer->host->receiveGap : 0, peer->baseRoundTripTime);
+
+		if (sample < peer->congestionDelay)
+			peer->congestionDelay = sample;
+
+		elapsed = ENET_TIME_DIFFERENCE(serviceTime, peer->congestionEpoch);
+
+		if (elapsed < ENET_MAX(peer->roundTripTime, ENET_PEER_CONGESTION_MINIMUM_INTERVAL))
+			return;
+
+		queueDelay = peer->congestionDelay - peer->baseRoundTripTime;
+
+		/* The highest recent delivery rate, let go of by an eighth each round trip it is not matched. */
+		deliveryRate = (uint32_t)ENET_MIN((uint64_t)peer->congestionDataAcknowledged * 1000 / elapsed, ENET_PEER_MAXIMUM_SEND_RATE);
+		peer->deliveryRate = ENET_MAX(deliveryRate, peer->deliveryRate - peer->deliveryRate / 8);
+
+		if (queueDelay > ENET_PEER_CONGESTION_TARGET_DELAY) {
+			if (enet_peer_delay_decrease_allowed(peer)) {
+				sendRate -= (uint32_t)((uint64_t)sendRate * ENET_MIN(queueDelay - ENET_PEER_CONGESTION_TARGET_DELAY, ENET_PEER_CONGESTION_TARGET_DELAY) / (4 * ENET_PEER_CONGESTION_TARGET_DELAY));
+				sendRate = ENET_MAX(sendRate, enet_peer_delay_floor(peer));
+				peer->congestionDecreaseTime = serviceTime;
+			}
+		} else if (peer->congestionLimited || (uint64_t)peer->congestionDataSent * 1000 * 2 >= (uint64_t)sendRate * elapsed) {
+			sendRate += (uint32_t)((uint64_t)sendRate * (ENET_PEER_CONGESTION_TARGET_DELAY - queueDelay) / (16 * ENET_PEER_CONGESTION_TARGET_DELAY)) + peer->mtu;
+		}
+
+		peer->sendRate = ENET_MIN(ENET_MAX(sendRate, ENET_PEER_MINIMUM_SEND_RATE), ENET_PEER_MAXIMUM_SEND_RATE);
+		peer->congestionQueueDelay = queueDelay;
+
+		/* A route change can raise the path delay for good, so the base is renewed from recent samples. */
+		if (ENET_TIME_DIFFERENCE(serviceTime, peer->baseRoundTripTimeEpoch) >= ENET_PEER_BASE_DELAY_INTERVAL) {
+			peer->baseRoundTripTime = peer->congestionDelay;
+			peer->baseRoundTripTimeEpoch = serviceTime;
+		}
+
+		peer->congestionEpoch = serviceTime;
+		peer->congestionDelay = 0xFFFFFFFF;
+		peer->congestionDataSent = 0;
+		peer->congestionDataAcknowledged = 0;
+		peer->congestionLimited = 0;
+	}
+
+	/*
+		A loss found by fast retransmission halves the send rate once per loss episode: data sent before the last cut went out at the rate that cut replaced, so its losses are already answered.
+		Only a loss met with queueing delay is taken as congestion, since a queue fills before it overflows; without one the loss is taken as random and the rate is left alone.
+		The queueing delay is the lowest of the last round trip rather than the smoothed round trip time, which cannot come down by less than 8 ms at a time and so stays up for good after a stall.
+		Timeouts are left out: queueing delay within the target can outgrow the retransmission timeout and fire it spuriously.
+	*/
+	void enet_peer_delay_loss(ENetPeer* peer, uint32_t sentTime) {
+		if (peer->congestionDecreaseTime != 0 && ENET_TIME_LESS(sentTime, peer->congestionDecreaseTime))
+			return;
+
+		if (peer->congestionQueueDelay < ENET_PEER_CONGESTION_TARGET_DELAY / 4)
+			return;
+
+		peer->sendRate = ENET_MAX(peer->sendRate / 2, enet_peer_delay_floor(peer));
+		peer->congestionDecreaseTime = peer->host->serviceTime;
+	}
+
 	int enet_peer_send(ENetPeer* peer, uint8_t channelID, ENetPacket* packet) {
 		ENetChannel* channel;
 		ENetProtocol command;
@@ -3248,6 +5507,49 @@ extern "C" {
 		enet_peer_remove_incoming_commands(queue, enet_list_begin(queue), enet_list_end(queue), NULL);
 	}
 
+	static void enet_peer_reset_parity(ENetChannel* channel) {
+		size_t record;
+
+		if (channel->outgoingParity != NULL) {
+			enet_free(channel->outgoingParity);
+
+			channel->outgoingParity = NULL;
+		}
+
+		if (channel->incomingParity != NULL) {
+			for (record = 0; record < ENET_PEER_PARITY_HISTORY; ++record) {
+				if (channel->incomingParity->records[record].data != NULL)
+					enet_free(channel->incomingParity->records[record].data);
+			}
+
+			enet_free(channel->incomingParity);
+
+			channel->incomingParity = NULL;
+		}
+	}
+
+	/*
+		Enables parity commands on an unreliable channel, each one letting the receiver rebuild a single lost command in its group without a round trip.
+		Groups shrink as the measured packet loss grows; peers that did not negotiate selective acknowledgement are never sent parity.
+		Parity waits up to ENET_PEER_PARITY_HOLD ms to ride in the next datagram to the peer. On a sequenced channel a rebuilt command
+		is only delivered if nothing later has been, so there parity mostly saves the last command of a group.
+	*/
+	void enet_peer_channel_parity(ENetPeer* peer, uint8_t channelID, uint8_t state) {
+		ENetChannel* channel;
+
+		if (channelID >= peer->channelCount)
+			return;
+
+		channel = &peer->channels[channelID];
+		channel->parity = state ? 1 : 0;
+
+		if (!channel->parity && channel->outgoingParity != NULL) {
+			enet_free(channel->outgoingParity);
+
+			channel->outgoingParity = NULL;
+		}
+	}
+
 	void enet_peer_reset_queues(ENetPeer* peer) {
 		ENetChannel* channel;
 
@@ -3257,19 +5559,32 @@ extern "C" {
 			peer->needsDispatch = 0;
 		}
 
+		if (peer->sendState != ENET_PEER_SEND_NONE) {
+			enet_list_remove(&peer->sendList);
+
+			peer->sendState = ENET_PEER_SEND_NONE;
+		}
+
 		while (!enet_list_empty(&peer->acknowledgements)) {
 			enet_free(enet_list_remove(enet_list_begin(&peer->acknowledgements)));
 		}
 
+		peer->acknowledgementCount = 0;
+		peer->acknowledgeImmediately = 0;
+
 		enet_peer_reset_outgoing_commands(&peer->sentReliableCommands);
 		enet_peer_reset_outgoing_commands(&peer->sentUnreliableCommands);
 		enet_peer_reset_outgoing_commands(&peer->outgoingCommands);
 		enet_peer_reset_incoming_commands(&peer->dispatchedCommands);
+		enet_sequence_ring_clear(&peer->sentSystemIndex);
 
 		if (peer->channels != NULL && peer->channelCount > 0) {
 			for (channel = peer->channels; channel < &peer->channels[peer->channelCount]; ++channel) {
 				enet_peer_reset_incoming_commands(&channel->incomingReliableCommands);
 				enet_peer_reset_incoming_commands(&channel->incomingUnreliableCommands);
+				enet_sequence_ring_clear(&channel->incomingReliableIndex);
+				enet_sequence_ring_clear(&channel->sentReliableIndex);
+				enet_peer_reset_parity(channel);
 			}
 
 			enet_free(peer->channels);
@@ -3299,9 +5614,12 @@ extern "C" {
 
 	void enet_peer_reset(ENetPeer* peer) {
 		enet_peer_on_disconnect(peer);
+		enet_host_release_peer_slot(peer->host, peer);
 
 		peer->outgoingPeerID = ENET_PROTOCOL_MAXIMUM_PEER_ID;
 		peer->state = ENET_PEER_STATE_DISCONNECTED;
+		peer->selectiveAcknowledge = 0;
+		peer->connectChallenged = 0;
 		peer->incomingBandwidth = 0;
 		peer->outgoingBandwidth = 0;
 		peer->incomingBandwidthThrottleEpoch = 0;
@@ -3316,6 +5634,24 @@ extern "C" {
 		peer->earliestTimeout = 0;
 		peer->totalPacketsSent = 0;
 		peer->totalPacketsLost = 0;
+		peer->totalPacketsRepaired = 0;
+		peer->packetLoss = 0;
+		peer->packetLossEpoch = 0;
+		peer->packetsSent = 0;
+		peer->packetsLost = 0;
+		peer->sendRate = ENET_PEER_DEFAULT_SEND_RATE;
+		peer->baseRoundTripTime = 0;
+		peer->baseRoundTripTimeEpoch = 0;
+		peer->congestionEpoch = 0;
+		peer->congestionDelay = 0xFFFFFFFF;
+		peer->congestionDataSent = 0;
+		peer->congestionDecreaseTime = 0;
+		peer->congestionQueueDelay = 0;
+		peer->congestionDataAcknowledged = 0;
+		peer->congestionLimited = 0;
+		peer->deliveryRate = 0;
+		peer->pacingCredit = 0;
+		peer->pacingTime = 0;
 		peer->packetThrottle = ENET_PEER_DEFAULT_PACKET_THROTTLE;
 		peer->packetThrottleThreshold = ENET_PEER_PACKET_THROTTLE_THRESHOLD;
 		peer->packetThrottleLimit = ENET_PEER_PACKET_THROTTLE_SCALE;
@@ -3334,7 +5670,15 @@ extern "C" {
 		peer->highestRoundTripTimeVariance = 0;
 		peer->roundTripTime = 1;
 		peer->roundTripTimeVariance = 0;
+		peer->remoteAcknowledgementDelay = 0;
 		peer->mtu = peer->host->mtu;
+		peer->mtuSearchLimit = 0;
+		peer->mtuProbeSize = 0;
+		peer->mtuProbeAttempts = 0;
+		peer->mtuProbeTime = 0;
+		peer->mtuBlackHoleLosses = 0;
+		peer->mtuLossTime = 0;
+		peer->mtuLossSize = 0;
 		peer->reliableDataInTransit = 0;
 		peer->outgoingReliableSequenceNumber = 0;
 		peer->windowSize = ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE;
@@ -3450,9 +5794,12 @@ extern "C" {
 
 		peer->outgoingDataTotal += sizeof(ENetProtocolAcknowledge);
 		acknowledgement->sentTime = sentTime;
+		acknowledgement->receivedTime = peer->host->serviceTime;
 		acknowledgement->command = *command;
 
 		enet_list_insert(enet_list_end(&peer->acknowledgements), acknowledgement);
+		++peer->acknowledgementCount;
+		enet_peer_mark_active(peer);
 
 		return acknowledgement;
 	}
@@ -3483,6 +5830,9 @@ extern "C" {
 		}
 
 		outgoingCommand->sendAttempts = 0;
+		outgoingCommand->laterAcknowledgements = 0;
+		outgoingCommand->inTransit = 0;
+		outgoingCommand->datagramSize = 0;
 		outgoingCommand->sentTime = 0;
 		outgoingCommand->roundTripTimeout = 0;
 		outgoingCommand->roundTripTimeoutLimit = 0;
@@ -3504,6 +5854,20 @@ extern "C" {
 		}
 
 		enet_list_insert(enet_list_end(&peer->outgoingCommands), outgoingCommand);
+		enet_peer_mark_active(peer);
+	}
+
+	/* Puts the peer on the host's send list so the next send pass visits it. */
+	void enet_peer_mark_active(ENetPeer* peer) {
+		if (peer->sendState == ENET_PEER_SEND_ACTIVE)
+			return;
+
+		if (peer->sendState == ENET_PEER_SEND_TIMER)
+			enet_list_remove(&peer->sendList);
+
+		enet_list_insert(enet_list_end(&peer->host->activePeers), &peer->sendList);
+
+		peer->sendState = ENET_PEER_SEND_ACTIVE;
 	}
 
 	ENetOutgoingCommand* enet_peer_queue_outgoing_command(ENetPeer* peer, const ENetProtocol* command, ENetPacket* packet, uint32_t offset, uint16_t length) {
@@ -3595,28 +5959,33 @@ extern "C" {
 		enet_peer_remove_incoming_commands(&channel->incomingUnreliableCommands, enet_list_begin(&channel->incomingUnreliableCommands), droppedCommand, queuedCommand);
 	}
 
+	/* Held commands are only reachable through the channel index, so each step toward the next expected sequence number is a single lookup. */
 	void enet_peer_dispatch_incoming_reliable_commands(ENetPeer* peer, ENetChannel* channel, ENetIncomingCommand* queuedCommand) {
-		ENetListIterator currentCommand;
+		ENetIncomingCommand* incomingCommand;
+		int dispatched = 0;
 
-		for (currentCommand = enet_list_begin(&channel->incomingReliableCommands); currentCommand != enet_list_end(&channel->incomingReliableCommands); currentCommand = enet_list_next(currentCommand)) {
-			ENetIncomingCommand* incomingCommand = (ENetIncomingCommand*)currentCommand;
+		for (;;) {
+			incomingCommand = (ENetIncomingCommand*)enet_sequence_ring_find(&channel->incomingReliableIndex, (uint16_t)(channel->incomingReliableSequenceNumber + 1));
 
-			if (incomingCommand->fragmentsRemaining > 0 || incomingCommand->reliableSequenceNumber != (uint16_t)(channel->incomingReliableSequenceNumber + 1))
+			if (incomingCommand == NULL || incomingCommand->fragmentsRemaining > 0)
 				break;
 
 			channel->incomingReliableSequenceNumber = incomingCommand->reliableSequenceNumber;
 
 			if (incomingCommand->fragmentCount > 0)
 				channel->incomingReliableSequenceNumber += incomingCommand->fragmentCount - 1;
+
+			enet_sequence_ring_remove(&channel->incomingReliableIndex, incomingCommand->reliableSequenceNumber, incomingCommand);
+			enet_list_insert(enet_list_end(&peer->dispatchedCommands), enet_list_remove(&incomingCommand->incomingCommandList));
+
+			dispatched = 1;
 		}
 
-		if (currentCommand == enet_list_begin(&channel->incomingReliableCommands))
+		if (!dispatched)
 			return;
 
 		channel->incomingUnreliableSequenceNumber = 0;
 
-		enet_list_move(enet_list_end(&peer->dispatchedCommands), enet_list_begin(&channel->incomingReliableCommands), enet_list_previous(currentCommand));
-
 		if (!peer->needsDispatch) {
 			enet_list_insert(enet_list_end(&peer->host->dispatchQueue), &peer->dispatchList);
 
@@ -3655,26 +6024,11 @@ extern "C" {
 		switch (command->header.command & ENET_PROTOCOL_COMMAND_MASK) {
 			case ENET_PROTOCOL_COMMAND_SEND_FRAGMENT:
 			case ENET_PROTOCOL_COMMAND_SEND_RELIABLE:
-				if (reliableSequenceNumber == channel->incomingReliableSequenceNumber)
+				if (reliableSequenceNumber == channel->incomingReliableSequenceNumber || enet_sequence_ring_find(&channel->incomingReliableIndex, (uint16_t)reliableSequenceNumber) != NULL)
 					goto discardCommand;
 
-				for (currentCommand = enet_list_previous(enet_list_end(&channel->incomingReliableCommands)); currentCommand != enet_list_end(&channel->incomingReliableCommands); currentCommand = enet_list_previous(currentCommand)) {
-					incomingCommand = (ENetIncomingCommand*)currentCommand;
-
-					if (reliableSequenceNumber >= channel->incomingReliableSequenceNumber) {
-						if (incomingCommand->reliableSequenceNumber < channel->incomingReliableSequenceNumber)
-							continue;
-					} else if (incomingCommand->reliableSequenceNumber >= channel->incomingReliableSequenceNumber) {
-						break;
-					}
-
-					if (incomingCommand->reliableSequenceNumber <= reliableSequenceNumber) {
-						if (incomingCommand->reliableSequenceNumber < reliableSequenceNumber)
-							break;
-
-						goto discardCommand;
-					}
-				}
+				/* Held reliable commands are kept in arrival order; the channel index provides sequencing. */
+				currentCommand = enet_list_previous(enet_list_end(&channel->incomingReliableCommands));
 
 				break;
 
@@ -3757,12 +6111,23 @@ extern "C" {
 			memset(incomingCommand->fragments, 0, (fragmentCount + 31) / 32 * sizeof(uint32_t));
 		}
 
-		if (packet != NULL) {
-			++packet->referenceCount;
-			peer->totalWaitingData += packet->dataLength;
-		}
+		if ((command->header.command & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_SEND_FRAGMENT || (command->header.command & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_SEND_RELIABLE) {
+			if (enet_sequence_ring_insert(&channel->incomingReliableIndex, incomingCommand->reliableSequenceNumber, incomingCommand) < 0) {
+				if (incomingCommand->fragments != NULL)
+					enet_free(incomingCommand->fragments);
 
-		enet_list_insert(enet_list_next(currentCommand), incomingCommand);
+				enet_free(incomingCommand);
+
+				goto notifyError;
+			}
+		}
+
+		if (packet != NULL) {
+			++packet->referenceCount;
+			peer->totalWaitingData += packet->dataLength;
+		}
+
+		enet_list_insert(enet_list_next(currentCommand), incomingCommand);
 
 		switch (command->header.command & ENET_PROTOCOL_COMMAND_MASK) {
 			case ENET_PROTOCOL_COMMAND_SEND_FRAGMENT:
@@ -3806,10 +6171,17 @@ extern "C" {
 */
 
 	ENetHost* enet_host_create(const ENetAddress* address, size_t peerCount, size_t channelLimit, uint32_t incomingBandwidth, uint32_t outgoingBandwidth, int bufferSize) {
+		return enet_host_create_with_backend(address, peerCount, channelLimit, incomingBandwidth, outgoingBandwidth, bufferSize, ENET_HOST_BACKEND_SOCKET);
+	}
+
+	/* Falls back to the socket backend when io_uring is unavailable, and from SQPOLL to plain io_uring when only one CPU is
+	   online; check enet_host_get_backend for the one in use. */
+	ENetHost* enet_host_create_with_backend(const ENetAddress* address, size_t peerCount, size_t channelLimit, uint32_t incomingBandwidth, uint32_t outgoingBandwidth, int bufferSize, ENetHostBackend backend) {
 		ENetHost* host;
-		ENetPeer* currentPeer;
+		size_t level, slot, bucketCount;
 
-		if (peerCount > ENET_PROTOCOL_MAXIMUM_PEER_ID)
+		/* Hosts with more than 0xFFF peers hand the upper slots only to peers that announce extended peer ids. */
+		if (peerCount > ENET_PROTOCOL_MAXIMUM_EXTENDED_PEER_ID)
 			return NULL;
 
 		host = (ENetHost*)enet_malloc(sizeof(ENetHost));
@@ -3819,7 +6191,8 @@ extern "C" {
 
 		memset(host, 0, sizeof(ENetHost));
 
-		host->peers = (ENetPeer*)enet_malloc(peerCount * sizeof(ENetPeer));
+		/* Peer slots are only reserved here; pages are committed as slots come into use. */
+		host->peers = (ENetPeer*)enet_memory_reserve(peerCount * sizeof(ENetPeer));
 
 		if (host->peers == NULL) {
 			enet_free(host);
@@ -3827,7 +6200,20 @@ extern "C" {
 			return NULL;
 		}
 
-		memset(host->peers, 0, peerCount * sizeof(ENetPeer));
+		/* One address bucket per peer slot, rounded up to a power of two. */
+		bucketCount = 1;
+
+		while (bucketCount < peerCount)
+			bucketCount <<= 1;
+
+		host->addressBuckets = (ENetList*)enet_malloc(bucketCount * sizeof(ENetList));
+
+		if (host->addressBuckets == NULL) {
+			enet_memory_release(host->peers, peerCount * sizeof(ENetPeer));
+			enet_free(host);
+
+			return NULL;
+		}
 
 		host->socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
 
@@ -3838,7 +6224,8 @@ extern "C" {
 			if (host->socket != ENET_SOCKET_NULL)
 				enet_socket_destroy(host->socket);
 
-			enet_free(host->peers);
+			enet_free(host->addressBuckets);
+			enet_memory_release(host->peers, peerCount * sizeof(ENetPeer));
 			enet_free(host);
 
 			return NULL;
@@ -3871,8 +6258,18 @@ extern "C" {
 		host->bandwidthThrottleEpoch = 0;
 		host->recalculateBandwidthLimits = 0;
 		host->preventConnections = 0;
+		host->selectiveAcknowledge = 1;
+		host->acknowledgementDelay = 0;
+		host->acknowledgementThreshold = ENET_PEER_ACKNOWLEDGEMENT_THRESHOLD;
+		host->congestionControl = ENET_CONGESTION_CONTROL_THROTTLE;
 		host->mtu = ENET_HOST_DEFAULT_MTU;
+		host->maximumMtu = 0;
 		host->peerCount = peerCount;
+		host->peerSlotCount = 0;
+		host->peerSlotBytes = 0;
+		host->addressBucketMask = bucketCount - 1;
+		host->addressHashKey[0] = enet_host_random_seed() ^ ((uint64_t)host->randomSeed << 32);
+		host->addressHashKey[1] = (uint64_t)(size_t)host->addressBuckets ^ host->randomSeed;
 		host->commandCount = 0;
 		host->bufferCount = 0;
 		host->checksumCallback = NULL;
@@ -3887,29 +6284,148 @@ extern "C" {
 		host->connectedPeers = 0;
 		host->bandwidthLimitedPeers = 0;
 		host->duplicatePeers = ENET_PROTOCOL_MAXIMUM_PEER_ID;
+		host->connectCookies = 0;
+		host->connectCookieKey[0] = 0;
+		host->connectCookieKey[1] = 0;
+		host->receiveBudget = ENET_HOST_DEFAULT_RECEIVE_BUDGET;
+		host->sendBudget = 0;
+		host->peerDispatchLimit = 0;
 		host->maximumPacketSize = ENET_HOST_DEFAULT_MAXIMUM_PACKET_SIZE;
 		host->maximumWaitingData = ENET_HOST_DEFAULT_MAXIMUM_WAITING_DATA;
 		host->interceptCallback = NULL;
+		host->ioBatchSize = 0;
+		host->ioBatch = NULL;
+		host->udpOffload = ENET_HOST_OFFLOAD_NONE;
+		host->ioRing = NULL;
+		host->backend = ENET_HOST_BACKEND_SOCKET;
+
+		#ifdef ENET_IO_URING
+			if (backend == ENET_HOST_BACKEND_IO_URING_SQPOLL && sysconf(_SC_NPROCESSORS_ONLN) < 2)
+				backend = ENET_HOST_BACKEND_IO_URING;
+		#endif
+
+		if (backend != ENET_HOST_BACKEND_SOCKET)
+			host->ioRing = enet_io_ring_create(host->socket, backend == ENET_HOST_BACKEND_IO_URING_SQPOLL);
+
+		if (host->ioRing != NULL)
+			host->backend = backend;
+		else
+			enet_host_set_io_batch_size(host, ENET_HOST_DEFAULT_IO_BATCH_SIZE);
 
 		enet_list_clear(&host->dispatchQueue);
+		enet_list_clear(&host->deferredDispatchQueue);
+		enet_list_clear(&host->activePeers);
+		enet_list_clear(&host->freePeerSlots[0]);
+		enet_list_clear(&host->freePeerSlots[1]);
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
-			currentPeer->host = host;
-			currentPeer->incomingPeerID = currentPeer - host->peers;
-			currentPeer->outgoingSessionID = currentPeer->incomingSessionID = 0xFF;
-			currentPeer->data = NULL;
-
-			enet_list_clear(&currentPeer->acknowledgements);
-			enet_list_clear(&currentPeer->sentReliableCommands);
-			enet_list_clear(&currentPeer->sentUnreliableCommands);
-			enet_list_clear(&currentPeer->outgoingCommands);
-			enet_list_clear(&currentPeer->dispatchedCommands);
-			enet_peer_reset(currentPeer);
+		for (slot = 0; slot < bucketCount; ++slot) {
+			enet_list_clear(&host->addressBuckets[slot]);
+		}
+
+		host->timerWheelTime = enet_time_get();
+
+		for (level = 0; level < ENET_TIMER_WHEEL_LEVELS; ++level) {
+			for (slot = 0; slot < ENET_TIMER_WHEEL_SLOTS; ++slot) {
+				enet_list_clear(&host->timerWheel[level][slot]);
+			}
 		}
 
 		return host;
 	}
 
+	/* Brings the next unused slot into service, or returns NULL when all peerCount slots are in use or its pages cannot be committed. */
+	ENetPeer* enet_host_grow_peer_slots(ENetHost* host) {
+		ENetPeer* peer;
+		size_t pageSize, usedBytes;
+
+		if (host->peerSlotCount >= host->peerCount)
+			return NULL;
+
+		pageSize = enet_memory_page_size();
+		usedBytes = ((host->peerSlotCount + 1) * sizeof(ENetPeer) + pageSize - 1) & ~(pageSize - 1);
+
+		if (usedBytes > host->peerSlotBytes) {
+			if (enet_memory_commit((uint8_t*)host->peers + host->peerSlotBytes, usedBytes - host->peerSlotBytes) < 0)
+				return NULL;
+
+			host->peerSlotBytes = usedBytes;
+		}
+
+		peer = &host->peers[host->peerSlotCount++];
+
+		memset(peer, 0, sizeof(ENetPeer));
+
+		peer->host = host;
+		peer->incomingPeerID = enet_peer_id_from_index(peer - host->peers);
+		peer->outgoingSessionID = peer->incomingSessionID = 0xFF;
+		peer->data = NULL;
+
+		enet_list_clear(&peer->acknowledgements);
+		enet_list_clear(&peer->sentReliableCommands);
+		enet_list_clear(&peer->sentUnreliableCommands);
+		enet_list_clear(&peer->outgoingCommands);
+		enet_list_clear(&peer->dispatchedCommands);
+		enet_sequence_ring_init(&peer->sentSystemIndex, offsetof(ENetOutgoingCommand, reliableSequenceNumber));
+		peer->sendState = ENET_PEER_SEND_NONE;
+		enet_peer_reset(peer);
+
+		return peer;
+	}
+
+	/*
+	 * Drops trailing disconnected slots and returns their pages once enough have accumulated.
+	 * Run at the start of a service call so a peer returned with a disconnect event stays readable until then.
+	 */
+	void enet_host_trim_peer_slots(ENetHost* host) {
+		size_t pageSize, usedBytes;
+
+		while (host->peerSlotCount > 0 && host->peers[host->peerSlotCount - 1].state == ENET_PEER_STATE_DISCONNECTED) {
+			enet_list_remove(&host->peers[--host->peerSlotCount].slotList);
+		}
+
+		pageSize = enet_memory_page_size();
+		usedBytes = (host->peerSlotCount * sizeof(ENetPeer) + pageSize - 1) & ~(pageSize - 1);
+
+		if (host->peerSlotBytes >= usedBytes + ENET_HOST_PEER_TRIM_THRESHOLD) {
+			enet_memory_discard((uint8_t*)host->peers + usedBytes, host->peerSlotBytes - usedBytes);
+
+			host->peerSlotBytes = usedBytes;
+		}
+	}
+
+	/*
+		Returns a disconnected slot without taking it off the free list, growing the slot range when the list is empty.
+		Peers announcing extended peer ids are given the slots from 0xFFF up first, keeping the low ids for peers that can only address those.
+	*/
+	ENetPeer* enet_host_acquire_peer_slot(ENetHost* host, int extended) {
+		if (extended && !enet_list_empty(&host->freePeerSlots[1]))
+			return enet_peer_from_slot_list(enet_list_front(&host->freePeerSlots[1]));
+
+		if (!enet_list_empty(&host->freePeerSlots[0]))
+			return enet_peer_from_slot_list(enet_list_front(&host->freePeerSlots[0]));
+
+		if (!extended && host->peerSlotCount >= ENET_PROTOCOL_MAXIMUM_PEER_ID)
+			return NULL;
+
+		return enet_host_grow_peer_slots(host);
+	}
+
+	/* Moves a slot that has left the disconnected state, or changed address, into the bucket for its address. */
+	void enet_host_index_peer(ENetHost* host, ENetPeer* peer) {
+		enet_list_remove(&peer->slotList);
+		enet_list_insert(enet_list_end(&host->addressBuckets[enet_host_address_hash(host, &peer->address) & host->addressBucketMask]), &peer->slotList);
+	}
+
+	/* Pushes a slot back on the free list for its id range; a slot fresh from enet_host_grow_peer_slots is on no list yet. */
+	void enet_host_release_peer_slot(ENetHost* host, ENetPeer* peer) {
+		if (peer->state != ENET_PEER_STATE_DISCONNECTED)
+			enet_list_remove(&peer->slotList);
+		else if (peer->slotList.next != NULL)
+			return;
+
+		enet_list_insert(enet_list_begin(&host->freePeerSlots[peer - host->peers >= ENET_PROTOCOL_MAXIMUM_PEER_ID]), &peer->slotList);
+	}
+
 	void enet_host_destroy(ENetHost* host) {
 		ENetPeer* currentPeer;
 
@@ -3918,14 +6434,80 @@ extern "C" {
 
 		enet_socket_destroy(host->socket);
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
+		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerSlotCount]; ++currentPeer) {
 			enet_peer_reset(currentPeer);
 		}
 
-		enet_free(host->peers);
+		if (host->ioBatch != NULL)
+			enet_io_batch_destroy(host->ioBatch);
+
+		if (host->ioRing != NULL)
+			enet_io_ring_destroy(host->ioRing);
+
+		enet_free(host->addressBuckets);
+		enet_memory_release(host->peers, host->peerCount * sizeof(ENetPeer));
 		enet_free(host);
 	}
 
+	static int enet_host_replace_io_batch(ENetHost* host, size_t batchSize, uint32_t offload) {
+		ENetIoBatch* batch = NULL;
+
+		/* The io_uring backend does its own batching. */
+		if (host->ioRing != NULL)
+			return -1;
+
+		if (host->ioBatch != NULL && enet_io_batch_pending(host->ioBatch))
+			return -1;
+
+		if (batchSize > ENET_HOST_MAXIMUM_IO_BATCH_SIZE)
+			batchSize = ENET_HOST_MAXIMUM_IO_BATCH_SIZE;
+
+		if (batchSize > 1) {
+			batch = enet_io_batch_create(batchSize, offload);
+
+			if (batch == NULL)
+				return -1;
+		}
+
+		if (host->ioBatch != NULL) {
+			enet_io_batch_flush(host->socket, host->ioBatch);
+			enet_io_batch_destroy(host->ioBatch);
+		}
+
+		/* Without a batch there is no buffer large enough for coalesced datagrams. */
+		if (batch == NULL && (host->udpOffload & ENET_HOST_OFFLOAD_GRO))
+			enet_io_batch_probe_offload(host->socket, ENET_HOST_OFFLOAD_NONE);
+
+		host->ioBatch = batch;
+		host->ioBatchSize = batch != NULL ? batchSize : 0;
+		host->udpOffload = batch != NULL ? offload : ENET_HOST_OFFLOAD_NONE;
+
+		return 0;
+	}
+
+	/* Batch sizes of 0 or 1 fall back to one syscall per datagram. Fails while received datagrams are still pending. */
+	int enet_host_set_io_batch_size(ENetHost* host, size_t batchSize) {
+		if (host == NULL)
+			return -1;
+
+		return enet_host_replace_io_batch(host, batchSize, enet_host_get_udp_offload(host));
+	}
+
+	/* Offloads ride on the I/O batch, so a host without one gets none. Returns the offloads actually enabled after probing the socket. */
+	uint32_t enet_host_set_udp_offload(ENetHost* host, uint32_t offload) {
+		uint32_t supported;
+
+		if (host == NULL || host->ioBatch == NULL)
+			return ENET_HOST_OFFLOAD_NONE;
+
+		supported = enet_io_batch_probe_offload(host->socket, offload & (ENET_HOST_OFFLOAD_GSO | ENET_HOST_OFFLOAD_GRO));
+
+		if (supported != host->udpOffload && enet_host_replace_io_batch(host, host->ioBatchSize, supported) < 0)
+			enet_io_batch_probe_offload(host->socket, host->udpOffload);
+
+		return host->udpOffload;
+	}
+
 	void enet_host_prevent_connections(ENetHost* host, uint8_t state) {
 		if (host == NULL)
 			return;
@@ -3933,6 +6515,89 @@ extern "C" {
 		host->preventConnections = state;
 	}
 
+	/* Only affects connections made after the call; both ends must enable it for a connection to use it. */
+	void enet_host_selective_acknowledge(ENetHost* host, uint8_t state) {
+		if (host == NULL)
+			return;
+
+		host->selectiveAcknowledge = state;
+	}
+
+	/*
+		Holds acknowledgements to peers using selective acknowledgement for up to delay milliseconds, or until threshold of them are pending, unless data is sent to the peer first.
+		A delay of 0 acknowledges every command on the next send pass. The hold time is reported to the sender, so its round trip time excludes it.
+	*/
+	void enet_host_acknowledgement_delay(ENetHost* host, uint32_t delay, uint32_t threshold) {
+		if (host == NULL)
+			return;
+
+		host->acknowledgementDelay = ENET_MIN(delay, ENET_PEER_ACKNOWLEDGEMENT_DELAY_LIMIT);
+		host->acknowledgementThreshold = threshold ? threshold : ENET_PEER_ACKNOWLEDGEMENT_THRESHOLD;
+	}
+
+	/*
+		Bounds the work of one service iteration: datagrams read per receive pass, datagrams sent per send pass, and receive events one peer is handed before every other queued peer has had a turn and the host has serviced its socket again.
+		Zero lifts a bound; hosts start with a receive budget of ENET_HOST_DEFAULT_RECEIVE_BUDGET and no others.
+	*/
+	void enet_host_service_budget(ENetHost* host, uint32_t receiveBudget, uint32_t sendBudget, uint32_t peerDispatchLimit) {
+		if (host == NULL)
+			return;
+
+		host->receiveBudget = receiveBudget;
+		host->sendBudget = sendBudget;
+		host->peerDispatchLimit = peerDispatchLimit;
+	}
+
+	/*
+		Selects how peers of the host are kept from overrunning the path; choose before peers connect.
+		ENET_CONGESTION_CONTROL_THROTTLE drops unreliable packets as the round trip time rises, and ENET_CONGESTION_CONTROL_DELAY paces all data at a send rate tuned to keep queueing delay low.
+	*/
+	void enet_host_congestion_control(ENetHost* host, ENetCongestionControl control) {
+		if (host == NULL)
+			return;
+
+		host->congestionControl = control;
+	}
+
+	/*
+		Enables probing each peer's path for the largest datagram it carries whole, up to maximumMtu, or disables it with 0; enable before peers connect.
+		Peers connected while it is on start at the minimum MTU and grow as probes are confirmed; the remote host only needs to echo probes, which any host of this version does.
+	*/
+	void enet_host_mtu_discovery(ENetHost* host, uint32_t maximumMtu) {
+		if (host == NULL)
+			return;
+
+		if (maximumMtu != 0)
+			maximumMtu = ENET_MIN(ENET_MAX(maximumMtu, ENET_PROTOCOL_MINIMUM_MTU), ENET_PROTOCOL_MAXIMUM_MTU);
+
+		if (host->maximumMtu == maximumMtu)
+			return;
+
+		if ((host->maximumMtu == 0) != (maximumMtu == 0))
+			enet_socket_set_option(host->socket, ENET_SOCKOPT_DONTFRAGMENT, maximumMtu != 0);
+
+		host->maximumMtu = maximumMtu;
+	}
+
+	/*
+		Requires connecting clients to echo a cookie keyed by the 16-byte secret before a peer slot is committed for them, or stops requiring it with NULL.
+		Clients of earlier versions cannot answer the challenge; the secret should come from a cryptographic random source and be kept private.
+	*/
+	void enet_host_connect_cookies(ENetHost* host, const uint8_t* secret) {
+		int index;
+
+		if (host == NULL)
+			return;
+
+		host->connectCookies = secret != NULL;
+		host->connectCookieKey[0] = 0;
+		host->connectCookieKey[1] = 0;
+
+		for (index = 0; secret != NULL && index < 16; ++index) {
+			host->connectCookieKey[index / 8] |= (uint64_t)secret[index] << (8 * (index % 8));
+		}
+	}
+
 	ENetPeer* enet_host_connect(ENetHost* host, const ENetAddress* address, size_t channelCount, uint32_t data) {
 		ENetPeer* currentPeer;
 		ENetChannel* channel;
@@ -3943,12 +6608,10 @@ extern "C" {
 		else if (channelCount > ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT)
 			channelCount = ENET_PROTOCOL_MAXIMUM_CHANNEL_COUNT;
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
-			if (currentPeer->state == ENET_PEER_STATE_DISCONNECTED)
-				break;
-		}
+		/* The remote may not understand extended peer ids, so outgoing connections use the low slots. */
+		currentPeer = enet_host_acquire_peer_slot(host, 0);
 
-		if (currentPeer >= &host->peers[host->peerCount])
+		if (currentPeer == NULL)
 			return NULL;
 
 		currentPeer->channels = (ENetChannel*)enet_malloc(channelCount * sizeof(ENetChannel));
@@ -3961,6 +6624,8 @@ extern "C" {
 		currentPeer->address = *address;
 		currentPeer->connectID = ++host->randomSeed;
 
+		enet_host_index_peer(host, currentPeer);
+
 		if (host->outgoingBandwidth == 0)
 			currentPeer->windowSize = ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE;
 		else
@@ -3976,16 +6641,26 @@ extern "C" {
 			channel->outgoingUnreliableSequenceNumber = 0;
 			channel->incomingReliableSequenceNumber = 0;
 			channel->incomingUnreliableSequenceNumber = 0;
+			channel->acknowledgedReliableSequenceNumber = 0;
 
 			enet_list_clear(&channel->incomingReliableCommands);
 			enet_list_clear(&channel->incomingUnreliableCommands);
+			enet_sequence_ring_init(&channel->incomingReliableIndex, offsetof(ENetIncomingCommand, reliableSequenceNumber));
+			enet_sequence_ring_init(&channel->sentReliableIndex, offsetof(ENetOutgoingCommand, reliableSequenceNumber));
 
 			channel->usedReliableWindows = 0;
+			channel->parity = 0;
+			channel->outgoingParity = NULL;
+			channel->incomingParity = NULL;
 
 			memset(channel->reliableWindows, 0, sizeof(channel->reliableWindows));
 		}
 
-		command.header.command = ENET_PROTOCOL_COMMAND_CONNECT | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE;
+		command.header.command = ENET_PROTOCOL_COMMAND_CONNECT | ENET_PROTOCOL_COMMAND_FLAG_ACKNOWLEDGE | ENET_PROTOCOL_COMMAND_FLAG_EXTENDED_PEER_ID;
+
+		if (host->selectiveAcknowledge)
+			command.header.command |= ENET_PROTOCOL_COMMAND_FLAG_SELECTIVE_ACKNOWLEDGE;
+
 		command.header.channelID = 0xFF;
 		command.connect.outgoingPeerID = ENET_HOST_TO_NET_16(currentPeer->incomingPeerID);
 		command.connect.incomingSessionID = currentPeer->incomingSessionID;
@@ -4012,7 +6687,7 @@ extern "C" {
 		if (packet->flags & ENET_PACKET_FLAG_INSTANT)
 			++packet->referenceCount;
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
+		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerSlotCount]; ++currentPeer) {
 			if (currentPeer->state != ENET_PEER_STATE_CONNECTED)
 				continue;
 
@@ -4032,7 +6707,7 @@ extern "C" {
 		if (packet->flags & ENET_PACKET_FLAG_INSTANT)
 			++packet->referenceCount;
 
-		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerCount]; ++currentPeer) {
+		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerSlotCount]; ++currentPeer) {
 			if (currentPeer->state != ENET_PEER_STATE_CONNECTED || currentPeer == excludedPeer)
 				continue;
 
@@ -4115,7 +6790,7 @@ extern "C" {
 			dataTotal = 0;
 			bandwidth = (host->outgoingBandwidth * elapsedTime) / 1000;
 
-			for (peer = host->peers; peer < &host->peers[host->peerCount]; ++peer) {
+			for (peer = host->peers; peer < &host->peers[host->peerSlotCount]; ++peer) {
 				if (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER)
 					continue;
 
@@ -4131,7 +6806,7 @@ extern "C" {
 			else
 				throttle = (bandwidth * ENET_PEER_PACKET_THROTTLE_SCALE) / dataTotal;
 
-			for (peer = host->peers; peer < &host->peers[host->peerCount]; ++peer) {
+			for (peer = host->peers; peer < &host->peers[host->peerSlotCount]; ++peer) {
 				uint32_t peerBandwidth;
 
 				if ((peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER) || peer->incomingBandwidth == 0 || peer->outgoingBandwidthThrottleEpoch == timeCurrent)
@@ -4166,7 +6841,7 @@ extern "C" {
 			else
 				throttle = (bandwidth * ENET_PEER_PACKET_THROTTLE_SCALE) / dataTotal;
 
-			for (peer = host->peers; peer < &host->peers[host->peerCount]; ++peer) {
+			for (peer = host->peers; peer < &host->peers[host->peerSlotCount]; ++peer) {
 				if ((peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER) || peer->outgoingBandwidthThrottleEpoch == timeCurrent)
 					continue;
 
@@ -4193,7 +6868,7 @@ extern "C" {
 					needsAdjustment = 0;
 					bandwidthLimit = bandwidth / peersRemaining;
 
-					for (peer = host->peers; peer < &host->peers[host->peerCount]; ++peer) {
+					for (peer = host->peers; peer < &host->peers[host->peerSlotCount]; ++peer) {
 						if ((peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER) || peer->incomingBandwidthThrottleEpoch == timeCurrent)
 							continue;
 
@@ -4208,7 +6883,7 @@ extern "C" {
 				}
 			}
 
-			for (peer = host->peers; peer < &host->peers[host->peerCount]; ++peer) {
+			for (peer = host->peers; peer < &host->peers[host->peerSlotCount]; ++peer) {
 				if (peer->state != ENET_PEER_STATE_CONNECTED && peer->state != ENET_PEER_STATE_DISCONNECT_LATER)
 					continue;
 
@@ -4340,6 +7015,8 @@ extern "C" {
 
 	#ifndef _WIN32
 		int enet_initialize(void) {
+			enet_crc64_initialize();
+
 			return 0;
 		}
 
@@ -4353,6 +7030,38 @@ extern "C" {
 			return (timeVal.tv_sec * 1000) ^ (timeVal.tv_usec / 1000);
 		}
 
+		size_t enet_memory_page_size(void) {
+			static size_t pageSize = 0;
+
+			if (pageSize == 0)
+				pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+			return pageSize;
+		}
+
+		/* Anonymous pages read as zero and are only backed once written. */
+		void* enet_memory_reserve(size_t size) {
+			void* memory = mmap(NULL, size > 0 ? size : 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+			return memory != MAP_FAILED ? memory : NULL;
+		}
+
+		/* Reserved pages are already writable and backed on first write. */
+		int enet_memory_commit(void* memory, size_t size) {
+			(void)memory;
+			(void)size;
+
+			return 0;
+		}
+
+		void enet_memory_discard(void* memory, size_t size) {
+			madvise(memory, size, MADV_DONTNEED);
+		}
+
+		void enet_memory_release(void* memory, size_t size) {
+			munmap(memory, size > 0 ? size : 1);
+		}
+
 		int enet_socket_bind(ENetSocket socket, const ENetAddress* address) {
 			struct sockaddr_in6 sin;
 
@@ -4410,199 +7119,1133 @@ extern "C" {
 			return socket(PF_INET6, socketType, 0);
 		}
 
-		int enet_socket_set_option(ENetSocket socket, ENetSocketOption option, int value) {
-			int result = -1;
+		int enet_socket_set_option(ENetSocket socket, ENetSocketOption option, int value) {
+			int result = -1;
+
+			switch (option) {
+				case ENET_SOCKOPT_NONBLOCK:
+					result = fcntl(socket, F_SETFL, (value ? O_NONBLOCK : 0) | (fcntl(socket, F_GETFL) & ~O_NONBLOCK));
+
+					break;
+
+				case ENET_SOCKOPT_BROADCAST:
+					result = setsockopt(socket, SOL_SOCKET, SO_BROADCAST, (char*)&value, sizeof(int));
+
+					break;
+
+				case ENET_SOCKOPT_REUSEADDR:
+					result = setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, (char*)&value, sizeof(int));
+
+					break;
+
+				case ENET_SOCKOPT_RCVBUF:
+					result = setsockopt(socket, SOL_SOCKET, SO_RCVBUF, (char*)&value, sizeof(int));
+
+					break;
+
+				case ENET_SOCKOPT_SNDBUF:
+					result = setsockopt(socket, SOL_SOCKET, SO_SNDBUF, (char*)&value, sizeof(int));
+
+					break;
+
+				case ENET_SOCKOPT_RCVTIMEO: {
+					struct timeval timeVal;
+
+					timeVal.tv_sec = value / 1000;
+					timeVal.tv_usec = (value % 1000) * 1000;
+					result = setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeVal, sizeof(struct timeval));
+
+					break;
+				}
+
+				case ENET_SOCKOPT_SNDTIMEO: {
+					struct timeval timeVal;
+
+					timeVal.tv_sec = value / 1000;
+					timeVal.tv_usec = (value % 1000) * 1000;
+					result = setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeVal, sizeof(struct timeval));
+
+					break;
+				}
+
+				case ENET_SOCKOPT_NODELAY:
+					result = setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (char*)&value, sizeof(int));
+
+					break;
+
+				case ENET_SOCKOPT_IPV6_V6ONLY:
+					result = setsockopt(socket, IPPROTO_IPV6, IPV6_V6ONLY, (char*)&value, sizeof(int));
+
+					break;
+
+				/* Covers IPv4-mapped destinations too, which a dual-stack socket sends as IPv4. */
+				case ENET_SOCKOPT_DONTFRAGMENT: {
+					result = 0;
+
+					#ifdef IPV6_DONTFRAG
+						result = setsockopt(socket, IPPROTO_IPV6, IPV6_DONTFRAG, (char*)&value, sizeof(int));
+					#endif
+
+					#ifdef IP_MTU_DISCOVER
+						int discover = value ? IP_PMTUDISC_DO : IP_PMTUDISC_WANT;
+
+						if (result != -1)
+							result = setsockopt(socket, IPPROTO_IP, IP_MTU_DISCOVER, (char*)&discover, sizeof(int));
+					#elif defined(IP_DONTFRAG)
+						if (result != -1)
+							result = setsockopt(socket, IPPROTO_IP, IP_DONTFRAG, (char*)&value, sizeof(int));
+					#endif
+
+					break;
+				}
+
+				default:
+					break;
+			}
+
+			return result == -1 ? -1 : 0;
+		}
+
+		int enet_socket_get_option(ENetSocket socket, ENetSocketOption option, int* value) {
+			int result = -1;
+			socklen_t len;
+
+			switch (option) {
+				case ENET_SOCKOPT_ERROR:
+					len = sizeof(int);
+					result = getsockopt(socket, SOL_SOCKET, SO_ERROR, value, &len);
+
+					break;
+
+				default:
+					break;
+			}
+
+			return result == -1 ? -1 : 0;
+		}
+
+		int enet_socket_connect(ENetSocket socket, const ENetAddress* address) {
+			int result = -1;
+			struct sockaddr_in6 sin;
+
+			memset(&sin, 0, sizeof(struct sockaddr_in6));
+
+			sin.sin6_family = AF_INET6;
+			sin.sin6_port = ENET_HOST_TO_NET_16(address->port);
+			sin.sin6_addr = address->ipv6;
+
+			result = connect(socket, (struct sockaddr*)&sin, sizeof(struct sockaddr_in6));
+
+			if (result == -1 && errno == EINPROGRESS)
+				return 0;
+
+			return result;
+		}
+
+		ENetSocket enet_socket_accept(ENetSocket socket, ENetAddress* address) {
+			int result = -1;
+			struct sockaddr_in6 sin;
+			socklen_t sinLength = sizeof(struct sockaddr_in6);
+
+			result = accept(socket, address != NULL ? (struct sockaddr*)&sin : NULL, address != NULL ? &sinLength : NULL);
+
+			if (result == -1)
+				return ENET_SOCKET_NULL;
+
+			if (address != NULL) {
+				address->ipv6 = sin.sin6_addr;
+				address->port = ENET_NET_TO_HOST_16(sin.sin6_port);
+			}
+
+			return result;
+		}
+
+		int enet_socket_shutdown(ENetSocket socket, ENetSocketShutdown how) {
+			return shutdown(socket, (int)how);
+		}
+
+		void enet_socket_destroy(ENetSocket socket) {
+			if (socket != ENET_SOCKET_NULL)
+				close(socket);
+		}
+
+		int enet_socket_send(ENetSocket socket, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+			struct msghdr msgHdr;
+			struct sockaddr_in6 sin;
+			int sentLength;
+
+			memset(&msgHdr, 0, sizeof(struct msghdr));
+
+			if (address != NULL) {
+				memset(&sin, 0, sizeof(struct sockaddr_in6));
+
+				sin.sin6_family = AF_INET6;
+				sin.sin6_port = ENET_HOST_TO_NET_16(address->port);
+				sin.sin6_addr = address->ipv6;
+				msgHdr.msg_name = &sin;
+				msgHdr.msg_namelen = sizeof(struct sockaddr_in6);
+			}
+
+			msgHdr.msg_iov = (struct iovec*)buffers;
+			msgHdr.msg_iovlen = bufferCount;
+			sentLength = sendmsg(socket, &msgHdr, MSG_NOSIGNAL);
+
+			if (sentLength == -1) {
+				if (errno == EWOULDBLOCK)
+					return 0;
+
+				return -1;
+			}
+
+			return sentLength;
+		}
+
+		int enet_socket_message_too_large(void) {
+			return errno == EMSGSIZE;
+		}
+
+		int enet_socket_receive(ENetSocket socket, ENetAddress* address, ENetBuffer* buffers, size_t bufferCount) {
+			struct msghdr msgHdr;
+			struct sockaddr_in6 sin;
+			int recvLength;
+
+			memset(&msgHdr, 0, sizeof(struct msghdr));
+
+			if (address != NULL) {
+				msgHdr.msg_name = &sin;
+				msgHdr.msg_namelen = sizeof(struct sockaddr_in6);
+			}
+
+			msgHdr.msg_iov = (struct iovec*)buffers;
+			msgHdr.msg_iovlen = bufferCount;
+			recvLength = recvmsg(socket, &msgHdr, MSG_NOSIGNAL);
+
+			if (recvLength == -1) {
+				if (errno == EWOULDBLOCK)
+					return 0;
+
+				return -1;
+			}
+
+			if (msgHdr.msg_flags & MSG_TRUNC)
+				return -2;
+
+			if (address != NULL) {
+				address->ipv6 = sin.sin6_addr;
+				address->port = ENET_NET_TO_HOST_16(sin.sin6_port);
+			}
+
+			return recvLength;
+		}
+
+		#ifdef ENET_MMSG
+			struct _ENetIoBatch {
+				size_t capacity;
+				uint32_t offload;
+				size_t receiveSlotSize;
+				size_t receiveCount;
+				size_t receiveIndex;
+				size_t receiveOffset;
+				size_t receiveSegmentSize;
+				size_t sendCount;
+				size_t sendOffset;
+				struct mmsghdr* receiveMessages;
+				struct mmsghdr* sendMessages;
+				struct mmsghdr* segmentMessages;
+				struct iovec* receiveVectors;
+				struct iovec* sendVectors;
+				struct iovec* segmentVectors;
+				struct sockaddr_in6* receiveAddresses;
+				struct sockaddr_in6* sendAddresses;
+				size_t* segmentFirst;
+				size_t* segmentMembers;
+				uint8_t* sendGrouped;
+				uint8_t* receiveControl;
+				uint8_t* segmentControl;
+				uint8_t* receiveData;
+				uint8_t* sendData;
+			};
+
+			#define ENET_IO_BATCH_CONTROL_SIZE CMSG_SPACE(sizeof(int))
+
+			ENetIoBatch* enet_io_batch_create(size_t capacity, uint32_t offload) {
+				ENetIoBatch* batch;
+				size_t receiveSlotSize = (offload & ENET_HOST_OFFLOAD_GRO) ? ENET_IO_BATCH_GRO_BUFFER_SIZE : ENET_PROTOCOL_MAXIMUM_MTU;
+				size_t i;
+
+				batch = (ENetIoBatch*)enet_malloc(sizeof(ENetIoBatch) + capacity * (3 * sizeof(struct mmsghdr) + 3 * sizeof(struct iovec) + 2 * sizeof(struct sockaddr_in6) + 2 * sizeof(size_t) + sizeof(uint8_t) + 2 * ENET_IO_BATCH_CONTROL_SIZE + receiveSlotSize + ENET_PROTOCOL_MAXIMUM_MTU));
+
+				if (batch == NULL)
+					return NULL;
+
+				memset(batch, 0, sizeof(ENetIoBatch));
+
+				batch->capacity = capacity;
+				batch->offload = offload;
+				batch->receiveSlotSize = receiveSlotSize;
+				batch->receiveMessages = (struct mmsghdr*)(batch + 1);
+				batch->sendMessages = batch->receiveMessages + capacity;
+				batch->segmentMessages = batch->sendMessages + capacity;
+				batch->receiveVectors = (struct iovec*)(batch->segmentMessages + capacity);
+				batch->sendVectors = batch->receiveVectors + capacity;
+				batch->segmentVectors = batch->sendVectors + capacity;
+				batch->receiveAddresses = (struct sockaddr_in6*)(batch->segmentVectors + capacity);
+				batch->sendAddresses = batch->receiveAddresses + capacity;
+				batch->segmentFirst = (size_t*)(batch->sendAddresses + capacity);
+				batch->segmentMembers = batch->segmentFirst + capacity;
+				batch->sendGrouped = (uint8_t*)(batch->segmentMembers + capacity);
+				batch->receiveControl = batch->sendGrouped + capacity;
+				batch->segmentControl = batch->receiveControl + capacity * ENET_IO_BATCH_CONTROL_SIZE;
+				batch->receiveData = batch->segmentControl + capacity * ENET_IO_BATCH_CONTROL_SIZE;
+				batch->sendData = batch->receiveData + capacity * receiveSlotSize;
+
+				memset(batch->receiveMessages, 0, 3 * capacity * sizeof(struct mmsghdr));
+
+				for (i = 0; i < capacity; ++i) {
+					batch->receiveVectors[i].iov_base = batch->receiveData + i * receiveSlotSize;
+					batch->receiveMessages[i].msg_hdr.msg_name = &batch->receiveAddresses[i];
+					batch->receiveMessages[i].msg_hdr.msg_iov = &batch->receiveVectors[i];
+					batch->receiveMessages[i].msg_hdr.msg_iovlen = 1;
+
+					batch->sendMessages[i].msg_hdr.msg_name = &batch->sendAddresses[i];
+					batch->sendMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+					batch->sendMessages[i].msg_hdr.msg_iov = &batch->sendVectors[i];
+					batch->sendMessages[i].msg_hdr.msg_iovlen = 1;
+				}
+
+				return batch;
+			}
+
+			void enet_io_batch_destroy(ENetIoBatch* batch) {
+				enet_free(batch);
+			}
+
+			int enet_io_batch_pending(const ENetIoBatch* batch) {
+				return batch->receiveIndex < batch->receiveCount;
+			}
+
+			/* Reports which of the requested offloads the kernel accepts. UDP_GRO is switched on or off to match the request. */
+			uint32_t enet_io_batch_probe_offload(ENetSocket socket, uint32_t offload) {
+				uint32_t supported = 0;
+				int value = 0;
+				socklen_t length = sizeof(int);
+
+				if ((offload & ENET_HOST_OFFLOAD_GSO) && getsockopt(socket, SOL_UDP, UDP_SEGMENT, (char*)&value, &length) == 0)
+					supported |= ENET_HOST_OFFLOAD_GSO;
+
+				value = (offload & ENET_HOST_OFFLOAD_GRO) ? 1 : 0;
+
+				if (setsockopt(socket, SOL_UDP, UDP_GRO, (char*)&value, sizeof(int)) == 0 && value != 0)
+					supported |= ENET_HOST_OFFLOAD_GRO;
+
+				return supported;
+			}
+
+			/* Hands out one datagram per call, refilling the batch with a single recvmmsg once it is drained. A GRO buffer is split back into its segments. */
+			int enet_io_batch_receive(ENetSocket socket, ENetIoBatch* batch, size_t mtu, ENetAddress* address, uint8_t** data) {
+				struct mmsghdr* message;
+				struct sockaddr_in6* sin;
+				size_t length;
+
+				if (batch->receiveIndex >= batch->receiveCount) {
+					int receivedCount;
+					size_t i;
+
+					batch->receiveIndex = 0;
+					batch->receiveOffset = 0;
+					batch->receiveCount = 0;
+
+					for (i = 0; i < batch->capacity; ++i) {
+						batch->receiveVectors[i].iov_len = (batch->offload & ENET_HOST_OFFLOAD_GRO) ? batch->receiveSlotSize : mtu;
+						batch->receiveMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+						batch->receiveMessages[i].msg_hdr.msg_flags = 0;
+
+						if (batch->offload & ENET_HOST_OFFLOAD_GRO) {
+							batch->receiveMessages[i].msg_hdr.msg_control = batch->receiveControl + i * ENET_IO_BATCH_CONTROL_SIZE;
+							batch->receiveMessages[i].msg_hdr.msg_controllen = ENET_IO_BATCH_CONTROL_SIZE;
+						}
+					}
+
+					receivedCount = recvmmsg(socket, batch->receiveMessages, (unsigned int)batch->capacity, MSG_NOSIGNAL, NULL);
+
+					if (receivedCount == -1) {
+						if (errno == EWOULDBLOCK)
+							return 0;
+
+						return -1;
+					}
+
+					if (receivedCount == 0)
+						return 0;
+
+					batch->receiveCount = (size_t)receivedCount;
+				}
+
+				message = &batch->receiveMessages[batch->receiveIndex];
+
+				if (message->msg_hdr.msg_flags & MSG_TRUNC) {
+					batch->receiveIndex++;
+
+					return -2;
+				}
+
+				if (batch->receiveOffset == 0) {
+					struct cmsghdr* control;
+
+					batch->receiveSegmentSize = message->msg_len;
+
+					for (control = CMSG_FIRSTHDR(&message->msg_hdr); control != NULL; control = CMSG_NXTHDR(&message->msg_hdr, control)) {
+						if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+							int segmentSize;
+
+							memcpy(&segmentSize, CMSG_DATA(control), sizeof(int));
+
+							if (segmentSize > 0)
+								batch->receiveSegmentSize = (size_t)segmentSize;
+						}
+					}
+				}
+
+				*data = batch->receiveData + batch->receiveIndex * batch->receiveSlotSize + batch->receiveOffset;
+				length = message->msg_len - batch->receiveOffset;
+
+				if (length > batch->receiveSegmentSize)
+					length = batch->receiveSegmentSize;
+
+				batch->receiveOffset += length;
+
+				if (batch->receiveOffset >= message->msg_len) {
+					batch->receiveIndex++;
+					batch->receiveOffset = 0;
+				}
+
+				if (length > mtu)
+					return -2;
+
+				sin = (struct sockaddr_in6*)message->msg_hdr.msg_name;
+				address->ipv6 = sin->sin6_addr;
+				address->port = ENET_NET_TO_HOST_16(sin->sin6_port);
+
+				return (int)length;
+			}
+
+			/* Copies the datagram into the batch; it goes out with the next sendmmsg. */
+			int enet_io_batch_send(ENetSocket socket, ENetIoBatch* batch, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+				struct sockaddr_in6* sin;
+				uint8_t* data;
+				size_t length = 0;
+				size_t i;
+
+				for (i = 0; i < bufferCount; ++i) {
+					length += buffers[i].dataLength;
+				}
+
+				if (length > ENET_PROTOCOL_MAXIMUM_MTU) {
+					if (enet_io_batch_flush(socket, batch) < 0)
+						return -1;
+
+					return enet_socket_send(socket, address, buffers, bufferCount);
+				}
+
+				if (batch->sendCount >= batch->capacity && enet_io_batch_flush(socket, batch) < 0)
+					return -1;
+
+				data = batch->sendData + batch->sendOffset;
+				batch->sendVectors[batch->sendCount].iov_base = data;
+				batch->sendVectors[batch->sendCount].iov_len = length;
+
+				for (i = 0; i < bufferCount; ++i) {
+					memcpy(data, buffers[i].data, buffers[i].dataLength);
+					data += buffers[i].dataLength;
+				}
+
+				sin = &batch->sendAddresses[batch->sendCount];
+				memset(sin, 0, sizeof(struct sockaddr_in6));
+				sin->sin6_family = AF_INET6;
+				sin->sin6_addr = address->ipv6;
+				sin->sin6_port = ENET_HOST_TO_NET_16(address->port);
+
+				batch->sendOffset += length;
+				batch->sendCount++;
+
+				return (int)length;
+			}
+
+			static int enet_io_batch_send_messages(ENetSocket socket, struct mmsghdr* messages, size_t count) {
+				size_t sent = 0;
+				int result = 0;
+
+				while (sent < count) {
+					int sentCount = sendmmsg(socket, &messages[sent], (unsigned int)(count - sent), MSG_NOSIGNAL);
+
+					if (sentCount < 0) {
+						if (errno == EWOULDBLOCK)
+							break;
+
+						/* A datagram larger than the path is skipped; black hole detection picks up the loss. */
+						if (errno != EMSGSIZE)
+							result = -1;
+
+						sentCount = 1;
+					}
+
+					sent += (size_t)sentCount;
+				}
+
+				return result;
+			}
+
+			/* Gathers queued datagrams for the same address into UDP_SEGMENT messages. Every segment but the last must be full-sized, and per-address order is kept. */
+			static size_t enet_io_batch_build_segments(ENetIoBatch* batch) {
+				size_t segmentCount = 0;
+				size_t vectorCount = 0;
+				size_t i, j;
+
+				memset(batch->sendGrouped, 0, batch->sendCount);
+
+				for (i = 0; i < batch->sendCount; ++i) {
+					struct mmsghdr* message;
+					size_t segmentSize, totalLength, vectors;
+
+					if (batch->sendGrouped[i])
+						continue;
+
+					message = &batch->segmentMessages[segmentCount];
+					segmentSize = batch->sendVectors[i].iov_len;
+					totalLength = segmentSize;
+					vectors = 1;
+
+					batch->segmentVectors[vectorCount] = batch->sendVectors[i];
+					batch->segmentMembers[vectorCount] = i;
+					batch->sendGrouped[i] = 1;
+
+					for (j = i + 1; j < batch->sendCount && batch->segmentVectors[vectorCount + vectors - 1].iov_len == segmentSize; ++j) {
+						if (batch->sendGrouped[j] || memcmp(&batch->sendAddresses[i], &batch->sendAddresses[j], sizeof(struct sockaddr_in6)) != 0)
+							continue;
+
+						if (batch->sendVectors[j].iov_len > segmentSize || vectors >= ENET_IO_BATCH_GSO_MAXIMUM_SEGMENTS || totalLength + batch->sendVectors[j].iov_len > ENET_IO_BATCH_GSO_MAXIMUM_SIZE)
+							break;
+
+						batch->segmentVectors[vectorCount + vectors] = batch->sendVectors[j];
+						batch->segmentMembers[vectorCount + vectors] = j;
+						batch->sendGrouped[j] = 1;
+						totalLength += batch->sendVectors[j].iov_len;
+						vectors++;
+					}
+
+					memset(message, 0, sizeof(struct mmsghdr));
+					message->msg_hdr.msg_name = &batch->sendAddresses[i];
+					message->msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+					message->msg_hdr.msg_iov = &batch->segmentVectors[vectorCount];
+					message->msg_hdr.msg_iovlen = vectors;
+
+					if (vectors > 1) {
+						struct cmsghdr* control;
+						uint16_t size = (uint16_t)segmentSize;
+
+						message->msg_hdr.msg_control = batch->segmentControl + segmentCount * ENET_IO_BATCH_CONTROL_SIZE;
+						message->msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+						control = CMSG_FIRSTHDR(&message->msg_hdr);
+						control->cmsg_level = SOL_UDP;
+						control->cmsg_type = UDP_SEGMENT;
+						control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+						memcpy(CMSG_DATA(control), &size, sizeof(uint16_t));
+					}
+
+					batch->segmentFirst[segmentCount] = vectorCount;
+					vectorCount += vectors;
+					segmentCount++;
+				}
+
+				return segmentCount;
+			}
+
+			/* Datagrams that would block are dropped, as with enet_socket_send. A hard error skips that datagram and is reported once the rest are sent. */
+			int enet_io_batch_flush(ENetSocket socket, ENetIoBatch* batch) {
+				int result = 0;
+
+				if (batch->sendCount == 0)
+					return 0;
+
+				if (batch->offload & ENET_HOST_OFFLOAD_GSO) {
+					size_t segmentCount = enet_io_batch_build_segments(batch);
+					size_t sent = 0;
+					size_t fallback = 0;
+
+					while (sent < segmentCount) {
+						int sentCount = sendmmsg(socket, &batch->segmentMessages[sent], (unsigned int)(segmentCount - sent), MSG_NOSIGNAL);
+
+						if (sentCount < 0) {
+							if (errno == EWOULDBLOCK)
+								break;
+
+							/* The device or route refused segmentation; send the rest one datagram at a time from now on. */
+							if (batch->segmentMessages[sent].msg_hdr.msg_iovlen > 1 && (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP)) {
+								size_t first = batch->segmentFirst[sent];
+
+								batch->offload &= ~ENET_HOST_OFFLOAD_GSO;
+
+								for (fallback = 0; first + fallback < batch->sendCount; ++fallback) {
+									batch->segmentMessages[fallback] = batch->sendMessages[batch->segmentMembers[first + fallback]];
+								}
+
+								break;
+							}
+
+							if (errno != EMSGSIZE)
+								result = -1;
+
+							sentCount = 1;
+						}
+
+						sent += (size_t)sentCount;
+					}
+
+					if (fallback > 0 && enet_io_batch_send_messages(socket, batch->segmentMessages, fallback) < 0)
+						result = -1;
+				} else {
+					result = enet_io_batch_send_messages(socket, batch->sendMessages, batch->sendCount);
+				}
+
+				batch->sendCount = 0;
+				batch->sendOffset = 0;
+
+				return result;
+			}
+
+			uint32_t enet_io_batch_get_offload(const ENetIoBatch* batch) {
+				return batch->offload;
+			}
+		#else
+			ENetIoBatch* enet_io_batch_create(size_t capacity, uint32_t offload) {
+				return NULL;
+			}
+
+			void enet_io_batch_destroy(ENetIoBatch* batch) { }
+
+			int enet_io_batch_pending(const ENetIoBatch* batch) {
+				return 0;
+			}
+
+			uint32_t enet_io_batch_probe_offload(ENetSocket socket, uint32_t offload) {
+				return 0;
+			}
+
+			uint32_t enet_io_batch_get_offload(const ENetIoBatch* batch) {
+				return 0;
+			}
+
+			int enet_io_batch_receive(ENetSocket socket, ENetIoBatch* batch, size_t mtu, ENetAddress* address, uint8_t** data) {
+				return -1;
+			}
+
+			int enet_io_batch_send(ENetSocket socket, ENetIoBatch* batch, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+				return -1;
+			}
+
+			int enet_io_batch_flush(ENetSocket socket, ENetIoBatch* batch) {
+				return -1;
+			}
+		#endif
+
+		#ifdef ENET_IO_URING
+			typedef struct _ENetIoRingCompletion {
+				int32_t result;
+				uint32_t flags;
+			} ENetIoRingCompletion;
+
+			struct _ENetIoRing {
+				int ringFd;
+				int sqPoll;
+				int receiveArmed;
+				int heldBuffer;
+				void* sqRing;
+				void* cqRing;
+				size_t sqRingSize;
+				size_t cqRingSize;
+				struct io_uring_sqe* sqes;
+				size_t sqesSize;
+				unsigned* sqHead;
+				unsigned* sqTail;
+				unsigned* sqFlags;
+				unsigned* sqArray;
+				unsigned sqMask;
+				unsigned sqEntries;
+				unsigned sqPending;
+				unsigned* cqHead;
+				unsigned* cqTail;
+				unsigned cqMask;
+				struct io_uring_cqe* cqes;
+				struct io_uring_buf_ring* bufferRing;
+				size_t bufferRingSize;
+				uint16_t bufferTail;
+				uint8_t* receiveData;
+				struct msghdr receiveHeader;
+				ENetIoRingCompletion completions[ENET_IO_RING_BUFFER_COUNT];
+				size_t completionHead;
+				size_t completionCount;
+				struct msghdr sendHeaders[ENET_IO_RING_SEND_SLOTS];
+				struct iovec sendVectors[ENET_IO_RING_SEND_SLOTS];
+				struct sockaddr_in6 sendAddresses[ENET_IO_RING_SEND_SLOTS];
+				uint16_t sendFree[ENET_IO_RING_SEND_SLOTS];
+				size_t sendFreeCount;
+				uint8_t* sendData;
+			};
+
+			#define ENET_IO_RING_RECEIVE_TAG UINT64_MAX
+			#define ENET_IO_RING_SLOT_SIZE (sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in6) + ENET_PROTOCOL_MAXIMUM_MTU)
+
+			static int enet_io_ring_enter(ENetIoRing* ring, unsigned submit, unsigned wait, unsigned flags) {
+				int result;
+
+				do {
+					result = (int)syscall(__NR_io_uring_enter, ring->ringFd, submit, wait, flags, NULL, 0);
+				} while (result < 0 && errno == EINTR);
+
+				return result;
+			}
+
+			static struct io_uring_sqe* enet_io_ring_get_sqe(ENetIoRing* ring) {
+				unsigned tail = *ring->sqTail;
+				struct io_uring_sqe* sqe;
+
+				if (tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries) {
+					enet_io_ring_flush(ring);
+
+					if (ring->sqPoll)
+						enet_io_ring_enter(ring, 0, 0, IORING_ENTER_SQ_WAKEUP | IORING_ENTER_SQ_WAIT);
+
+					if (tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries)
+						return NULL;
+				}
+
+				sqe = &ring->sqes[tail & ring->sqMask];
+				memset(sqe, 0, sizeof(struct io_uring_sqe));
+				ring->sqArray[tail & ring->sqMask] = tail & ring->sqMask;
+
+				return sqe;
+			}
+
+			static void enet_io_ring_commit_sqe(ENetIoRing* ring) {
+				__atomic_store_n(ring->sqTail, *ring->sqTail + 1, __ATOMIC_RELEASE);
+				ring->sqPending++;
+			}
+
+			static void enet_io_ring_recycle_buffer(ENetIoRing* ring, uint16_t bufferId) {
+				struct io_uring_buf* buffer = &ring->bufferRing->bufs[ring->bufferTail & (ENET_IO_RING_BUFFER_COUNT - 1)];
+
+				buffer->addr = (uint64_t)(uintptr_t)(ring->receiveData + (size_t)bufferId * ENET_IO_RING_SLOT_SIZE);
+				buffer->len = (uint32_t)ENET_IO_RING_SLOT_SIZE;
+				buffer->bid = bufferId;
+
+				ring->bufferTail++;
+				__atomic_store_n(&ring->bufferRing->tail, ring->bufferTail, __ATOMIC_RELEASE);
+			}
+
+			static int enet_io_ring_arm_receive(ENetIoRing* ring, ENetSocket socket) {
+				struct io_uring_sqe* sqe = enet_io_ring_get_sqe(ring);
+
+				if (sqe == NULL)
+					return -1;
+
+				sqe->opcode = IORING_OP_RECVMSG;
+				sqe->fd = socket;
+				sqe->addr = (uint64_t)(uintptr_t)&ring->receiveHeader;
+				sqe->len = 1;
+				sqe->ioprio = IORING_RECV_MULTISHOT;
+				sqe->flags = IOSQE_BUFFER_SELECT;
+				sqe->buf_group = 0;
+				sqe->user_data = ENET_IO_RING_RECEIVE_TAG;
+
+				enet_io_ring_commit_sqe(ring);
+				ring->receiveArmed = 1;
+
+				return 0;
+			}
+
+			/* Send completions release their slot; receive completions queue up until the protocol asks for them. */
+			static void enet_io_ring_reap(ENetIoRing* ring) {
+				unsigned head = *ring->cqHead;
+				unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+
+				for (; head != tail; ++head) {
+					struct io_uring_cqe* cqe = &ring->cqes[head & ring->cqMask];
+
+					if (cqe->user_data != ENET_IO_RING_RECEIVE_TAG) {
+						ring->sendFree[ring->sendFreeCount++] = (uint16_t)cqe->user_data;
+						continue;
+					}
+
+					if (!(cqe->flags & IORING_CQE_F_MORE))
+						ring->receiveArmed = 0;
+
+					if (cqe->flags & IORING_CQE_F_BUFFER) {
+						ENetIoRingCompletion* completion = &ring->completions[(ring->completionHead + ring->completionCount) % ENET_IO_RING_BUFFER_COUNT];
+
+						completion->result = cqe->res;
+						completion->flags = cqe->flags;
+						ring->completionCount++;
+					} else if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+						ring->receiveArmed = -1;
+					}
+				}
+
+				__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+			}
+
+			ENetIoRing* enet_io_ring_create(ENetSocket socket, int sqPoll) {
+				struct io_uring_params params;
+				struct io_uring_buf_reg registration;
+				ENetIoRing* ring;
+				size_t i;
+
+				ring = (ENetIoRing*)enet_malloc(sizeof(ENetIoRing));
+
+				if (ring == NULL)
+					return NULL;
+
+				memset(ring, 0, sizeof(ENetIoRing));
+				memset(&params, 0, sizeof(params));
+
+				ring->ringFd = -1;
+				ring->heldBuffer = -1;
+				ring->sqRing = ring->cqRing = MAP_FAILED;
+				ring->sqes = (struct io_uring_sqe*)MAP_FAILED;
+				ring->bufferRing = (struct io_uring_buf_ring*)MAP_FAILED;
+
+				params.flags = IORING_SETUP_CQSIZE;
+				params.cq_entries = 4 * ENET_IO_RING_ENTRIES;
+
+				if (sqPoll) {
+					params.flags |= IORING_SETUP_SQPOLL;
+					params.sq_thread_idle = ENET_IO_RING_SQPOLL_IDLE;
+				}
+
+				ring->sqPoll = sqPoll;
+				ring->ringFd = (int)syscall(__NR_io_uring_setup, ENET_IO_RING_ENTRIES, &params);
+
+				if (ring->ringFd < 0)
+					goto fail;
+
+				ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+				ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+				if (params.features & IORING_FEAT_SINGLE_MMAP) {
+					if (ring->cqRingSize > ring->sqRingSize)
+						ring->sqRingSize = ring->cqRingSize;
+
+					ring->cqRingSize = ring->sqRingSize;
+				}
+
+				ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_SQ_RING);
+
+				if (ring->sqRing == MAP_FAILED)
+					goto fail;
+
+				if (params.features & IORING_FEAT_SINGLE_MMAP)
+					ring->cqRing = ring->sqRing;
+				else
+					ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_CQ_RING);
+
+				if (ring->cqRing == MAP_FAILED)
+					goto fail;
+
+				ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+				ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_SQES);
+
+				if (ring->sqes == MAP_FAILED)
+					goto fail;
+
+				ring->sqHead = (unsigned*)((uint8_t*)ring->sqRing + params.sq_off.head);
+				ring->sqTail = (unsigned*)((uint8_t*)ring->sqRing + params.sq_off.tail);
+				ring->sqFlags = (unsigned*)((uint8_t*)ring->sqRing + params.sq_off.flags);
+				ring->sqArray = (unsigned*)((uint8_t*)ring->sqRing + params.sq_off.array);
+				ring->sqMask = *(unsigned*)((uint8_t*)ring->sqRing + params.sq_off.ring_mask);
+				ring->sqEntries = params.sq_entries;
+				ring->cqHead = (unsigned*)((uint8_t*)ring->cqRing + params.cq_off.head);
+				ring->cqTail = (unsigned*)((uint8_t*)ring->cqRing + params.cq_off.tail);
+				ring->cqMask = *(unsigned*)((uint8_t*)ring->cqRing + params.cq_off.ring_mask);
+				ring->cqes = (struct io_uring_cqe*)((uint8_t*)ring->cqRing + params.cq_off.cqes);
+
+				ring->bufferRingSize = ENET_IO_RING_BUFFER_COUNT * sizeof(struct io_uring_buf) + ENET_IO_RING_BUFFER_COUNT * ENET_IO_RING_SLOT_SIZE + ENET_IO_RING_SEND_SLOTS * ENET_PROTOCOL_MAXIMUM_MTU;
+				ring->bufferRing = (struct io_uring_buf_ring*)mmap(NULL, ring->bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+				if (ring->bufferRing == MAP_FAILED)
+					goto fail;
+
+				ring->receiveData = (uint8_t*)ring->bufferRing + ENET_IO_RING_BUFFER_COUNT * sizeof(struct io_uring_buf);
+				ring->sendData = ring->receiveData + ENET_IO_RING_BUFFER_COUNT * ENET_IO_RING_SLOT_SIZE;
+
+				memset(&registration, 0, sizeof(registration));
+				registration.ring_addr = (uint64_t)(uintptr_t)ring->bufferRing;
+				registration.ring_entries = ENET_IO_RING_BUFFER_COUNT;
+				registration.bgid = 0;
+
+				if (syscall(__NR_io_uring_register, ring->ringFd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+					goto fail;
+
+				for (i = 0; i < ENET_IO_RING_BUFFER_COUNT; ++i) {
+					enet_io_ring_recycle_buffer(ring, (uint16_t)i);
+				}
+
+				for (i = 0; i < ENET_IO_RING_SEND_SLOTS; ++i) {
+					ring->sendHeaders[i].msg_name = &ring->sendAddresses[i];
+					ring->sendHeaders[i].msg_namelen = sizeof(struct sockaddr_in6);
+					ring->sendHeaders[i].msg_iov = &ring->sendVectors[i];
+					ring->sendHeaders[i].msg_iovlen = 1;
+					ring->sendVectors[i].iov_base = ring->sendData + i * ENET_PROTOCOL_MAXIMUM_MTU;
+					ring->sendFree[i] = (uint16_t)(ENET_IO_RING_SEND_SLOTS - 1 - i);
+				}
+
+				ring->sendFreeCount = ENET_IO_RING_SEND_SLOTS;
+				ring->receiveHeader.msg_namelen = sizeof(struct sockaddr_in6);
+
+				/* Kernels without multishot recvmsg reject it while the request is prepared, so the first submit tells us. */
+				if (enet_io_ring_arm_receive(ring, socket) < 0 || enet_io_ring_flush(ring) < 0)
+					goto fail;
+
+				for (i = 0; sqPoll && i < ENET_IO_RING_SQPOLL_IDLE && __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) != *ring->sqTail; ++i) {
+					enet_io_ring_enter(ring, 0, 0, IORING_ENTER_SQ_WAKEUP);
+					poll(NULL, 0, 1);
+				}
+
+				enet_io_ring_reap(ring);
 
-			switch (option) {
-				case ENET_SOCKOPT_NONBLOCK:
-					result = fcntl(socket, F_SETFL, (value ? O_NONBLOCK : 0) | (fcntl(socket, F_GETFL) & ~O_NONBLOCK));
+				if (ring->receiveArmed < 0)
+					goto fail;
 
-					break;
+				return ring;
 
-				case ENET_SOCKOPT_BROADCAST:
-					result = setsockopt(socket, SOL_SOCKET, SO_BROADCAST, (char*)&value, sizeof(int));
+			fail:
+				enet_io_ring_destroy(ring);
 
-					break;
+				return NULL;
+			}
 
-				case ENET_SOCKOPT_REUSEADDR:
-					result = setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, (char*)&value, sizeof(int));
+			void enet_io_ring_destroy(ENetIoRing* ring) {
+				if (ring->bufferRing != MAP_FAILED)
+					munmap(ring->bufferRing, ring->bufferRingSize);
 
-					break;
+				if (ring->sqes != MAP_FAILED)
+					munmap(ring->sqes, ring->sqesSize);
 
-				case ENET_SOCKOPT_RCVBUF:
-					result = setsockopt(socket, SOL_SOCKET, SO_RCVBUF, (char*)&value, sizeof(int));
+				if (ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing)
+					munmap(ring->cqRing, ring->cqRingSize);
 
-					break;
+				if (ring->sqRing != MAP_FAILED)
+					munmap(ring->sqRing, ring->sqRingSize);
 
-				case ENET_SOCKOPT_SNDBUF:
-					result = setsockopt(socket, SOL_SOCKET, SO_SNDBUF, (char*)&value, sizeof(int));
+				if (ring->ringFd >= 0)
+					close(ring->ringFd);
 
-					break;
+				enet_free(ring);
+			}
 
-				case ENET_SOCKOPT_RCVTIMEO: {
-					struct timeval timeVal;
+			int enet_io_ring_pending(const ENetIoRing* ring) {
+				return ring->completionCount > 0;
+			}
 
-					timeVal.tv_sec = value / 1000;
-					timeVal.tv_usec = (value % 1000) * 1000;
-					result = setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeVal, sizeof(struct timeval));
+			/* The buffer handed out by the previous call goes back to the kernel first; the protocol is done with it by then. */
+			int enet_io_ring_receive(ENetSocket socket, ENetIoRing* ring, size_t mtu, ENetAddress* address, uint8_t** data) {
+				ENetIoRingCompletion* completion;
+				struct io_uring_recvmsg_out* out;
+				struct sockaddr_in6* sin;
+				uint8_t* buffer;
 
-					break;
+				if (ring->heldBuffer >= 0) {
+					enet_io_ring_recycle_buffer(ring, (uint16_t)ring->heldBuffer);
+					ring->heldBuffer = -1;
 				}
 
-				case ENET_SOCKOPT_SNDTIMEO: {
-					struct timeval timeVal;
+				if (ring->completionCount == 0) {
+					enet_io_ring_reap(ring);
 
-					timeVal.tv_sec = value / 1000;
-					timeVal.tv_usec = (value % 1000) * 1000;
-					result = setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (char*)&timeVal, sizeof(struct timeval));
+					if (ring->completionCount == 0) {
+						if (ring->receiveArmed == 0 && enet_io_ring_arm_receive(ring, socket) == 0)
+							enet_io_ring_flush(ring);
 
-					break;
+						return 0;
+					}
 				}
 
-				case ENET_SOCKOPT_NODELAY:
-					result = setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (char*)&value, sizeof(int));
+				completion = &ring->completions[ring->completionHead];
+				ring->completionHead = (ring->completionHead + 1) % ENET_IO_RING_BUFFER_COUNT;
+				ring->completionCount--;
 
-					break;
+				ring->heldBuffer = (int)(completion->flags >> IORING_CQE_BUFFER_SHIFT);
 
-				case ENET_SOCKOPT_IPV6_V6ONLY:
-					result = setsockopt(socket, IPPROTO_IPV6, IPV6_V6ONLY, (char*)&value, sizeof(int));
+				if (completion->result < 0)
+					return -2;
 
-					break;
+				buffer = ring->receiveData + (size_t)ring->heldBuffer * ENET_IO_RING_SLOT_SIZE;
+				out = (struct io_uring_recvmsg_out*)buffer;
 
-				default:
-					break;
-			}
+				if ((out->flags & MSG_TRUNC) || out->payloadlen > mtu)
+					return -2;
 
-			return result == -1 ? -1 : 0;
-		}
+				sin = (struct sockaddr_in6*)(buffer + sizeof(struct io_uring_recvmsg_out));
+				address->ipv6 = sin->sin6_addr;
+				address->port = ENET_NET_TO_HOST_16(sin->sin6_port);
+				*data = buffer + sizeof(struct io_uring_recvmsg_out) + ring->receiveHeader.msg_namelen + ring->receiveHeader.msg_controllen;
 
-		int enet_socket_get_option(ENetSocket socket, ENetSocketOption option, int* value) {
-			int result = -1;
-			socklen_t len;
+				return (int)out->payloadlen;
+			}
 
-			switch (option) {
-				case ENET_SOCKOPT_ERROR:
-					len = sizeof(int);
-					result = getsockopt(socket, SOL_SOCKET, SO_ERROR, value, &len);
+			/* Queues a sendmsg; nothing reaches the kernel until enet_io_ring_flush. Blocks on completions only when every slot is in flight. */
+			int enet_io_ring_send(ENetSocket socket, ENetIoRing* ring, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+				struct io_uring_sqe* sqe;
+				struct sockaddr_in6* sin;
+				uint8_t* data;
+				size_t length = 0;
+				size_t i;
+				uint16_t slot;
+
+				for (i = 0; i < bufferCount; ++i) {
+					length += buffers[i].dataLength;
+				}
 
-					break;
+				if (length > ENET_PROTOCOL_MAXIMUM_MTU)
+					return enet_socket_send(socket, address, buffers, bufferCount);
 
-				default:
-					break;
-			}
+				if (ring->sendFreeCount == 0) {
+					enet_io_ring_flush(ring);
+					enet_io_ring_reap(ring);
 
-			return result == -1 ? -1 : 0;
-		}
+					while (ring->sendFreeCount == 0) {
+						if (enet_io_ring_enter(ring, 0, 1, IORING_ENTER_GETEVENTS) < 0)
+							return -1;
 
-		int enet_socket_connect(ENetSocket socket, const ENetAddress* address) {
-			int result = -1;
-			struct sockaddr_in6 sin;
+						enet_io_ring_reap(ring);
+					}
+				}
 
-			memset(&sin, 0, sizeof(struct sockaddr_in6));
+				sqe = enet_io_ring_get_sqe(ring);
 
-			sin.sin6_family = AF_INET6;
-			sin.sin6_port = ENET_HOST_TO_NET_16(address->port);
-			sin.sin6_addr = address->ipv6;
+				if (sqe == NULL)
+					return -1;
 
-			result = connect(socket, (struct sockaddr*)&sin, sizeof(struct sockaddr_in6));
+				slot = ring->sendFree[--ring->sendFreeCount];
+				data = (uint8_t*)ring->sendVectors[slot].iov_base;
 
-			if (result == -1 && errno == EINPROGRESS)
-				return 0;
+				for (i = 0; i < bufferCount; ++i) {
+					memcpy(data, buffers[i].data, buffers[i].dataLength);
+					data += buffers[i].dataLength;
+				}
 
-			return result;
-		}
+				sin = &ring->sendAddresses[slot];
+				memset(sin, 0, sizeof(struct sockaddr_in6));
+				sin->sin6_family = AF_INET6;
+				sin->sin6_addr = address->ipv6;
+				sin->sin6_port = ENET_HOST_TO_NET_16(address->port);
 
-		ENetSocket enet_socket_accept(ENetSocket socket, ENetAddress* address) {
-			int result = -1;
-			struct sockaddr_in6 sin;
-			socklen_t sinLength = sizeof(struct sockaddr_in6);
+				ring->sendVectors[slot].iov_len = length;
 
-			result = accept(socket, address != NULL ? (struct sockaddr*)&sin : NULL, address != NULL ? &sinLength : NULL);
+				sqe->opcode = IORING_OP_SENDMSG;
+				sqe->fd = socket;
+				sqe->addr = (uint64_t)(uintptr_t)&ring->sendHeaders[slot];
+				sqe->len = 1;
+				sqe->msg_flags = MSG_NOSIGNAL;
+				sqe->user_data = slot;
 
-			if (result == -1)
-				return ENET_SOCKET_NULL;
+				enet_io_ring_commit_sqe(ring);
 
-			if (address != NULL) {
-				address->ipv6 = sin.sin6_addr;
-				address->port = ENET_NET_TO_HOST_16(sin.sin6_port);
+				return (int)length;
 			}
 
-			return result;
-		}
-
-		int enet_socket_shutdown(ENetSocket socket, ENetSocketShutdown how) {
-			return shutdown(socket, (int)how);
-		}
+			/* With SQPOLL the kernel thread picks the entries up itself and a syscall is only needed to wake it. That thread
+			   spins for ENET_IO_RING_SQPOLL_IDLE ms after each submission, so it pays off only on a core nothing else needs. */
+			int enet_io_ring_flush(ENetIoRing* ring) {
+				unsigned submit = ring->sqPending;
 
-		void enet_socket_destroy(ENetSocket socket) {
-			if (socket != ENET_SOCKET_NULL)
-				close(socket);
-		}
+				if (submit == 0)
+					return 0;
 
-		int enet_socket_send(ENetSocket socket, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
-			struct msghdr msgHdr;
-			struct sockaddr_in6 sin;
-			int sentLength;
+				ring->sqPending = 0;
 
-			memset(&msgHdr, 0, sizeof(struct msghdr));
+				if (ring->sqPoll) {
+					if (__atomic_load_n(ring->sqFlags, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP)
+						return enet_io_ring_enter(ring, 0, 0, IORING_ENTER_SQ_WAKEUP) < 0 ? -1 : 0;
 
-			if (address != NULL) {
-				memset(&sin, 0, sizeof(struct sockaddr_in6));
+					return 0;
+				}
 
-				sin.sin6_family = AF_INET6;
-				sin.sin6_port = ENET_HOST_TO_NET_16(address->port);
-				sin.sin6_addr = address->ipv6;
-				msgHdr.msg_name = &sin;
-				msgHdr.msg_namelen = sizeof(struct sockaddr_in6);
+				return enet_io_ring_enter(ring, submit, 0, 0) < 0 ? -1 : 0;
 			}
 
-			msgHdr.msg_iov = (struct iovec*)buffers;
-			msgHdr.msg_iovlen = bufferCount;
-			sentLength = sendmsg(socket, &msgHdr, MSG_NOSIGNAL);
+			/* Stands in for enet_socket_wait: the ring fd polls readable whenever completions are waiting. */
+			int enet_io_ring_wait(ENetSocket socket, ENetIoRing* ring, uint32_t* condition, uint64_t timeout) {
+				struct pollfd pollSocket;
+				int pollCount;
+
+				if (!(*condition & ENET_SOCKET_WAIT_RECEIVE))
+					return enet_socket_wait(socket, condition, timeout);
+
+				if (ring->receiveArmed == 0)
+					enet_io_ring_arm_receive(ring, socket);
+
+				enet_io_ring_flush(ring);
+				enet_io_ring_reap(ring);
+
+				if (ring->completionCount > 0) {
+					*condition = ENET_SOCKET_WAIT_RECEIVE;
 
-			if (sentLength == -1) {
-				if (errno == EWOULDBLOCK)
 					return 0;
+				}
 
-				return -1;
-			}
+				pollSocket.fd = ring->ringFd;
+				pollSocket.events = POLLIN;
+				pollCount = poll(&pollSocket, 1, (int)timeout);
 
-			return sentLength;
-		}
+				if (pollCount < 0) {
+					if (errno == EINTR && *condition & ENET_SOCKET_WAIT_INTERRUPT) {
+						*condition = ENET_SOCKET_WAIT_INTERRUPT;
 
-		int enet_socket_receive(ENetSocket socket, ENetAddress* address, ENetBuffer* buffers, size_t bufferCount) {
-			struct msghdr msgHdr;
-			struct sockaddr_in6 sin;
-			int recvLength;
+						return 0;
+					}
 
-			memset(&msgHdr, 0, sizeof(struct msghdr));
+					return -1;
+				}
 
-			if (address != NULL) {
-				msgHdr.msg_name = &sin;
-				msgHdr.msg_namelen = sizeof(struct sockaddr_in6);
+				*condition = ENET_SOCKET_WAIT_NONE;
+
+				if (pollCount == 0)
+					return 0;
+
+				enet_io_ring_reap(ring);
+
+				if (ring->completionCount > 0)
+					*condition |= ENET_SOCKET_WAIT_RECEIVE;
+
+				return 0;
+			}
+		#else
+			ENetIoRing* enet_io_ring_create(ENetSocket socket, int sqPoll) {
+				return NULL;
 			}
 
-			msgHdr.msg_iov = (struct iovec*)buffers;
-			msgHdr.msg_iovlen = bufferCount;
-			recvLength = recvmsg(socket, &msgHdr, MSG_NOSIGNAL);
+			void enet_io_ring_destroy(ENetIoRing* ring) { }
 
-			if (recvLength == -1) {
-				if (errno == EWOULDBLOCK)
-					return 0;
+			int enet_io_ring_pending(const ENetIoRing* ring) {
+				return 0;
+			}
 
+			int enet_io_ring_receive(ENetSocket socket, ENetIoRing* ring, size_t mtu, ENetAddress* address, uint8_t** data) {
 				return -1;
 			}
 
-			if (msgHdr.msg_flags & MSG_TRUNC)
-				return -2;
+			int enet_io_ring_send(ENetSocket socket, ENetIoRing* ring, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+				return -1;
+			}
 
-			if (address != NULL) {
-				address->ipv6 = sin.sin6_addr;
-				address->port = ENET_NET_TO_HOST_16(sin.sin6_port);
+			int enet_io_ring_flush(ENetIoRing* ring) {
+				return -1;
 			}
 
-			return recvLength;
-		}
+			int enet_io_ring_wait(ENetSocket socket, ENetIoRing* ring, uint32_t* condition, uint64_t timeout) {
+				return -1;
+			}
+		#endif
 
 		int enet_socket_set_select(ENetSocket maxSocket, ENetSocketSet* readSet, ENetSocketSet* writeSet, uint32_t timeout) {
 			struct timeval timeVal;
@@ -4676,6 +8319,7 @@ extern "C" {
 			}
 
 			timeBeginPeriod(1);
+			enet_crc64_initialize();
 
 			return 0;
 		}
@@ -4689,6 +8333,42 @@ extern "C" {
 			return (uint64_t)timeGetTime();
 		}
 
+		size_t enet_memory_page_size(void) {
+			static size_t pageSize = 0;
+
+			if (pageSize == 0) {
+				SYSTEM_INFO systemInfo;
+
+				GetSystemInfo(&systemInfo);
+
+				pageSize = systemInfo.dwPageSize;
+			}
+
+			return pageSize;
+		}
+
+		/* Only address space is reserved, which costs no commit charge; pages are committed as peer slots come into use. */
+		void* enet_memory_reserve(size_t size) {
+			return VirtualAlloc(NULL, size > 0 ? size : 1, MEM_RESERVE, PAGE_READWRITE);
+		}
+
+		/* Committing pages that already are is harmless, so discarded pages can be committed again. */
+		int enet_memory_commit(void* memory, size_t size) {
+			return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != NULL ? 0 : -1;
+		}
+
+		/*
+			The pages leave the working set but stay committed and mapped, so a stale peer pointer reads old or zeroed bytes and never faults.
+			Decommitting would return the commit charge too, but leaves those reads faulting.
+		*/
+		void enet_memory_discard(void* memory, size_t size) {
+			VirtualAlloc(memory, size, MEM_RESET, PAGE_READWRITE);
+		}
+
+		void enet_memory_release(void* memory, size_t size) {
+			VirtualFree(memory, 0, MEM_RELEASE);
+		}
+
 		int enet_socket_bind(ENetSocket socket, const ENetAddress* address) {
 			struct sockaddr_in6 sin;
 
@@ -4792,6 +8472,14 @@ extern "C" {
 
 					break;
 
+				case ENET_SOCKOPT_DONTFRAGMENT:
+					result = setsockopt(socket, IPPROTO_IPV6, IPV6_DONTFRAG, (char*)&value, sizeof(int));
+
+					if (result != SOCKET_ERROR)
+						result = setsockopt(socket, IPPROTO_IP, IP_DONTFRAGMENT, (char*)&value, sizeof(int));
+
+					break;
+
 				default:
 					break;
 			}
@@ -4873,11 +8561,15 @@ extern "C" {
 			}
 
 			if (WSASendTo(socket, (LPWSABUF)buffers, (DWORD)bufferCount, &sentLength, 0, address != NULL ? (struct sockaddr*)&sin : NULL, address != NULL ? sizeof(struct sockaddr_in6) : 0, NULL, NULL) == SOCKET_ERROR)
-				return (WSAGetLastError() == WSAEWOULDBLOCK) ? 0 : -1;
+				return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
 
 			return (int)sentLength;
 		}
 
+		int enet_socket_message_too_large(void) {
+			return WSAGetLastError() == WSAEMSGSIZE;
+		}
+
 		int enet_socket_receive(ENetSocket socket, ENetAddress* address, ENetBuffer* buffers, size_t bufferCount) {
 			INT sinLength = sizeof(struct sockaddr_in6);
 			DWORD flags = 0, recvLength = 0;
@@ -4904,6 +8596,63 @@ extern "C" {
 			return (int)recvLength;
 		}
 
+		/* No recvmmsg/sendmmsg, UDP segmentation offload or io_uring on Windows; hosts stay on the per-datagram path. */
+		ENetIoBatch* enet_io_batch_create(size_t capacity, uint32_t offload) {
+			return NULL;
+		}
+
+		void enet_io_batch_destroy(ENetIoBatch* batch) { }
+
+		int enet_io_batch_pending(const ENetIoBatch* batch) {
+			return 0;
+		}
+
+		uint32_t enet_io_batch_probe_offload(ENetSocket socket, uint32_t offload) {
+			return 0;
+		}
+
+		uint32_t enet_io_batch_get_offload(const ENetIoBatch* batch) {
+			return 0;
+		}
+
+		int enet_io_batch_receive(ENetSocket socket, ENetIoBatch* batch, size_t mtu, ENetAddress* address, uint8_t** data) {
+			return -1;
+		}
+
+		int enet_io_batch_send(ENetSocket socket, ENetIoBatch* batch, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+			return -1;
+		}
+
+		int enet_io_batch_flush(ENetSocket socket, ENetIoBatch* batch) {
+			return -1;
+		}
+
+		ENetIoRing* enet_io_ring_create(ENetSocket socket, int sqPoll) {
+			return NULL;
+		}
+
+		void enet_io_ring_destroy(ENetIoRing* ring) { }
+
+		int enet_io_ring_pending(const ENetIoRing* ring) {
+			return 0;
+		}
+
+		int enet_io_ring_receive(ENetSocket socket, ENetIoRing* ring, size_t mtu, ENetAddress* address, uint8_t** data) {
+			return -1;
+		}
+
+		int enet_io_ring_send(ENetSocket socket, ENetIoRing* ring, const ENetAddress* address, const ENetBuffer* buffers, size_t bufferCount) {
+			return -1;
+		}
+
+		int enet_io_ring_flush(ENetIoRing* ring) {
+			return -1;
+		}
+
+		int enet_io_ring_wait(ENetSocket socket, ENetIoRing* ring, uint32_t* condition, uint64_t timeout) {
+			return -1;
+		}
+
 		int enet_socket_set_select(ENetSocket maxSocket, ENetSocketSet* readSet, ENetSocketSet* writeSet, uint32_t timeout) {
 			struct timeval timeVal;
 
@@ -5011,9 +8760,7 @@ extern "C" {
 		if (number < 1)
 			number = 1;
 
-		if (number > ENET_PROTOCOL_MAXIMUM_PEER_ID)
-			number = ENET_PROTOCOL_MAXIMUM_PEER_ID;
-
+		/* A uint16_t already stays within ENET_PROTOCOL_MAXIMUM_EXTENDED_PEER_ID, the most peers a host can hold. */
 		host->duplicatePeers = number;
 	}
 
@@ -5021,6 +8768,44 @@ extern "C" {
 		host->interceptCallback = callback;
 	}
 
+	size_t enet_host_get_io_batch_size(const ENetHost* host) {
+		return host->ioBatchSize;
+	}
+
+	ENetHostBackend enet_host_get_backend(const ENetHost* host) {
+		return host->backend;
+	}
+
+	ENetCongestionControl enet_host_get_congestion_control(const ENetHost* host) {
+		return host->congestionControl;
+	}
+
+	/* Reserved bytes cover every peer slot with channelLimit channels; used bytes are the resident slot pages and allocated channels. Both include the address index. */
+	void enet_host_get_memory_usage(const ENetHost* host, ENetHostMemoryUsage* usage) {
+		const ENetPeer* currentPeer;
+		size_t channelBytes = 0;
+
+		for (currentPeer = host->peers; currentPeer < &host->peers[host->peerSlotCount]; ++currentPeer) {
+			channelBytes += currentPeer->channelCount * sizeof(ENetChannel);
+		}
+
+		usage->peerSlots = host->peerCount;
+		usage->usedPeerSlots = host->peerSlotCount;
+		usage->connectedPeers = host->connectedPeers;
+		usage->reservedBytes = host->peerCount * (sizeof(ENetPeer) + host->channelLimit * sizeof(ENetChannel)) + (host->addressBucketMask + 1) * sizeof(ENetList);
+		usage->usedBytes = host->peerSlotBytes + channelBytes + (host->addressBucketMask + 1) * sizeof(ENetList);
+	}
+
+	/* Counts the service passes that stopped at a budget with work left over. */
+	void enet_host_get_budget_stats(const ENetHost* host, ENetHostBudgetStats* stats) {
+		*stats = host->budgetStats;
+	}
+
+	/* GSO is dropped here once the kernel has refused a segmented send. */
+	uint32_t enet_host_get_udp_offload(const ENetHost* host) {
+		return host->ioBatch != NULL ? enet_io_batch_get_offload(host->ioBatch) : ENET_HOST_OFFLOAD_NONE;
+	}
+
 	void enet_host_set_checksum_callback(ENetHost* host, ENetChecksumCallback callback) {
 		host->checksumCallback = callback;
 	}
@@ -5069,10 +8854,23 @@ extern "C" {
 		return peer->totalPacketsLost;
 	}
 
+	uint64_t enet_peer_get_packets_repaired(const ENetPeer* peer) {
+		return peer->totalPacketsRepaired;
+	}
+
+	float enet_peer_get_packet_loss(const ENetPeer* peer) {
+		return peer->packetLoss / (float)ENET_PEER_PACKET_LOSS_SCALE * 100.0f;
+	}
+
 	float enet_peer_get_packets_throttle(const ENetPeer* peer) {
 		return peer->packetThrottle / (float)ENET_PEER_PACKET_THROTTLE_SCALE * 100.0f;
 	}
 
+	/* Bytes per second: the pacing rate under delay-based control, otherwise the rate the peer was sent over the last second. */
+	uint32_t enet_peer_get_bandwidth_estimate(const ENetPeer* peer) {
+		return peer->sendRate;
+	}
+
 	uint64_t enet_peer_get_bytes_sent(const ENetPeer* peer) {
 		return peer->totalDataSent;
 	}
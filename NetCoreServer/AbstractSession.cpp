@@ -12,7 +12,51 @@ namespace NetCoreServer {
 		server->sendPacket(peer, channel, packet);
 	}
 
+	void AbstractSession::broadcast(uint8_t channel, Packet packet) {
+		server->broadcastPacket(playerPeers.read(), channel, packet);
+	}
+
+	void AbstractSession::broadcastExcept(uint64_t uid, uint8_t channel, Packet packet) {
+		server->broadcastPacket(playerPeers.read(), channel, packet, server->getPeerByUid(uid));
+	}
+
+	void AbstractSession::broadcastExcept(ENetPeer* peer, uint8_t channel, Packet packet) {
+		server->broadcastPacket(playerPeers.read(), channel, packet, peer);
+	}
+
+	void AbstractSession::sendToInterested(const InterestGrid& grid, uint64_t entityId, uint8_t channel, Packet packet, ENetPeer* excluded) {
+		auto targets = std::make_shared<std::vector<PeerHandle>>();
+		grid.collectViewers(entityId, *targets);
+		if (targets->empty()) {
+			packet.destory();
+			return;
+		}
+		server->broadcastPacket(std::move(targets), channel, packet, excluded);
+	}
+
+	std::optional<PeerHandle> AbstractSession::getPlayerHandle(uint64_t uid) const {
+		return server->getPeerHandle(server->getPeerByUid(uid));
+	}
+
 	const std::optional<uint64_t> AbstractSession::getPeerUid(ENetPeer* peer) {
 		return server->getPeerUid(peer);
 	}
+
+	std::optional<uint32_t> AbstractSession::getBandwidthEstimate(uint64_t uid) const {
+		auto context = server->getPeerContext(server->getPeerByUid(uid));
+		if (context == nullptr) return std::nullopt;
+
+		uint32_t estimate = context->bandwidthEstimate.load(std::memory_order_relaxed);
+		if (estimate == 0) return std::nullopt;
+		return estimate;
+	}
+
+	std::optional<uint32_t> AbstractSession::getPeerMtu(uint64_t uid) const {
+		auto context = server->getPeerContext(server->getPeerByUid(uid));
+		if (context == nullptr) return std::nullopt;
+
+		uint32_t mtu = context->mtu.load(std::memory_order_relaxed);
+		if (mtu == 0) return std::nullopt;
+		return mtu;
+	}
 }
\ No newline at end of file
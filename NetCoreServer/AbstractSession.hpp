@@ -3,21 +3,29 @@
 #include "NetCoreStructure.hpp"
 #include "AbstractHandler.hpp"
 #include "Packet.hpp"
+#include "PeerContext.hpp"
+#include "InterestGrid.hpp"
+#include "Rcu.hpp"
 
 namespace NetCoreServer {
 	class SessionManager;
 	class SessionServer;
+	class AbstractSessionBatch;
 
 	class AbstractSession {
 	private:
 		friend class SessionManager;
 		friend class SessionServer;
+		friend class AbstractSessionBatch;
 
-		SessionInfo sessionInfo;
+		Rcu<SessionInfo> sessionInfo;
 		std::vector<uint64_t> players;
+		// Parallel to players, captured as each joins so a broadcast needs no uid lookups.
+		Rcu<std::vector<PeerHandle>> playerPeers;
 		std::optional<std::string> password;
 
 		std::shared_ptr<SessionServer> server;
+		std::shared_ptr<AbstractSessionBatch> sessionBatch;
 
 		const double framerate;
 
@@ -30,6 +38,19 @@ namespace NetCoreServer {
 
 		void sendPacket(ENetPeer* peer, uint8_t channel, Packet packet);
 
+		// Sends one packet, serialized once, to every player in the session.
+		void broadcast(uint8_t channel, Packet packet);
+
+		void broadcastExcept(uint64_t uid, uint8_t channel, Packet packet);
+
+		void broadcastExcept(ENetPeer* peer, uint8_t channel, Packet packet);
+
+		// Sends one packet to the viewers within the grid's radius of the entity, such as its own movement update.
+		void sendToInterested(const InterestGrid& grid, uint64_t entityId, uint8_t channel, Packet packet, ENetPeer* excluded = nullptr);
+
+		// Handle to pass to InterestGrid::setViewer; empty if the player is not connected.
+		std::optional<PeerHandle> getPlayerHandle(uint64_t uid) const;
+
 	public:
 		AbstractSession(SessionInfo info, const SessionCreationOption& opt, const double framerate)
 			: sessionInfo(std::move(info)), password(opt.password), framerate(framerate) {
@@ -46,6 +67,10 @@ namespace NetCoreServer {
 			return running.load();
 		}
 
+		bool isBatched() const {
+			return sessionBatch != nullptr;
+		}
+
 		void stop() {
 			running.store(false);
 		}
@@ -87,12 +112,18 @@ namespace NetCoreServer {
 			}
 		}
 
-		const SessionInfo& getSessionInfo() const {
-			return sessionInfo;
+		// Copy of the current info. Binding it to a const reference, as callers of the old reference-returning accessor do, keeps it alive.
+		SessionInfo getSessionInfo() const {
+			return *sessionInfo.read();
+		}
+
+		// Immutable snapshot without the copy; stays valid even if the info is republished meanwhile.
+		std::shared_ptr<const SessionInfo> getSessionInfoSnapshot() const {
+			return sessionInfo.read();
 		}
 
 		void setSessionInfo(SessionInfo info) {
-			sessionInfo = std::move(info);
+			sessionInfo.publish(std::move(info));
 		}
 
 		bool comparePassword(const std::string& inputPassword) const {
@@ -101,10 +132,17 @@ namespace NetCoreServer {
 			} else return true;
 		}
 
-		const std::string& getSessionType() const {
-			return sessionInfo.sessionType;
+		// By value, since the info can be republished; a const reference bound to the result stays valid.
+		std::string getSessionType() const {
+			return sessionInfo.read()->sessionType;
 		}
 
 		const std::optional<uint64_t> getPeerUid(ENetPeer* peer);
+
+		// Bytes per second the player's connection is estimated to carry, for scaling what a tick sends them.
+		std::optional<uint32_t> getBandwidthEstimate(uint64_t uid) const;
+
+		// Largest datagram currently sent to the player, for sizing messages that should not fragment.
+		std::optional<uint32_t> getPeerMtu(uint64_t uid) const;
 	};
 }
\ No newline at end of file
@@ -7,4 +7,9 @@ namespace NetCoreServer {
 	public:
 		ServerCreationError() : std::runtime_error("Failed to create ENet server host") {}
 	};
+
+	class SessionAttachError : public std::runtime_error {
+	public:
+		SessionAttachError(const std::string& reason) : std::runtime_error("Failed to attach a session: " + reason) {}
+	};
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "InterestGrid.hpp"
+
+namespace NetCoreServer {
+	void InterestGrid::place(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, uint64_t id, float x, float y, PeerHandle peer) {
+		const size_t cell = cellOf(x, y);
+		auto [it, inserted] = entries.try_emplace(id, Entry{ cell, 0 });
+		Entry& entry = it->second;
+		if (!inserted) {
+			if (entry.cell == cell) {
+				Member& member = (cells[cell].*members)[entry.slot];
+				member.x = x;
+				member.y = y;
+				member.peer = peer;
+				return;
+			}
+
+			detach(members, entries, entry);
+			entry.cell = cell;
+		}
+
+		auto& list = cells[cell].*members;
+		entry.slot = list.size();
+		list.push_back(Member{ id, x, y, peer });
+	}
+
+	bool InterestGrid::unplace(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, uint64_t id) {
+		auto it = entries.find(id);
+		if (it == entries.end()) return false;
+
+		detach(members, entries, it->second);
+		entries.erase(it);
+		return true;
+	}
+
+	void InterestGrid::detach(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, const Entry& entry) {
+		auto& list = cells[entry.cell].*members;
+
+		// Move the last member into the freed slot so removal stays O(1). The cell keeps its capacity for whatever enters next.
+		if (entry.slot + 1 != list.size()) {
+			list[entry.slot] = list.back();
+			entries.find(list[entry.slot].id)->second.slot = entry.slot;
+		}
+		list.pop_back();
+	}
+
+	void InterestGrid::collectViewers(uint64_t entityId, std::vector<PeerHandle>& out) const {
+		out.clear();
+		auto it = entities.find(entityId);
+		if (it == entities.end()) return;
+
+		const Member& entity = cells[it->second.cell].entities[it->second.slot];
+		const float x = entity.x;
+		const float y = entity.y;
+		const float radiusSquared = radius * radius;
+		forEachCellNear(x, y, [&](const Cell& cell) {
+			for (const Member& viewer : cell.viewers) {
+				const float dx = viewer.x - x;
+				const float dy = viewer.y - y;
+				if (dx * dx + dy * dy <= radiusSquared) out.push_back(viewer.peer);
+			}
+			});
+	}
+
+	void InterestGrid::collectEntities(uint64_t uid, std::vector<uint64_t>& out) const {
+		out.clear();
+		auto it = viewers.find(uid);
+		if (it == viewers.end()) return;
+
+		const Member& viewer = cells[it->second.cell].viewers[it->second.slot];
+		const float x = viewer.x;
+		const float y = viewer.y;
+		const float radiusSquared = radius * radius;
+		forEachCellNear(x, y, [&](const Cell& cell) {
+			for (const Member& entity : cell.entities) {
+				const float dx = entity.x - x;
+				const float dy = entity.y - y;
+				if (dx * dx + dy * dy <= radiusSquared) out.push_back(entity.id);
+			}
+			});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include "pch.h"
+#include "PeerContext.hpp"
+
+namespace NetCoreServer {
+	// Uniform grid over a rectangle of the x/y plane that tells which players should hear about an entity.
+	// A viewer is interested in every entity within radius of it; a cell size near the radius keeps each query to 3x3 cells.
+	// Cells are one array laid out row by row and live as long as the grid, so a query reads its neighbours without a lookup.
+	// Positions outside the bounds are held in the edge cells; queries stay exact, only slower if many gather there.
+	// Moving an entity or viewer only relinks it when it crosses into another cell. Not thread-safe; owned by one session thread.
+	class InterestGrid final {
+	private:
+		// Positions and peers live in the cells, so a query reads them in order without looking up each id; peer is only used by viewers.
+		struct Member {
+			uint64_t id;
+			float x;
+			float y;
+			PeerHandle peer;
+		};
+
+		struct Cell {
+			std::vector<Member> entities;
+			std::vector<Member> viewers;
+		};
+
+		// Where an id sits: the index of its cell and its position in that cell's list.
+		struct Entry {
+			size_t cell;
+			size_t slot;
+		};
+
+		// A query visits (2 * reach + 1)^2 cells, so cells are widened until the radius spans at most this many.
+		static constexpr int32_t maximumReach = 8;
+		// Cells are widened until each side of the bounds spans at most this many, which caps the array at about a million cells.
+		static constexpr int32_t maximumSpan = 1024;
+
+		const float minX;
+		const float minY;
+		const float cellSize;
+		const float radius;
+		const int32_t reach;
+		const int32_t columns;
+		const int32_t rows;
+
+		std::vector<Cell> cells;
+		std::unordered_map<uint64_t, Entry> entities;
+		std::unordered_map<uint64_t, Entry> viewers;
+
+		// Clamping keeps cells of points within radius of each other within reach, so edge cells only gather more to test.
+		// A NaN coordinate lands in the first cell; it is never within radius of anything.
+		static int32_t cellCoordinate(float value, float origin, float cellSize, int32_t count) {
+			const double cell = std::floor((static_cast<double>(value) - origin) / cellSize);
+			if (std::isnan(cell)) return 0;
+			return static_cast<int32_t>(std::clamp(cell, 0.0, static_cast<double>(count - 1)));
+		}
+
+		size_t cellOf(float x, float y) const {
+			return static_cast<size_t>(cellCoordinate(y, minY, cellSize, rows)) * columns + cellCoordinate(x, minX, cellSize, columns);
+		}
+
+		static float checkedCellSize(float cellSize, float radius, float minX, float minY, float maxX, float maxY) {
+			if (!std::isfinite(cellSize) || cellSize <= 0.0f) throw std::invalid_argument("InterestGrid cell size must be finite and positive");
+			if (!std::isfinite(radius) || radius < 0.0f) throw std::invalid_argument("InterestGrid radius must be finite and not negative");
+			if (!std::isfinite(minX) || !std::isfinite(minY) || !std::isfinite(maxX) || !std::isfinite(maxY) || minX > maxX || minY > maxY)
+				throw std::invalid_argument("InterestGrid bounds must be finite and not inverted");
+			const double longestSide = std::max(static_cast<double>(maxX) - minX, static_cast<double>(maxY) - minY);
+			return std::max({ cellSize, radius / maximumReach, static_cast<float>(longestSide / maximumSpan) });
+		}
+
+		static int32_t cellCount(float minimum, float maximum, float cellSize) {
+			return std::clamp(static_cast<int32_t>(std::ceil((static_cast<double>(maximum) - minimum) / cellSize)), 1, maximumSpan);
+		}
+
+		// members selects the entity or viewer list of a cell, and entries is the matching map.
+		void place(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, uint64_t id, float x, float y, PeerHandle peer);
+		bool unplace(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, uint64_t id);
+		void detach(std::vector<Member> Cell::* members, std::unordered_map<uint64_t, Entry>& entries, const Entry& entry);
+
+		template<typename Visitor>
+		void forEachCellNear(float x, float y, Visitor&& visitor) const {
+			const int32_t cx = cellCoordinate(x, minX, cellSize, columns);
+			const int32_t cy = cellCoordinate(y, minY, cellSize, rows);
+			const int32_t firstColumn = std::max(cx - reach, 0);
+			const int32_t lastColumn = std::min(cx + reach, columns - 1);
+			for (int32_t row = std::max(cy - reach, 0); row <= std::min(cy + reach, rows - 1); row++) {
+				const Cell* cell = &cells[static_cast<size_t>(row) * columns + firstColumn];
+				for (int32_t column = firstColumn; column <= lastColumn; column++, cell++) visitor(*cell);
+			}
+		}
+
+	public:
+		// Covers the rectangle from (minX, minY) to (maxX, maxY).
+		// Throws std::invalid_argument for a cell size that is not positive, a negative radius, inverted bounds, or any of them not finite.
+		// A cell size below radius / 8 is raised to it, and so is one that would split a side of the bounds into more than 1024 cells.
+		InterestGrid(float cellSize, float radius, float minX, float minY, float maxX, float maxY)
+			: minX(minX), minY(minY), cellSize(checkedCellSize(cellSize, radius, minX, minY, maxX, maxY)), radius(radius),
+			reach(std::min(static_cast<int32_t>(std::ceil(radius / this->cellSize)), maximumReach)),
+			columns(cellCount(minX, maxX, this->cellSize)), rows(cellCount(minY, maxY, this->cellSize)),
+			cells(static_cast<size_t>(columns) * rows) {
+		}
+
+		// Adds the entity, or moves it if it is already in the grid.
+		void setEntity(uint64_t entityId, float x, float y) {
+			place(&Cell::entities, entities, entityId, x, y, PeerHandle{ nullptr, 0 });
+		}
+
+		bool removeEntity(uint64_t entityId) {
+			return unplace(&Cell::entities, entities, entityId);
+		}
+
+		// Adds the player, or moves them and refreshes their peer if they are already in the grid.
+		void setViewer(uint64_t uid, PeerHandle peer, float x, float y) {
+			place(&Cell::viewers, viewers, uid, x, y, peer);
+		}
+
+		bool removeViewer(uint64_t uid) {
+			return unplace(&Cell::viewers, viewers, uid);
+		}
+
+		// Replaces out with the peers of viewers within radius of the entity; out is left empty for an unknown entity.
+		void collectViewers(uint64_t entityId, std::vector<PeerHandle>& out) const;
+
+		// Replaces out with the entities within radius of the viewer.
+		void collectEntities(uint64_t uid, std::vector<uint64_t>& out) const;
+
+		size_t getEntityCount() const {
+			return entities.size();
+		}
+
+		size_t getViewerCount() const {
+			return viewers.size();
+		}
+
+		float getRadius() const {
+			return radius;
+		}
+
+		float getCellSize() const {
+			return cellSize;
+		}
+	};
+}
\ No newline at end of file
@@ -1,13 +1,18 @@
 #include "pch.h"
 #include "Logger.hpp"
+#include "ThreadUtils.hpp"
 
 namespace NetCoreServer {
 	std::thread Logger::loggerThread;
 	std::atomic<size_t> Logger::queueSize = 256;
+	ThreadPlacement Logger::placement;
 	std::atomic<bool> Logger::running = false;
 	std::unique_ptr<boost::lockfree::queue<std::string*>> Logger::logQueue = nullptr;
 
 	void Logger::process() {
+		ThreadUtils::setCurrentThreadName("nc-logger");
+		ThreadUtils::applyPlacement(placement);
+
 		while (running.load()) {
 			if (logQueue && !logQueue->empty()) {
 				std::string* logMessage = nullptr;
@@ -1,5 +1,6 @@
 #pragma once
 #include "pch.h"
+#include "NetCoreStructure.hpp"
 
 namespace NetCoreServer {
 	enum class LogColor {
@@ -18,6 +19,7 @@ namespace NetCoreServer {
 		static std::thread loggerThread;
 		static std::atomic<bool> running;
 		static std::atomic<size_t> queueSize;
+		static ThreadPlacement placement;
 
 		static std::unique_ptr<boost::lockfree::queue<std::string*>> logQueue;
 
@@ -31,6 +33,11 @@ namespace NetCoreServer {
 		static void setQueueSize(size_t size) {
 			queueSize = size;
 		}
+
+		// Takes effect on the next start().
+		static void setPlacement(ThreadPlacement threadPlacement) {
+			placement = std::move(threadPlacement);
+		}
 		static const std::string toColor(LogColor color);
 		static std::string getTimeString();
 
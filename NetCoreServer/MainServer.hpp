@@ -39,8 +39,8 @@ namespace NetCoreServer {
 		SessionManager sessionManager;
 
 	public:
-		MainServer(const LoginFunc& loginFunc, const UsernameProvider& provider, const SessionServerOption& opt, uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT)
-			: Server(port, max_connection, max_channel, queueSize, incomingBandwidth, outgoingBandwidth, bufferSize), sessionManager(opt, provider) {
+		MainServer(const LoginFunc& loginFunc, const UsernameProvider& provider, const SessionServerOption& opt, uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT, const ThreadPlacement& placement = ThreadPlacement{})
+			: Server(port, max_connection, max_channel, queueSize, incomingBandwidth, outgoingBandwidth, bufferSize, placement), sessionManager(opt, provider) {
 			auto loginHandler = std::make_shared<LoginHandler>(loginFunc);
 			registerPacketHandler("Login", loginHandler);
 			auto listHandler = std::make_shared<SessionListHandler>();
@@ -49,7 +49,9 @@ namespace NetCoreServer {
 			registerPacketHandler("CreateSession", creationHandler);
 		}
 
-		~MainServer() {}
+		~MainServer() {
+			stop();
+		}
 
 		HandlerId registerConnectionHandlerOnSessionServer(const std::function<void(ENetPeer*)>& handler) {
 			return sessionManager.registerConnectionHandler(handler);
@@ -87,6 +89,10 @@ namespace NetCoreServer {
 			sessionManager.registerSessionGenerator(sessionType, generator);
 		}
 
+		void registerSessionGenerator(std::string sessionType, SessionBatchPtr batch, SessionGenerator generator) {
+			sessionManager.registerSessionGenerator(sessionType, batch, generator);
+		}
+
 		void removeSessionGenerator(std::string sessionType) {
 			sessionManager.removeSessionGenerator(sessionType);
 		}
@@ -9,9 +9,13 @@
 
 // Session
 #include "AbstractSession.hpp"
+#include "SessionBatch.hpp"
+#include "InterestGrid.hpp"
 
 // Others
 #include "Logger.hpp"
+#include "ThreadUtils.hpp"
+#include "SlabAllocator.hpp"
 #include "Error.hpp"
 #include "Packet.hpp"
 #include "NetCoreStructure.hpp"
\ No newline at end of file
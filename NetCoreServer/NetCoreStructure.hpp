@@ -35,6 +35,7 @@ namespace NetCoreServer {
 		bool isPrivate;
 		bool hasPassword;
 		std::string authorName;
+		// Set from the creation option; getSessionList filters on it. identifier is filled in when a session server attaches the session.
 		std::string sessionType;
 
 		MSGPACK_DEFINE_ARRAY(name, identifier, maxPlayers, currentPlayers, isPrivate, hasPassword, authorName, sessionType);
@@ -85,6 +86,31 @@ namespace NetCoreServer {
 		LARGE = 1048576 // 1 MB
 	};
 
+	// Where a thread runs. Empty cores and a negative numaNode leave scheduling to the OS.
+	// When both are given, only cores on numaNode are used.
+	struct ThreadPlacement {
+		std::vector<uint32_t> cores;
+		int32_t numaNode = -1;
+
+		bool isDefault() const {
+			return cores.empty() && numaNode < 0;
+		}
+	};
+
+	// Slab allocator installed by initialize(). prefillBlocks blocks of every size class are carved
+	// for each host when its service thread starts.
+	struct AllocatorOption {
+		bool enabled = true;
+		size_t prefillBlocks = 64;
+	};
+
+	struct AllocatorStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t remoteFrees = 0;
+		uint64_t reservedBytes = 0;
+	};
+
 	struct SessionServerOption {
 		size_t maxConnection;
 		size_t maxChannel;
@@ -94,6 +120,19 @@ namespace NetCoreServer {
 		uint32_t incomingBandwidth = 0;
 		uint32_t outgoingBandwidth = 0;
 		int32_t bufferSize = BufferSize::DEFAULT;
+		ENetCongestionControl congestionControl = ENET_CONGESTION_CONTROL_THROTTLE;
+		// 0 keeps every peer at the MTU negotiated on connect.
+		uint32_t maximumMtu = 0;
+		// enet_crc64 picks the fastest implementation the CPU supports; nullptr sends no checksum.
+		ENetChecksumCallback checksum = nullptr;
+		bool connectCookies = false;
+		uint16_t maxConnectionsPerIp = ENET_PROTOCOL_MAXIMUM_PEER_ID;
+		// Per service iteration; 0 lifts the bound.
+		uint32_t receiveBudget = ENET_HOST_DEFAULT_RECEIVE_BUDGET;
+		uint32_t sendBudget = 0;
+		uint32_t peerDispatchLimit = 0;
+		// Session server i (and its session threads) uses placements[i % placements.size()].
+		std::vector<ThreadPlacement> placements = {};
 	};
 
 	struct LoginData final {
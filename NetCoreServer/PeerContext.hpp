@@ -0,0 +1,116 @@
+#pragma once
+#include "pch.h"
+#include "Packet.hpp"
+#include <shared_mutex>
+
+namespace NetCoreServer {
+	// A peer together with the context generation it was captured at; stale once the slot's context is reset.
+	struct PeerHandle {
+		ENetPeer* peer;
+		uint32_t generation;
+	};
+
+	typedef struct _QueuedPacket {
+		ENetPeer* peer;
+		uint32_t generation;
+		uint8_t channel;
+		Packet packet;
+		// Set for a broadcast, which goes to every target still on its generation; peer is then the one left out, if any.
+		std::shared_ptr<const std::vector<PeerHandle>> broadcastTargets;
+	} QueuedPacket;
+
+	// Per-connection state for a peer slot, found by the peer's index into the host's peer array.
+	// Contexts live as long as their server, so a stale read from another thread never dangles; generation tells it is stale.
+	struct PeerContext final {
+		static constexpr uint64_t NO_UID = std::numeric_limits<uint64_t>::max();
+		static constexpr int32_t NO_SESSION = -1;
+
+		std::atomic<uint64_t> uid{ NO_UID };
+		std::atomic<int32_t> sessionNumber{ NO_SESSION };
+		std::atomic<uint32_t> generation{ 0 };
+		// Set while a connection holds the slot.
+		std::atomic<bool> attached{ false };
+
+		std::atomic<uint64_t> packetsReceived{ 0 };
+		std::atomic<uint64_t> bytesReceived{ 0 };
+		std::atomic<uint64_t> packetsSent{ 0 };
+		std::atomic<uint64_t> bytesSent{ 0 };
+
+		// Bytes per second ENet last estimated it can send this peer, refreshed by the service thread.
+		std::atomic<uint32_t> bandwidthEstimate{ 0 };
+		// Largest datagram ENet currently sends this peer, raised as path MTU probes are confirmed.
+		std::atomic<uint32_t> mtu{ 0 };
+
+		// Packets queued from other threads, flushed by the service thread.
+		std::vector<QueuedPacket> outbound;
+
+		std::optional<uint64_t> getUid() const {
+			uint64_t value = uid.load(std::memory_order_acquire);
+			if (value == NO_UID) return std::nullopt;
+			return value;
+		}
+
+		std::optional<uint16_t> getSessionNumber() const {
+			int32_t value = sessionNumber.load(std::memory_order_acquire);
+			if (value == NO_SESSION) return std::nullopt;
+			return static_cast<uint16_t>(value);
+		}
+
+		void reset() {
+			uid.store(NO_UID, std::memory_order_release);
+			sessionNumber.store(NO_SESSION, std::memory_order_release);
+			generation.fetch_add(1, std::memory_order_acq_rel);
+			packetsReceived = 0;
+			bytesReceived = 0;
+			packetsSent = 0;
+			bytesSent = 0;
+			bandwidthEstimate = 0;
+			mtu = 0;
+			for (auto& queued : outbound) queued.packet.destory();
+			outbound.clear();
+		}
+	};
+
+	// uid -> peer index, split into shards by uid. Each shard has its own reader-writer lock, so a write touches one entry
+	// and blocks only readers of its shard.
+	class PeerIndex final {
+	private:
+		static constexpr size_t SHARD_BITS = 6;
+
+		struct alignas(64) Shard {
+			mutable std::shared_mutex mutex;
+			std::unordered_map<uint64_t, ENetPeer*> table;
+		};
+
+		std::array<Shard, size_t{ 1 } << SHARD_BITS> shards;
+
+		// Fibonacci hashing spreads sequential uids across the shards.
+		static size_t shardOf(uint64_t uid) {
+			return static_cast<size_t>((uid * 0x9E3779B97F4A7C15ull) >> (64 - SHARD_BITS));
+		}
+
+	public:
+		ENetPeer* find(uint64_t uid) const {
+			auto& shard = shards[shardOf(uid)];
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			auto it = shard.table.find(uid);
+			return it != shard.table.end() ? it->second : nullptr;
+		}
+
+		void set(uint64_t uid, ENetPeer* peer) {
+			auto& shard = shards[shardOf(uid)];
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			shard.table[uid] = peer;
+		}
+
+		// Erases only if uid still maps to peer, or unconditionally when peer is null.
+		bool erase(uint64_t uid, ENetPeer* peer = nullptr) {
+			auto& shard = shards[shardOf(uid)];
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			auto it = shard.table.find(uid);
+			if (it == shard.table.end() || (peer != nullptr && it->second != peer)) return false;
+			shard.table.erase(it);
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "pch.h"
+
+namespace NetCoreServer {
+	// Read-copy-update cell. Readers take an immutable snapshot without locking and may hold it as long as they like;
+	// writers are serialized, copy the current version, mutate the copy and publish it atomically.
+	template<typename T>
+	class Rcu final {
+	private:
+		std::atomic<std::shared_ptr<const T>> current;
+		std::mutex writeMutex;
+
+	public:
+		Rcu() : current(std::make_shared<const T>()) {
+		}
+
+		explicit Rcu(T value) : current(std::make_shared<const T>(std::move(value))) {
+		}
+
+		Rcu(const Rcu&) = delete;
+		Rcu& operator=(const Rcu&) = delete;
+
+		std::shared_ptr<const T> read() const {
+			return current.load(std::memory_order_acquire);
+		}
+
+		void publish(T value) {
+			std::lock_guard<std::mutex> lock(writeMutex);
+			current.store(std::make_shared<const T>(std::move(value)), std::memory_order_release);
+		}
+
+		template<typename Mutator>
+		auto update(Mutator&& mutator) {
+			std::lock_guard<std::mutex> lock(writeMutex);
+			auto next = std::make_shared<T>(*current.load(std::memory_order_acquire));
+			if constexpr (std::is_void_v<std::invoke_result_t<Mutator, T&>>) {
+				mutator(*next);
+				current.store(std::move(next), std::memory_order_release);
+			} else {
+				auto result = mutator(*next);
+				current.store(std::move(next), std::memory_order_release);
+				return result;
+			}
+		}
+	};
+}
\ No newline at end of file
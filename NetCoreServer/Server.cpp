@@ -2,8 +2,9 @@
 #include "Server.hpp"
 
 namespace NetCoreServer {
-	bool initialize() {
-		if (enet_initialize() != 0) {
+	bool initialize(const AllocatorOption& allocatorOption) {
+		bool initialized = allocatorOption.enabled ? SlabAllocator::install(allocatorOption) : enet_initialize() == 0;
+		if (!initialized) {
 			Logger::error("Failed to initialize ENet.");
 			return false;
 		}
@@ -27,45 +28,133 @@ namespace NetCoreServer {
 	}
 
 	ENetPeer* Server::getPeerByUid(uint64_t uid) const {
-		auto it = uidToPeerTable.find(uid);
-		if (it != uidToPeerTable.end()) {
-			return it->second;
-		}
-		return nullptr;
+		return uidToPeerIndex.find(uid);
+	}
+
+	void Server::setPeerUid(ENetPeer* peer, uint64_t uid) {
+		auto context = getPeerContext(peer);
+		if (context == nullptr) return;
+
+		auto previous = context->getUid();
+		if (previous.has_value() && *previous != uid) uidToPeerIndex.erase(*previous, peer);
+
+		context->uid.store(uid, std::memory_order_release);
+		uidToPeerIndex.set(uid, peer);
+	}
+
+	void Server::removePeer(uint64_t uid) {
+		auto peer = uidToPeerIndex.find(uid);
+		if (peer != nullptr) removePeerUid(peer);
 	}
 
 	bool Server::removePeerUid(ENetPeer* peer) {
-		auto it = peerToUidTable.find(peer);
-		if (it != peerToUidTable.end()) {
-			uint64_t uid = it->second;
-			peerToUidTable.erase(it);
-			uidToPeerTable.erase(uid);
+		auto context = getPeerContext(peer);
+		if (context == nullptr) return false;
+
+		auto uid = context->getUid();
+		if (uid.has_value()) {
+			context->uid.store(PeerContext::NO_UID, std::memory_order_release);
+			uidToPeerIndex.erase(*uid, peer);
 			return true;
 		}
 		return false;
 	}
 
 	std::optional<uint64_t> Server::getPeerUid(ENetPeer* peer) const {
-		auto it = peerToUidTable.find(peer);
-		if (it != peerToUidTable.end()) {
-			return it->second;
+		auto context = getPeerContext(peer);
+		if (context != nullptr) {
+			return context->getUid();
 		}
 		return std::nullopt;
 	}
 
+	void Server::attachPeerContext(ENetPeer* peer) {
+		auto& context = peerContexts[peer - server->peers];
+		context.reset();
+		context.attached.store(true, std::memory_order_release);
+	}
+
+	void Server::detachPeerContext(ENetPeer* peer) {
+		auto context = getPeerContext(peer);
+		if (context == nullptr) return;
+
+		removePeerUid(peer);
+		context->attached.store(false, std::memory_order_release);
+		context->reset();
+	}
+
+	void Server::flushOutbound() {
+		while (!packetQueue.empty()) {
+			QueuedPacket* qpacket;
+			if (packetQueue.pop(qpacket)) {
+				if (qpacket->broadcastTargets != nullptr) {
+					// Packets queued before the broadcast go out first, keeping each peer's order.
+					sendPendingOutbound();
+					broadcastPacket(std::move(qpacket->broadcastTargets), qpacket->channel, qpacket->packet, qpacket->peer);
+					delete qpacket;
+					continue;
+				}
+
+				auto context = getPeerContext(qpacket->peer);
+				if (context != nullptr && context->generation.load(std::memory_order_acquire) == qpacket->generation) {
+					if (context->outbound.empty()) pendingOutboundPeers.push_back(qpacket->peer);
+					context->outbound.push_back(*qpacket);
+				} else {
+					qpacket->packet.destory();
+				}
+				delete qpacket;
+			} else break;
+		}
+
+		sendPendingOutbound();
+	}
+
+	void Server::sendPendingOutbound() {
+		for (auto peer : pendingOutboundPeers) {
+			auto context = getPeerContext(peer);
+			if (context == nullptr) continue;
+
+			for (auto& queued : context->outbound) {
+				sendPacket(peer, queued.channel, queued.packet);
+			}
+			context->outbound.clear();
+		}
+		pendingOutboundPeers.clear();
+	}
+
 	void Server::run() {
+		serviceThreadId.store(std::this_thread::get_id());
+		ThreadUtils::setCurrentThreadName(std::format("nc-io-{}", getServerPort()));
+		if (!ThreadUtils::applyPlacement(placement)) {
+			Logger::warn(makeLog("Failed to apply thread placement to the service thread"));
+		}
+		SlabAllocator::bindCurrentThread(slabPool);
 		Logger::info(makeLog(std::format("Server started at port {}", getServerPort())));
 		while (running.load()) {
 			ENetEvent event;
+			enet_host_congestion_control(server, congestionControl.load());
+			enet_host_mtu_discovery(server, maximumMtu.load());
+			enet_host_set_checksum_callback(server, checksum.load());
+			enet_host_connect_cookies(server, connectCookies.load() ? cookieSecret.data() : nullptr);
+			enet_host_set_max_duplicate_peers(server, maxConnectionsPerIp.load());
+			enet_host_service_budget(server, receiveBudget.load(), sendBudget.load(), peerDispatchLimit.load());
 			while (enet_host_service(server, &event, timeout.load()) > 0) {
 				switch (event.type) {
 				case ENET_EVENT_TYPE_CONNECT:
+					attachPeerContext(event.peer);
 					for (auto& handler : onConnectionHandlers) {
 						handler.second(event.peer);
 					}
 					Logger::info(makeLog(std::format("A new client connected from {}", getPeerIP(event.peer))));
 					break;
 				case ENET_EVENT_TYPE_RECEIVE: {
+					if (auto context = getPeerContext(event.peer)) {
+						context->packetsReceived.fetch_add(1, std::memory_order_relaxed);
+						context->bytesReceived.fetch_add(event.packet->dataLength, std::memory_order_relaxed);
+						context->bandwidthEstimate.store(enet_peer_get_bandwidth_estimate(event.peer), std::memory_order_relaxed);
+						context->mtu.store(enet_peer_get_mtu(event.peer), std::memory_order_relaxed);
+					}
+
 					for (auto& handler : onPacketReceivedHandlers) {
 						handler.second(event.peer, event.packet);
 					}
@@ -88,21 +177,14 @@ namespace NetCoreServer {
 						handler.second(event.peer);
 					}
 					Logger::info(makeLog(std::format("A client disconnected from {}", getPeerIP(event.peer))));
+					detachPeerContext(event.peer);
 					break;
 				default:
 					break;
 				}
 			}
 
-			while (!packetQueue.empty()) {
-				QueuedPacket* qpacket;
-				if (packetQueue.pop(qpacket)) {
-
-
-					qpacket->packet.destory();
-					delete qpacket;
-				} else break;
-			}
+			flushOutbound();
 		}
 	}
 
@@ -119,12 +201,64 @@ namespace NetCoreServer {
 	}
 
 	void Server::sendPacket(ENetPeer* peer, uint8_t channel, Packet packet) {
-		if (peer && server) {
-			enet_peer_send(peer, channel, packet.enetPacket);
+		auto context = getPeerContext(peer);
+		if (peer && server && context) {
+			if (std::this_thread::get_id() != serviceThreadId.load()) {
+				// ENet is not thread-safe; hand the packet to the service thread.
+				packetQueue.push(new QueuedPacket{ peer, context->generation.load(std::memory_order_acquire), channel, packet, nullptr });
+				return;
+			}
+
+			size_t length = packet.enetPacket->dataLength;
+			if (enet_peer_send(peer, channel, packet.enetPacket) == 0) {
+				context->packetsSent.fetch_add(1, std::memory_order_relaxed);
+				context->bytesSent.fetch_add(length, std::memory_order_relaxed);
+				context->bandwidthEstimate.store(enet_peer_get_bandwidth_estimate(peer), std::memory_order_relaxed);
+				context->mtu.store(enet_peer_get_mtu(peer), std::memory_order_relaxed);
+			} else if (packet.enetPacket->referenceCount == 0) {
+				packet.destory();
+			}
 		} else {
-			Logger::error(makeLog(format("Failed to send packet: Invalid peer or server. (Peer: {})", getPeerIP(peer))));
+			Logger::error(makeLog(format("Failed to send packet: Invalid peer or server. (Peer: {})", peer ? getPeerIP(peer) : "null")));
+			packet.destory();
 		}
-	}	
+	}
+
+	std::optional<PeerHandle> Server::getPeerHandle(ENetPeer* peer) const {
+		auto context = getPeerContext(peer);
+		if (context == nullptr) return std::nullopt;
+		return PeerHandle{ peer, context->generation.load(std::memory_order_acquire) };
+	}
+
+	void Server::broadcastPacket(std::shared_ptr<const std::vector<PeerHandle>> targets, uint8_t channel, Packet packet, ENetPeer* excluded) {
+		if (!server || targets == nullptr) {
+			packet.destory();
+			return;
+		}
+
+		if (std::this_thread::get_id() != serviceThreadId.load()) {
+			packetQueue.push(new QueuedPacket{ excluded, 0, channel, packet, std::move(targets) });
+			return;
+		}
+
+		size_t length = packet.enetPacket->dataLength;
+		broadcastPeers.clear();
+		for (auto& target : *targets) {
+			if (target.peer == excluded) continue;
+
+			auto context = getPeerContext(target.peer);
+			if (context == nullptr || context->generation.load(std::memory_order_acquire) != target.generation) continue;
+
+			broadcastPeers.push_back(target.peer);
+			context->packetsSent.fetch_add(1, std::memory_order_relaxed);
+			context->bytesSent.fetch_add(length, std::memory_order_relaxed);
+			context->bandwidthEstimate.store(enet_peer_get_bandwidth_estimate(target.peer), std::memory_order_relaxed);
+			context->mtu.store(enet_peer_get_mtu(target.peer), std::memory_order_relaxed);
+		}
+
+		// Destroys the packet itself when no target is left.
+		enet_host_broadcast_selective(server, channel, packet.enetPacket, broadcastPeers.data(), broadcastPeers.size());
+	}
 
 	void ServerTypePacketHandler::handle(Server& server, ENetPeer* peer) {
 		auto packet = PacketUtils::createPacket("GetServerType", server.getServerType(), ENetPacketFlag::ENET_PACKET_FLAG_RELIABLE);
@@ -5,14 +5,12 @@
 #include "Packet.hpp"
 #include "AbstractHandler.hpp"
 #include "NetCoreStructure.hpp"
+#include "PeerContext.hpp"
+#include "ThreadUtils.hpp"
+#include "SlabAllocator.hpp"
 
 namespace NetCoreServer {
-	bool initialize();
-
-	typedef struct _QueuedPacket {
-		uint8_t channel;
-		Packet packet;
-	} QueuedPacket;
+	bool initialize(const AllocatorOption& allocatorOption = AllocatorOption{});
 
 	class Server;
 
@@ -50,10 +48,24 @@ namespace NetCoreServer {
 		ENetAddress address;
 		ENetHost* server;
 
+		ThreadPlacement placement;
+		// Started only for a non-default placement; runs host and session construction on the placement's node.
+		std::unique_ptr<PlacedWorker> placedWorker;
+		SlabPool* slabPool;
 		std::thread serverThread;
+		std::atomic<std::thread::id> serviceThreadId;
 
 		std::atomic<uint32_t> timeout;
 		std::atomic<bool> running;
+		std::atomic<ENetCongestionControl> congestionControl{ ENET_CONGESTION_CONTROL_THROTTLE };
+		std::atomic<uint32_t> maximumMtu{ 0 };
+		std::atomic<ENetChecksumCallback> checksum{ nullptr };
+		std::atomic<bool> connectCookies{ false };
+		std::atomic<uint16_t> maxConnectionsPerIp{ ENET_PROTOCOL_MAXIMUM_PEER_ID };
+		std::atomic<uint32_t> receiveBudget{ ENET_HOST_DEFAULT_RECEIVE_BUDGET };
+		std::atomic<uint32_t> sendBudget{ 0 };
+		std::atomic<uint32_t> peerDispatchLimit{ 0 };
+		std::array<uint8_t, 16> cookieSecret{};
 
 		boost::lockfree::queue<QueuedPacket*> packetQueue;
 		std::unordered_map<uint64_t, ENetPeer*> connectedPeers;
@@ -66,13 +78,19 @@ namespace NetCoreServer {
 		std::unordered_map<HandlerId, std::function<void(ENetPeer*)>> onDisconnectionHandlers;
 		std::unordered_map<HandlerId, std::function<void(ENetPeer*, ENetPacket*)>> onPacketReceivedHandlers;
 
-		std::unordered_map<ENetPeer*, uint64_t> peerToUidTable;
-		std::unordered_map<uint64_t, ENetPeer*> uidToPeerTable;
+		std::unique_ptr<PeerContext[]> peerContexts;
+		PeerIndex uidToPeerIndex;
+		std::vector<ENetPeer*> pendingOutboundPeers;
+		std::vector<ENetPeer*> broadcastPeers;
 
-		uint8_t sessionChannel;
+		uint8_t sessionChannel = 0;
 		ENetPacketFlag sessionPacketFlag = ENET_PACKET_FLAG_RELIABLE;
 
 		void run();
+		void attachPeerContext(ENetPeer* peer);
+		void detachPeerContext(ENetPeer* peer);
+		void flushOutbound();
+		void sendPendingOutbound();
 
 	protected:
 		template<typename T>
@@ -88,11 +106,24 @@ namespace NetCoreServer {
 		}
 
 	public:
-		Server(uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT)
-			: address({ ENET_HOST_ANY, port }), packetQueue(queueSize) {
-			server = enet_host_create(&address, max_connection, max_channel, incomingBandwidth, outgoingBandwidth, bufferSize);
+		Server(uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT, const ThreadPlacement& placement = ThreadPlacement{})
+			: address({ ENET_HOST_ANY, port }), placement(placement), slabPool(SlabAllocator::acquirePool()), packetQueue(queueSize) {
+			if (!placement.isDefault()) placedWorker = std::make_unique<PlacedWorker>(placement, std::format("nc-place-{}", port));
+			// Create the host from the placed thread so its buffers are first touched on that node.
+			server = invokeOnNode([&]() {
+				return enet_host_create(&address, max_connection, max_channel, incomingBandwidth, outgoingBandwidth, bufferSize);
+				});
+
+			if (!server) {
+				SlabAllocator::releasePool(slabPool);
+				throw ServerCreationError();
+			}
 
-			if (!server) throw ServerCreationError();
+			peerContexts = std::make_unique<PeerContext[]>(server->peerCount);
+
+			// Cookies only have to stay valid for the life of this host, so each host draws its own secret.
+			std::random_device device;
+			for (auto& byte : cookieSecret) byte = static_cast<uint8_t>(device());
 
 			running = true;
 			serverThread = std::thread(&Server::run, this);
@@ -102,9 +133,14 @@ namespace NetCoreServer {
 		}
 
 		~Server() {
+			// The service thread allocates from slabPool and frees into it; it must be gone before the host is destroyed
+			// and the pool goes back to the idle list, where another server can bind it.
+			stop();
 			if (server) {
+				for (size_t i = 0; i < server->peerCount; i++) peerContexts[i].reset();
 				enet_host_destroy(server);
 			}
+			SlabAllocator::releasePool(slabPool);
 		}
 
 		std::string makeLog(std::string content) {
@@ -121,25 +157,131 @@ namespace NetCoreServer {
 			return address.port;
 		}
 
+		const ThreadPlacement& getPlacement() const {
+			return placement;
+		}
+
+		// Runs func on this server's placed worker and waits for it, or inline when the placement is the default.
+		template<typename Func>
+		auto invokeOnNode(Func&& func) -> decltype(func()) {
+			return placedWorker != nullptr ? placedWorker->invoke(std::forward<Func>(func)) : func();
+		}
+
+		// Zeroed when the slab allocator is disabled.
+		AllocatorStats getAllocatorStats() const {
+			return slabPool != nullptr ? slabPool->getStats() : AllocatorStats{};
+		}
+
+		// Peer slots are committed as peers connect, so usedBytes tracks load rather than max_connection.
+		// Reads host state; call it from the service thread, e.g. inside a handler.
+		ENetHostMemoryUsage getMemoryUsage() const {
+			ENetHostMemoryUsage usage{};
+			if (server) enet_host_get_memory_usage(server, &usage);
+			return usage;
+		}
+
 		static std::string getPeerIP(ENetPeer* peer);
 
 		void setTimeout(uint32_t timeout = 50) {
 			this->timeout = timeout;
 		}
 
-		void setPeerUid(ENetPeer* peer, uint64_t uid) {
-			peerToUidTable[peer] = uid;
-			uidToPeerTable[uid] = peer;
+		// Applied by the service thread before its next service call; set it before peers connect.
+		void setCongestionControl(ENetCongestionControl control) {
+			congestionControl = control;
 		}
 
-		void removePeer(uint64_t uid) {
-			if (uidToPeerTable.contains(uid)) {
-				auto peer = uidToPeerTable[uid];
-				peerToUidTable.erase(peer);
-				uidToPeerTable.erase(uid);
-			}
+		ENetCongestionControl getCongestionControl() const {
+			return congestionControl.load();
 		}
 
+		// Probes each peer's path up to maximumMtu, or disables probing with 0; set it before peers connect.
+		void setMtuDiscovery(uint32_t maximumMtu) {
+			this->maximumMtu = maximumMtu;
+		}
+
+		uint32_t getMtuDiscovery() const {
+			return maximumMtu.load();
+		}
+
+		// Checksums every datagram with callback, e.g. enet_crc64, or disables checksums with nullptr.
+		// Clients must use the same checksum; set it before peers connect.
+		void setChecksum(ENetChecksumCallback callback) {
+			checksum = callback;
+		}
+
+		ENetChecksumCallback getChecksum() const {
+			return checksum.load();
+		}
+
+		// Challenges each connect with a cookie before committing a peer slot, so spoofed connects cannot fill the host.
+		// Clients must be built against an ENet that answers the challenge.
+		void setConnectCookies(bool enabled) {
+			connectCookies = enabled;
+		}
+
+		bool getConnectCookies() const {
+			return connectCookies.load();
+		}
+
+		// Connections accepted from one IP address at a time.
+		void setMaxConnectionsPerIp(uint16_t count) {
+			maxConnectionsPerIp = count;
+		}
+
+		uint16_t getMaxConnectionsPerIp() const {
+			return maxConnectionsPerIp.load();
+		}
+
+		// Datagrams read from the socket before the service thread sends and dispatches again; 0 reads until the socket is empty.
+		void setReceiveBudget(uint32_t budget) {
+			receiveBudget = budget;
+		}
+
+		uint32_t getReceiveBudget() const {
+			return receiveBudget.load();
+		}
+
+		// Datagrams sent per pass over the peers with data waiting; the next pass starts with the peers left over. 0 is unlimited.
+		void setSendBudget(uint32_t budget) {
+			sendBudget = budget;
+		}
+
+		uint32_t getSendBudget() const {
+			return sendBudget.load();
+		}
+
+		// Packets handed to handlers from one peer before it waits for the next service iteration, so a chatty peer
+		// cannot hold up the other peers' packets, sends or timeouts. 0 is unlimited.
+		void setPeerDispatchLimit(uint32_t limit) {
+			peerDispatchLimit = limit;
+		}
+
+		uint32_t getPeerDispatchLimit() const {
+			return peerDispatchLimit.load();
+		}
+
+		// Counts the times a budget or the dispatch limit cut a service pass short.
+		// Reads host state; call it from the service thread, e.g. inside a handler.
+		ENetHostBudgetStats getBudgetStats() const {
+			ENetHostBudgetStats stats{};
+			if (server) enet_host_get_budget_stats(server, &stats);
+			return stats;
+		}
+
+		// Safe from any thread: the context is found by slot rather than through the peer, which the service thread rewrites.
+		// A context found off the service thread may be reattached before it is used; compare its generation to tell.
+		PeerContext* getPeerContext(ENetPeer* peer) const {
+			if (peer == nullptr || server == nullptr || peer < server->peers || peer >= server->peers + server->peerCount) return nullptr;
+
+			auto context = &peerContexts[peer - server->peers];
+			return context->attached.load(std::memory_order_acquire) ? context : nullptr;
+		}
+
+		void setPeerUid(ENetPeer* peer, uint64_t uid);
+
+		void removePeer(uint64_t uid);
+
 		std::string getServerIP() const {
 			char ip[16] = { 0, };
 			enet_address_get_ip(&address, ip, sizeof(ip));
@@ -231,5 +373,11 @@ namespace NetCoreServer {
 		}
 
 		void sendPacket(ENetPeer* peer, uint8_t channel, Packet packet);
+
+		// Handle for a connected peer, to be captured once and passed to broadcastPacket.
+		std::optional<PeerHandle> getPeerHandle(ENetPeer* peer) const;
+
+		// Sends one packet, shared by reference, to every target still connected as captured, except excluded.
+		void broadcastPacket(std::shared_ptr<const std::vector<PeerHandle>> targets, uint8_t channel, Packet packet, ENetPeer* excluded = nullptr);
 	};
 }
\ No newline at end of file
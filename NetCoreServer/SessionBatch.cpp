@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "SessionBatch.hpp"
+#include "Logger.hpp"
+
+namespace NetCoreServer {
+	void AbstractSessionBatch::start() {
+		if (running.exchange(true)) return;
+
+		batchThread = std::thread(&AbstractSessionBatch::run, this);
+	}
+
+	void AbstractSessionBatch::stop() {
+		if (running.exchange(false)) {
+			if (batchThread.joinable()) batchThread.join();
+		}
+	}
+
+	void AbstractSessionBatch::run() {
+		ThreadUtils::setCurrentThreadName("nc-batch");
+		ThreadUtils::applyPlacement(placement);
+
+		const auto tickInterval = std::chrono::duration<double>(1.0 / framerate);
+		auto previous = std::chrono::steady_clock::now();
+		auto nextTick = previous + tickInterval;
+
+		while (running.load()) {
+			auto now = std::chrono::steady_clock::now();
+			std::chrono::duration<double> deltaTime = now - previous;
+			previous = now;
+
+			// One failed tick must not take every session of the type down with the thread.
+			try {
+				tickAll(deltaTime.count());
+			} catch (const std::exception& e) {
+				Logger::error(std::format("A session batch tick failed: {}", e.what()));
+			}
+
+			nextTick += tickInterval;
+			if (std::chrono::steady_clock::now() < nextTick) {
+				std::this_thread::sleep_until(nextTick);
+			} else {
+				nextTick = std::chrono::steady_clock::now();
+			}
+		}
+	}
+}
\ No newline at end of file
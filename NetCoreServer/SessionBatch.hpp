@@ -0,0 +1,264 @@
+#pragma once
+#include "pch.h"
+#include "AbstractSession.hpp"
+#include "ThreadUtils.hpp"
+
+namespace NetCoreServer {
+	class SessionServer;
+
+	// Drives every session of one session type from a single thread.
+	// Per-session state lives in contiguous storage owned by the batch, so one tick is one call over all of it.
+	class AbstractSessionBatch {
+	private:
+		friend class SessionServer;
+
+		const double framerate;
+		const ThreadPlacement placement;
+
+		std::atomic<bool> running;
+		std::thread batchThread;
+
+		void run();
+
+	protected:
+		mutable std::mutex batchMutex;
+		// tickBatch runs without batchMutex held; while ticking is set, attach/detach queue their change instead of reshaping the storage.
+		bool ticking = false;
+		std::thread::id tickingThread;
+
+		virtual bool attach(AbstractSession* session) = 0;
+		// Never waits on a running tick; a detach from another thread takes effect when it ends, and the batch keeps the session alive until then.
+		virtual bool detach(std::shared_ptr<AbstractSession> session) = 0;
+		virtual void tickAll(double deltaTime) = 0;
+
+		static void sendPacket(AbstractSession& session, uint64_t uid, uint8_t channel, Packet packet) {
+			session.sendPacket(uid, channel, packet);
+		}
+
+		static void sendPacket(AbstractSession& session, ENetPeer* peer, uint8_t channel, Packet packet) {
+			session.sendPacket(peer, channel, packet);
+		}
+
+		static void broadcast(AbstractSession& session, uint8_t channel, Packet packet) {
+			session.broadcast(channel, packet);
+		}
+
+		static void broadcastExcept(AbstractSession& session, uint64_t uid, uint8_t channel, Packet packet) {
+			session.broadcastExcept(uid, channel, packet);
+		}
+
+		static void broadcastExcept(AbstractSession& session, ENetPeer* peer, uint8_t channel, Packet packet) {
+			session.broadcastExcept(peer, channel, packet);
+		}
+
+		static void sendToInterested(AbstractSession& session, const InterestGrid& grid, uint64_t entityId, uint8_t channel, Packet packet, ENetPeer* excluded = nullptr) {
+			session.sendToInterested(grid, entityId, channel, packet, excluded);
+		}
+
+		static std::optional<PeerHandle> getPlayerHandle(const AbstractSession& session, uint64_t uid) {
+			return session.getPlayerHandle(uid);
+		}
+
+	public:
+		AbstractSessionBatch(const double framerate, ThreadPlacement placement = ThreadPlacement{})
+			: framerate(framerate), placement(std::move(placement)), running(false) {
+		}
+		// The batch thread calls into the derived batch, which is already gone by the time this runs,
+		// so whoever owns the batch must stop() it before releasing it.
+		virtual ~AbstractSessionBatch() {
+			assert(!running.load() && "stop() a session batch before destroying it");
+		}
+
+		double getFramerate() const {
+			return framerate;
+		}
+
+		bool isRunning() const {
+			return running.load();
+		}
+
+		virtual size_t getSessionsCount() const = 0;
+
+		void start();
+		void stop();
+	};
+
+	template<typename State>
+	class SessionBatch;
+
+	template<typename State>
+	class BatchSession : public AbstractSession {
+	private:
+		friend class SessionBatch<State>;
+
+		SessionBatch<State>* batch = nullptr;
+		size_t index = 0;
+		State initialState;
+
+	public:
+		BatchSession(SessionInfo info, const SessionCreationOption& opt, State initialState = State{})
+			: AbstractSession(std::move(info), opt, 0.0), initialState(std::move(initialState)) {
+		}
+
+		// Batch sessions are ticked through SessionBatch::tickBatch.
+		void tick(double) override final {}
+
+		// Only safe from the batch thread or while the session is not attached.
+		State& getState() {
+			return batch != nullptr ? batch->states[index] : initialState;
+		}
+
+		size_t getBatchIndex() const {
+			return index;
+		}
+	};
+
+	template<typename State>
+	class SessionBatch : public AbstractSessionBatch {
+	private:
+		friend class BatchSession<State>;
+
+		std::vector<State> states;
+		std::vector<BatchSession<State>*> members;
+
+		// Changes requested while a tick is running, applied once it returns.
+		std::vector<BatchSession<State>*> pendingAttach;
+		std::vector<std::shared_ptr<BatchSession<State>>> pendingDetach;
+		size_t vacated = 0;
+
+		void append(BatchSession<State>* member) {
+			member->index = states.size();
+			states.push_back(std::move(member->initialState));
+			members.push_back(member);
+			member->batch = this;
+		}
+
+		void remove(size_t idx) {
+			size_t last = members.size() - 1;
+			if (idx != last) {
+				states[idx] = std::move(states[last]);
+				members[idx] = members[last];
+				members[idx]->index = idx;
+			}
+			states.pop_back();
+			members.pop_back();
+		}
+
+		// Hands the state back to the session and frees its slot, or only clears the slot while a tick is walking the storage.
+		void release(BatchSession<State>* member) {
+			size_t idx = member->index;
+			member->initialState = std::move(states[idx]);
+			member->batch = nullptr;
+			if (ticking) {
+				members[idx] = nullptr;
+				vacated++;
+			} else {
+				remove(idx);
+			}
+		}
+
+		bool isMember(const BatchSession<State>* member) const {
+			return member->batch == this && member->index < members.size() && members[member->index] == member;
+		}
+
+		// Returns the sessions detached from other threads during the tick, to be released once batchMutex is.
+		std::vector<std::shared_ptr<BatchSession<State>>> applyPending() {
+			// Walking down keeps every slot above idx occupied, so the one swapped in is never vacated.
+			for (size_t idx = members.size(); vacated > 0 && idx-- > 0;) {
+				if (members[idx] == nullptr) {
+					remove(idx);
+					vacated--;
+				}
+			}
+			for (auto& member : pendingDetach) release(member.get());
+			for (auto member : pendingAttach) append(member);
+			pendingAttach.clear();
+			return std::move(pendingDetach);
+		}
+
+	protected:
+		bool attach(AbstractSession* session) override {
+			auto member = dynamic_cast<BatchSession<State>*>(session);
+			if (member == nullptr) return false;
+
+			std::lock_guard<std::mutex> lock(batchMutex);
+			if (ticking) {
+				pendingAttach.push_back(member);
+			} else {
+				append(member);
+			}
+			return true;
+		}
+
+		bool detach(std::shared_ptr<AbstractSession> session) override {
+			auto member = std::dynamic_pointer_cast<BatchSession<State>>(std::move(session));
+			if (member == nullptr) return false;
+
+			std::lock_guard<std::mutex> lock(batchMutex);
+			auto pending = std::find(pendingAttach.begin(), pendingAttach.end(), member.get());
+			if (pending != pendingAttach.end()) {
+				pendingAttach.erase(pending);
+				return true;
+			}
+
+			if (!isMember(member.get())) return false;
+			if (std::find(pendingDetach.begin(), pendingDetach.end(), member) != pendingDetach.end()) return false;
+
+			// Another thread may not pull a slot out from under a running tick, so the session stays in it, held here, until the tick ends.
+			if (ticking && std::this_thread::get_id() != tickingThread) {
+				pendingDetach.push_back(std::move(member));
+			} else {
+				// Detached from inside tickBatch, the slot stays in place, empty, until the tick returns.
+				release(member.get());
+			}
+			return true;
+		}
+
+		void tickAll(double deltaTime) override {
+			{
+				std::lock_guard<std::mutex> lock(batchMutex);
+				if (states.empty()) return;
+				ticking = true;
+				tickingThread = std::this_thread::get_id();
+			}
+
+			// Ends the tick even when tickBatch throws, or sessions detached meanwhile would never leave the batch.
+			struct TickEnd {
+				SessionBatch& batch;
+				~TickEnd() {
+					// Dropped after the lock, since the last reference to a session may be the one held here.
+					std::vector<std::shared_ptr<BatchSession<State>>> detached;
+					{
+						std::lock_guard<std::mutex> lock(batch.batchMutex);
+						batch.ticking = false;
+						detached = batch.applyPending();
+					}
+				}
+			} tickEnd{ *this };
+
+			tickBatch(std::span<State>(states), deltaTime);
+		}
+
+		// states[i] belongs to getSession(i) for the duration of tickBatch.
+		// A session that detaches itself mid-tick keeps a moved-from state slot until the tick returns; skip it with isAttached.
+		BatchSession<State>& getSession(size_t index) {
+			return *members[index];
+		}
+
+		bool isAttached(size_t index) const {
+			return members[index] != nullptr;
+		}
+
+		virtual void tickBatch(std::span<State> states, double deltaTime) = 0;
+
+	public:
+		SessionBatch(const double framerate, ThreadPlacement placement = ThreadPlacement{})
+			: AbstractSessionBatch(framerate, std::move(placement)) {
+		}
+
+		size_t getSessionsCount() const override {
+			std::lock_guard<std::mutex> lock(batchMutex);
+			return members.size() - vacated - pendingDetach.size() + pendingAttach.size();
+		}
+	};
+}
\ No newline at end of file
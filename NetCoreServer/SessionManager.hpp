@@ -2,22 +2,32 @@
 #include "pch.h"
 #include "SessionServer.hpp"
 #include "AbstractSession.hpp"
+#include "SessionBatch.hpp"
 
 namespace NetCoreServer {
 	using SessionPtr = std::shared_ptr<AbstractSession>;
+	using SessionBatchPtr = std::shared_ptr<AbstractSessionBatch>;
 	using SessionGenerator = std::function<SessionPtr(const SessionInfo&, const SessionCreationOption&)>;
 	using UsernameProvider = std::function<std::string(uint64_t)>;
 
 	template<typename SessionType>
 	concept IsSession = std::is_base_of_v<AbstractSession, SessionType>;
+	struct SessionServerEntry final {
+		std::string sessionType;
+		std::shared_ptr<SessionServer> server;
+	};
+
 	class SessionManager {
 	private:
-		std::vector<std::shared_ptr<SessionServer>> sessionServers;
-		std::vector<std::string> sessionTypes;
+		Rcu<std::vector<SessionServerEntry>> sessionServers;
+		std::mutex creationMutex;
 		SessionServerOption sessionServerOption;
 		UsernameProvider usernameProvider;
 
 		std::unordered_map<std::string, SessionGenerator> sessionGenerators;
+		std::unordered_map<std::string, SessionBatchPtr> sessionBatches;
+		// Batches replaced by a later registration; their sessions still tick on them until they end.
+		std::vector<SessionBatchPtr> retiredBatches;
 
 		static HandlerId eventHandlerNextId;
 
@@ -37,10 +47,26 @@ namespace NetCoreServer {
 			return handlers.erase(id) > 0;
 		}
 
+		void retireSessionBatch(const std::string& sessionType) {
+			auto it = sessionBatches.find(sessionType);
+			if (it == sessionBatches.end()) return;
+			retiredBatches.push_back(std::move(it->second));
+			sessionBatches.erase(it);
+		}
+
 	public:
 		SessionManager(SessionServerOption opt, UsernameProvider provider) : sessionServerOption(std::move(opt)), usernameProvider(std::move(provider)) {
 		}
 
+		~SessionManager() {
+			for (auto& batch : sessionBatches) {
+				batch.second->stop();
+			}
+			for (auto& batch : retiredBatches) {
+				batch->stop();
+			}
+		}
+
 		HandlerId registerConnectionHandler(const std::function<void(ENetPeer*)>& handler) {
 			return registerHandler(onConnectionHandlers, handler);
 		}
@@ -66,6 +92,18 @@ namespace NetCoreServer {
 		}
 
 		void registerSessionGenerator(std::string sessionType, SessionGenerator generator) {
+			std::lock_guard<std::mutex> lock(creationMutex);
+			retireSessionBatch(sessionType);
+			sessionGenerators[sessionType] = std::move(generator);
+		}
+
+		// Sessions made by the generator must derive from BatchSession<State> of the batch's state type.
+		// The manager stops the batch when it is destroyed.
+		void registerSessionGenerator(std::string sessionType, SessionBatchPtr batch, SessionGenerator generator) {
+			std::lock_guard<std::mutex> lock(creationMutex);
+			retireSessionBatch(sessionType);
+			batch->start();
+			sessionBatches[sessionType] = std::move(batch);
 			sessionGenerators[sessionType] = std::move(generator);
 		}
 
@@ -74,6 +112,7 @@ namespace NetCoreServer {
 		}
 
 		SessionCreationResult createNewSession(const SessionCreationOption& opt) {
+			std::lock_guard<std::mutex> lock(creationMutex);
 			SessionCreationResult result;
 			if (sessionGenerators.contains(opt.sessionType)) {
 				SessionInfo info = {
@@ -83,60 +122,82 @@ namespace NetCoreServer {
 					0,
 					opt.isPrivate,
 					opt.password.has_value(),
-					usernameProvider(opt.userIdentifier.userId)
+					usernameProvider(opt.userIdentifier.userId),
+					opt.sessionType
 				};
 
-				std::shared_ptr<AbstractSession> session = sessionGenerators[opt.sessionType](info, opt);
+				SessionBatchPtr batch = sessionBatches.contains(opt.sessionType) ? sessionBatches[opt.sessionType] : nullptr;
 
-				for (uint16_t i = 0; i < sessionServers.size(); i++) {
-					if (sessionTypes[i] == opt.sessionType && sessionServers[i]->getSessionsCount() < sessionServerOption.maxSessions) {
-						session->server = sessionServers[i];
-						info.identifier.sessionNumber = sessionServers[i]->attachSession(session);
-						info.identifier.sessionPort = sessionServers[i]->getServerPort();
-
-						result.success = true;
-						result.errorCode = 0;
-						result.sessionInfo = info;
+				std::shared_ptr<SessionServer> target;
+				auto servers = sessionServers.read();
+				for (auto& entry : *servers) {
+					if (entry.sessionType == opt.sessionType && entry.server->getSessionsCount() < sessionServerOption.maxSessions) {
+						target = entry.server;
+						break;
+					}
+				}
 
+				if (target == nullptr) {
+					auto size = static_cast<uint16_t>(servers->size());
+					if (size >= sessionServerOption.maxSessions) {
+						result.success = false;
+						result.errorCode = 2;
 						return result;
 					}
+
+					auto& placements = sessionServerOption.placements;
+					target = std::make_shared<SessionServer>(
+						sessionServerOption.portRange.first + size,
+						sessionServerOption.maxConnection,
+						sessionServerOption.maxChannel,
+						sessionServerOption.queueSize,
+						sessionServerOption.incomingBandwidth,
+						sessionServerOption.outgoingBandwidth,
+						sessionServerOption.bufferSize,
+						placements.empty() ? ThreadPlacement{} : placements[size % placements.size()]
+					);
+					target->setCongestionControl(sessionServerOption.congestionControl);
+					target->setMtuDiscovery(sessionServerOption.maximumMtu);
+					target->setChecksum(sessionServerOption.checksum);
+					target->setConnectCookies(sessionServerOption.connectCookies);
+					target->setMaxConnectionsPerIp(sessionServerOption.maxConnectionsPerIp);
+					target->setReceiveBudget(sessionServerOption.receiveBudget);
+					target->setSendBudget(sessionServerOption.sendBudget);
+					target->setPeerDispatchLimit(sessionServerOption.peerDispatchLimit);
+
+					for (auto& handler : onConnectionHandlers)
+						target->registerConnectionHandler(handler.second);
+
+					for (auto& handler : onDisconnectionHandlers)
+						target->registerDisconnectionHandler(handler.second);
+
+					for (auto& handler : onPacketReceivedHandlers)
+						target->registerPacketReceivedHandler(handler.second);
+
+					sessionServers.update([&](auto& entries) {
+						entries.push_back(SessionServerEntry{ opt.sessionType, target });
+						});
 				}
 
-				auto size = static_cast<uint16_t>(sessionServers.size());
-				if (size >= sessionServerOption.maxSessions) {
+				// Construct the session on the server's node so its state is allocated there.
+				std::shared_ptr<AbstractSession> session = target->invokeOnNode([&]() {
+					return sessionGenerators[opt.sessionType](info, opt);
+					});
+
+				// Set before attachSession starts ticking it, since a session reaches its players through the server from the first tick.
+				session->server = target;
+				try {
+					target->attachSession(session, batch);
+				} catch (const SessionAttachError& error) {
+					Logger::error(target->makeLog(error.what()));
 					result.success = false;
-					result.errorCode = 2;
+					result.errorCode = 3;
 					return result;
 				}
 
-				auto newServer = std::make_shared<SessionServer>(
-					sessionServerOption.portRange.first + size,
-					sessionServerOption.maxConnection,
-					sessionServerOption.maxChannel,
-					sessionServerOption.queueSize,
-					sessionServerOption.incomingBandwidth,
-					sessionServerOption.outgoingBandwidth,
-					sessionServerOption.bufferSize
-				);
-
-				for (auto& handler : onConnectionHandlers)
-					newServer->registerConnectionHandler(handler.second);
-
-				for (auto& handler : onDisconnectionHandlers)
-					newServer->registerDisconnectionHandler(handler.second);
-
-				for (auto& handler : onPacketReceivedHandlers)
-					newServer->registerPacketReceivedHandler(handler.second);
-
-				info.identifier.sessionPort = newServer->getServerPort();
-				newServer->attachSession(session);
-
-				sessionServers.push_back(newServer);
-				sessionTypes.push_back(opt.sessionType);
-
 				result.success = true;
 				result.errorCode = 0;
-				result.sessionInfo = info;
+				result.sessionInfo = session->getSessionInfo();
 			} else {
 				result.success = false;
 				result.errorCode = 1;
@@ -147,8 +208,9 @@ namespace NetCoreServer {
 		SessionListResult getSessionList(const SessionListOption& option) {
 			SessionListResult result;
 			std::vector<SessionInfo> list;
-			for (size_t i = 0; i < sessionServers.size(); i++) {
-				auto items = sessionServers[i]->getSessionList(option.sessionType, option.nameFilter);
+			auto servers = sessionServers.read();
+			for (auto& entry : *servers) {
+				auto items = entry.server->getSessionList(option.sessionType, option.nameFilter);
 				list.insert(list.end(), items.begin(), items.end());
 			}
 			result.totalSessionCount = static_cast<uint32_t>(list.size());
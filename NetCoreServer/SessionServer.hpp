@@ -3,6 +3,8 @@
 #include "Server.hpp"
 #include "NetCoreStructure.hpp"
 #include "AbstractSession.hpp"
+#include "SessionBatch.hpp"
+#include "Error.hpp"
 
 namespace NetCoreServer {
 	class SessionJoinHandler : public AbstractPacketHandler<Server> {
@@ -18,16 +20,34 @@ namespace NetCoreServer {
 		std::unordered_map<uint64_t, uint16_t> uidToSessionNumberTable;
 		std::unordered_map<uint16_t, std::vector<uint64_t>> sessionNumberToUidTable;
 
-		std::vector<std::shared_ptr<AbstractSession>> sessions;
+		// Published with RCU: lookups and lobby queries read a snapshot, attach/detach publish a new table.
+		Rcu<std::vector<std::shared_ptr<AbstractSession>>> sessions;
 		std::vector<std::unique_ptr<std::thread>> sessionThreads;
 
+		std::shared_ptr<AbstractSession> getSession(uint16_t sessionNumber) const {
+			auto table = sessions.read();
+			return table->size() > sessionNumber ? (*table)[sessionNumber] : nullptr;
+		}
+
 		bool detachSession(uint16_t sessionNumber) {
-			if (sessions.size() > sessionNumber) {
+			std::shared_ptr<AbstractSession> session;
+			sessions.update([&](auto& table) {
+				if (table.size() > sessionNumber) {
+					session = std::move(table[sessionNumber]);
+					if (sessionThreads[sessionNumber] != nullptr) {
+						sessionThreads[sessionNumber]->detach();
+						sessionThreads[sessionNumber].reset();
+					}
+				}
+				});
+
+			if (session != nullptr) {
 				Logger::success(makeLog(std::format("A session is deleted (Num: {})", sessionNumber)));
-				sessions[sessionNumber]->stop();
-				sessionThreads[sessionNumber]->detach();
-				sessionThreads[sessionNumber].reset();
-				sessions[sessionNumber].reset();
+				session->stop();
+				if (session->sessionBatch != nullptr) {
+					session->sessionBatch->detach(session);
+					session->sessionBatch.reset();
+				}
 				return true;
 			} else {
 				Logger::error(makeLog(std::format("Failed to delete a session (Num: {})", sessionNumber)));
@@ -36,16 +56,17 @@ namespace NetCoreServer {
 		}
 
 	public:
-		SessionServer(uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT)
-			: Server(port, max_connection, max_channel, queueSize, incomingBandwidth, outgoingBandwidth, bufferSize) {
+		SessionServer(uint16_t port, size_t max_connection, size_t max_channel, size_t queueSize = 1024, uint32_t incomingBandwidth = 0, uint32_t outgoingBandwidth = 0, int32_t bufferSize = BufferSize::DEFAULT, const ThreadPlacement& placement = ThreadPlacement{})
+			: Server(port, max_connection, max_channel, queueSize, incomingBandwidth, outgoingBandwidth, bufferSize, placement) {
 			auto joinHandler = std::make_shared<SessionJoinHandler>();
 			registerPacketHandler("JoinSession", joinHandler);
 
 			registerDisconnectionHandler([this](ENetPeer* peer) {
 				auto uid = getPeerUid(peer);
 				if (uid.has_value()) {
-					removePeer(*uid);
+					// removeUser looks the peer up by uid, so it has to run before the uid mapping is dropped.
 					removeUser(*uid);
+					removePeer(*uid);
 				}
 				});
 
@@ -60,29 +81,42 @@ namespace NetCoreServer {
 						return;
 					}
 
-					auto uid = getPeerUid(peer);
-					if (uid.has_value()) {
-						auto snum = getSessionNumberByUid(*uid);
+					auto context = getPeerContext(peer);
+					if (context != nullptr) {
+						auto snum = context->getSessionNumber();
+						if (!snum.has_value()) return;
 
-						if (snum.has_value() && sessions.size() > *snum)
-							sessions[*snum]->handlePacket(ppacket->header.packetTypeId, peer, ppacket->rawData);
+						auto session = getSession(*snum);
+						if (session != nullptr)
+							session->handlePacket(ppacket->header.packetTypeId, peer, ppacket->rawData);
 					}
 				}
 				});
 		}
 
-		~SessionServer() {}
+		~SessionServer() {
+			stop();
+
+			// A session's tick thread runs until the session stops; a still joinable std::thread would terminate the process here.
+			for (auto& session : *sessions.read()) {
+				if (session != nullptr) session->stop();
+			}
+			for (auto& thread : sessionThreads) {
+				if (thread != nullptr && thread->joinable()) thread->join();
+			}
+		}
 
 		std::vector<SessionInfo> getSessionList(std::string sessionType, std::optional<std::string> nameFilter = std::nullopt) {
 			std::vector<SessionInfo> list;
-			for (size_t i = 0; i < sessions.size(); i++) {
-				if (sessions[i] == nullptr) continue;
-
-				SessionInfo info = sessions[i]->getSessionInfo();
-				if (info.isPrivate) continue;
-				if (info.sessionType != sessionType) continue;
-				if (nameFilter.has_value() && info.name.find(toLower(*nameFilter)) == std::string::npos) continue;
-				list.push_back(info);
+			auto table = sessions.read();
+			for (auto& session : *table) {
+				if (session == nullptr) continue;
+
+				auto info = session->getSessionInfoSnapshot();
+				if (info->isPrivate) continue;
+				if (info->sessionType != sessionType) continue;
+				if (nameFilter.has_value() && info->name.find(toLower(*nameFilter)) == std::string::npos) continue;
+				list.push_back(*info);
 			}
 			return list;
 		}
@@ -104,11 +138,25 @@ namespace NetCoreServer {
 		}
 
 		void addUser(uint16_t sessionNumber, uint64_t uid) {
+			auto session = getSession(sessionNumber);
+			if (session == nullptr) return;
+
 			uidToSessionNumberTable.emplace(uid, sessionNumber);
 			sessionNumberToUidTable[sessionNumber].push_back(uid);
 
-			sessions[sessionNumber]->sessionInfo.currentPlayers += 1;
-			sessions[sessionNumber]->players.push_back(uid);
+			session->sessionInfo.update([](SessionInfo& info) {
+				info.currentPlayers += 1;
+				});
+			session->players.push_back(uid);
+
+			auto peer = getPeerByUid(uid);
+			auto handle = getPeerHandle(peer);
+			session->playerPeers.update([&](std::vector<PeerHandle>& peers) {
+				peers.push_back(handle.value_or(PeerHandle{ nullptr, 0 }));
+				});
+
+			auto context = getPeerContext(peer);
+			if (context != nullptr) context->sessionNumber.store(sessionNumber, std::memory_order_release);
 		}
 
 		std::optional<uint16_t> getSessionNumberByUid(uint64_t uid) const {
@@ -121,15 +169,27 @@ namespace NetCoreServer {
 			if (uidToSessionNumberTable.contains(uid)) {
 				auto num = uidToSessionNumberTable[uid];
 				uidToSessionNumberTable.erase(uid);
+
+				auto context = getPeerContext(getPeerByUid(uid));
+				if (context != nullptr) context->sessionNumber.store(PeerContext::NO_SESSION, std::memory_order_release);
 				auto& vec = sessionNumberToUidTable[num];
 				vec.erase(std::remove(vec.begin(), vec.end(), uid), vec.end());
 
 				if (vec.empty()) {
 					return detachSession(num);
-				} else {
-					sessions[num]->sessionInfo.currentPlayers -= 1;
-					auto& players = sessions[num]->players;
-					players.erase(std::remove(players.begin(), players.end(), uid), players.end());
+				} else if (auto session = getSession(num)) {
+					session->sessionInfo.update([](SessionInfo& info) {
+						info.currentPlayers -= 1;
+						});
+					auto& players = session->players;
+					auto it = std::find(players.begin(), players.end(), uid);
+					if (it != players.end()) {
+						size_t index = it - players.begin();
+						players.erase(it);
+						session->playerPeers.update([&](std::vector<PeerHandle>& peers) {
+							if (index < peers.size()) peers.erase(peers.begin() + index);
+							});
+					}
 				}
 
 				return true;
@@ -140,54 +200,76 @@ namespace NetCoreServer {
 			return "SESSION_SERVER";
 		}
 
-		const size_t getSessionsCount() {
-			return std::count_if(sessions.begin(), sessions.end(), [](const std::shared_ptr<AbstractSession>& ptr) {
+		const size_t getSessionsCount() const {
+			auto table = sessions.read();
+			return std::count_if(table->begin(), table->end(), [](const std::shared_ptr<AbstractSession>& ptr) {
 				return ptr != nullptr;
 				});
 		}
 
-		uint16_t attachSession(std::shared_ptr<AbstractSession> session) {
-			uint16_t num = 0;
-			auto& info = session->getSessionInfo();
-			auto thread = std::make_unique<std::thread>([session]() {
-				const auto tickInterval = std::chrono::duration<double>(1.0 / session->getFramerate());
-				auto previous = std::chrono::steady_clock::now();
-				auto nextTick = previous + tickInterval;
-
-				while (session->isRunning()) {
-					auto now = std::chrono::steady_clock::now();
-					std::chrono::duration<double> deltaTime = now - previous;
-					previous = now;
-
-					session->tick(deltaTime.count());
-
-					nextTick += tickInterval;
-					if (std::chrono::steady_clock::now() < nextTick) {
-						std::this_thread::sleep_until(nextTick);
-					} else {
-						nextTick = std::chrono::steady_clock::now();
-					}
+		// Throws SessionAttachError when batch cannot take the session, or when a session without a batch has no framerate.
+		uint16_t attachSession(std::shared_ptr<AbstractSession> session, std::shared_ptr<AbstractSessionBatch> batch = nullptr) {
+			return sessions.update([&](auto& table) {
+				uint16_t num = 0;
+				for (; num < static_cast<uint16_t>(table.size()); num++) {
+					if (table[num] == nullptr) break;
 				}
-			});
 
-			bool created = false;
-			for (; num < static_cast<uint16_t>(sessions.size()); num++) {
-				if (sessions[num] == nullptr) {
-					sessions[num] = session;
-					sessionThreads[num] = std::move(thread);
-					created = true;
-					break;
+				// Thrown before anything is published, so a rejected session leaves the table as it was.
+				if (batch != nullptr) {
+					if (!batch->attach(session.get())) throw SessionAttachError("the session is not a BatchSession of the batch's state type");
+				} else if (!(session->getFramerate() > 0.0)) {
+					throw SessionAttachError("the session has no framerate to tick at; a BatchSession needs its batch");
 				}
-			}
 
-			if (!created) {
-				sessions.push_back(std::move(session));
-				sessionThreads.push_back(std::move(thread));
-			}
+				session->sessionInfo.update([&](SessionInfo& info) {
+					info.identifier = SessionIdentifier{ getServerPort(), num };
+					});
+				// Live from here: the tick loop below runs while it stays set, and detachSession's stop() ends it.
+				session->running = true;
 
-			Logger::success(makeLog(std::format("A new session is created (Num: {}, Type: {}, Name: {}, MaxPlayers: {}, IsPrivate: {})", num, info.sessionType, info.name, info.maxPlayers, info.isPrivate)));
+				std::unique_ptr<std::thread> thread;
+				if (batch != nullptr) {
+					session->sessionBatch = std::move(batch);
+				} else {
+					thread = std::make_unique<std::thread>([session, placement = getPlacement(), name = std::format("nc-ses-{}-{}", getServerPort(), num)]() {
+						ThreadUtils::setCurrentThreadName(name);
+						ThreadUtils::applyPlacement(placement);
+
+						const auto tickInterval = std::chrono::duration<double>(1.0 / session->getFramerate());
+						auto previous = std::chrono::steady_clock::now();
+						auto nextTick = previous + tickInterval;
+
+						while (session->isRunning()) {
+							auto now = std::chrono::steady_clock::now();
+							std::chrono::duration<double> deltaTime = now - previous;
+							previous = now;
+
+							session->tick(deltaTime.count());
+
+							nextTick += tickInterval;
+							if (std::chrono::steady_clock::now() < nextTick) {
+								std::this_thread::sleep_until(nextTick);
+							} else {
+								nextTick = std::chrono::steady_clock::now();
+							}
+						}
+					});
+				}
+
+				auto info = session->getSessionInfoSnapshot();
+				if (num < static_cast<uint16_t>(table.size())) {
+					table[num] = std::move(session);
+					sessionThreads[num] = std::move(thread);
+				} else {
+					table.push_back(std::move(session));
+					sessionThreads.push_back(std::move(thread));
+				}
 
-			return num;
+				Logger::success(makeLog(std::format("A new session is created (Num: {}, Type: {}, Name: {}, MaxPlayers: {}, IsPrivate: {})", num, info->sessionType, info->name, info->maxPlayers, info->isPrivate)));
+
+				return num;
+				});
 		}
 	};
 }
\ No newline at end of file
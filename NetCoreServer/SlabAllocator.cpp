@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "SlabAllocator.hpp"
+
+namespace NetCoreServer {
+	namespace {
+		// Precedes every block handed to ENet. owner is nullptr for blocks that came from malloc.
+		// A free block reuses owner as its FreeBlock link; sizeClass stays valid for remote frees.
+		struct alignas(16) BlockHeader {
+			SlabPool* owner;
+			uint32_t sizeClass;
+		};
+
+		constexpr size_t HEADER_SIZE = sizeof(BlockHeader);
+
+		constexpr size_t classSize(uint32_t sizeClass) {
+			return static_cast<size_t>(32) << sizeClass;
+		}
+
+		uint32_t sizeClassOf(size_t size) {
+			uint32_t sizeClass = 0;
+			while (classSize(sizeClass) < size) sizeClass++;
+			return sizeClass;
+		}
+	}
+
+	thread_local SlabPool* SlabAllocator::currentPool = nullptr;
+	std::atomic<bool> SlabAllocator::installed = false;
+	size_t SlabAllocator::prefillBlocks = 0;
+	std::mutex SlabAllocator::poolsMutex;
+	std::atomic<uint64_t> SlabAllocator::fallbackAllocations = 0;
+
+	std::vector<SlabPool*>& SlabAllocator::idlePools() {
+		// Never destroyed, so idle pools stay reachable for packets freed during and after static destruction.
+		static auto pools = new std::vector<SlabPool*>();
+		return *pools;
+	}
+
+	void* SlabPool::allocate(uint32_t sizeClass) {
+		FreeBlock* block = freeLists[sizeClass];
+		if (block != nullptr) {
+			hits.fetch_add(1, std::memory_order_relaxed);
+		} else {
+			drainRemoteFrees();
+			block = freeLists[sizeClass];
+			if (block != nullptr) {
+				hits.fetch_add(1, std::memory_order_relaxed);
+			} else {
+				misses.fetch_add(1, std::memory_order_relaxed);
+				if (!refill(sizeClass)) return nullptr;
+				block = freeLists[sizeClass];
+			}
+		}
+		freeLists[sizeClass] = block->next;
+
+		auto header = reinterpret_cast<BlockHeader*>(block);
+		header->owner = this;
+		header->sizeClass = sizeClass;
+		return reinterpret_cast<uint8_t*>(header) + HEADER_SIZE;
+	}
+
+	void SlabPool::release(void* block, uint32_t sizeClass) {
+		auto freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->next = freeLists[sizeClass];
+		freeLists[sizeClass] = freeBlock;
+	}
+
+	void SlabPool::releaseRemote(void* block) {
+		auto freeBlock = static_cast<FreeBlock*>(block);
+		FreeBlock* head = remoteFrees.load(std::memory_order_relaxed);
+		do {
+			freeBlock->next = head;
+		} while (!remoteFrees.compare_exchange_weak(head, freeBlock, std::memory_order_release, std::memory_order_relaxed));
+		remoteFreeCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void SlabPool::drainRemoteFrees() {
+		FreeBlock* block = remoteFrees.exchange(nullptr, std::memory_order_acquire);
+		while (block != nullptr) {
+			FreeBlock* next = block->next;
+			release(block, reinterpret_cast<BlockHeader*>(block)->sizeClass);
+			block = next;
+		}
+	}
+
+	bool SlabPool::refill(uint32_t sizeClass) {
+		const size_t stride = HEADER_SIZE + classSize(sizeClass);
+		const size_t count = CHUNK_SIZE / stride;
+
+		// operator new[] is at least 16-byte aligned, and stride is a multiple of 16.
+		auto chunk = static_cast<uint8_t*>(::operator new[](count * stride, std::nothrow));
+		if (chunk == nullptr) return false;
+		chunks.push_back(chunk);
+		reservedBytes.fetch_add(count * stride, std::memory_order_relaxed);
+
+		for (size_t i = count; i-- > 0;) {
+			auto header = reinterpret_cast<BlockHeader*>(chunk + i * stride);
+			header->sizeClass = sizeClass;
+			release(header, sizeClass);
+		}
+		return true;
+	}
+
+	void SlabPool::prefill(size_t blocksPerClass) {
+		if (prefilled) return;
+		prefilled = true;
+
+		for (uint32_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++) {
+			const size_t perChunk = CHUNK_SIZE / (HEADER_SIZE + classSize(sizeClass));
+			for (size_t carved = 0; carved < blocksPerClass; carved += perChunk) {
+				if (!refill(sizeClass)) return;
+			}
+		}
+	}
+
+	AllocatorStats SlabPool::getStats() const {
+		return AllocatorStats{
+			hits.load(std::memory_order_relaxed),
+			misses.load(std::memory_order_relaxed),
+			remoteFreeCount.load(std::memory_order_relaxed),
+			reservedBytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	void* ENET_CALLBACK SlabAllocator::allocate(size_t size) {
+		SlabPool* pool = currentPool;
+		if (pool != nullptr && size <= MAX_BLOCK_SIZE) {
+			void* memory = pool->allocate(sizeClassOf(size));
+			if (memory != nullptr) return memory;
+		}
+
+		fallbackAllocations.fetch_add(1, std::memory_order_relaxed);
+		auto header = static_cast<BlockHeader*>(malloc(HEADER_SIZE + size));
+		if (header == nullptr) return nullptr;
+		header->owner = nullptr;
+		header->sizeClass = 0;
+		return reinterpret_cast<uint8_t*>(header) + HEADER_SIZE;
+	}
+
+	void ENET_CALLBACK SlabAllocator::deallocate(void* memory) {
+		if (memory == nullptr) return;
+
+		auto header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(memory) - HEADER_SIZE);
+		SlabPool* owner = header->owner;
+		if (owner == nullptr) {
+			free(header);
+		} else if (owner == currentPool) {
+			owner->release(header, header->sizeClass);
+		} else {
+			owner->releaseRemote(header);
+		}
+	}
+
+	bool SlabAllocator::install(const AllocatorOption& option) {
+		prefillBlocks = option.prefillBlocks;
+
+		ENetCallbacks callbacks = { allocate, deallocate, nullptr };
+		if (enet_initialize_with_callbacks(ENET_VERSION, &callbacks) != 0) return false;
+
+		installed.store(true, std::memory_order_release);
+		return true;
+	}
+
+	SlabPool* SlabAllocator::acquirePool() {
+		if (!isInstalled()) return nullptr;
+
+		std::lock_guard<std::mutex> lock(poolsMutex);
+		auto& pools = idlePools();
+		if (pools.empty()) return new SlabPool();
+
+		SlabPool* pool = pools.back();
+		pools.pop_back();
+		return pool;
+	}
+
+	void SlabAllocator::releasePool(SlabPool* pool) {
+		if (pool == nullptr) return;
+
+		std::lock_guard<std::mutex> lock(poolsMutex);
+		idlePools().push_back(pool);
+	}
+
+	void SlabAllocator::bindCurrentThread(SlabPool* pool) {
+		currentPool = pool;
+		if (pool != nullptr) pool->prefill(prefillBlocks);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include "pch.h"
+#include "NetCoreStructure.hpp"
+
+namespace NetCoreServer {
+	// Free lists for one host. Only the service thread the pool is bound to allocates from it;
+	// blocks freed on any other thread are pushed to remoteFrees and reclaimed on the next miss.
+	class SlabPool {
+	private:
+		friend class SlabAllocator;
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		static constexpr size_t SIZE_CLASS_COUNT = 8;
+		static constexpr size_t MIN_BLOCK_SIZE = 32;
+		static constexpr size_t CHUNK_SIZE = 65536;
+
+		FreeBlock* freeLists[SIZE_CLASS_COUNT] = {};
+		std::atomic<FreeBlock*> remoteFrees{ nullptr };
+		std::vector<void*> chunks;
+		bool prefilled = false;
+
+		std::atomic<uint64_t> hits{ 0 };
+		std::atomic<uint64_t> misses{ 0 };
+		std::atomic<uint64_t> remoteFreeCount{ 0 };
+		std::atomic<uint64_t> reservedBytes{ 0 };
+
+		void* allocate(uint32_t sizeClass);
+		void release(void* block, uint32_t sizeClass);
+		void releaseRemote(void* block);
+		void drainRemoteFrees();
+		bool refill(uint32_t sizeClass);
+		void prefill(size_t blocksPerClass);
+
+	public:
+		AllocatorStats getStats() const;
+	};
+
+	// Size-class allocator installed behind enet_malloc/enet_free by initialize().
+	// Requests above the largest class, and requests from threads without a bound pool, go to malloc.
+	class SlabAllocator {
+	private:
+		static thread_local SlabPool* currentPool;
+		static std::atomic<bool> installed;
+		static size_t prefillBlocks;
+
+		static std::mutex poolsMutex;
+		static std::vector<SlabPool*>& idlePools();
+		static std::atomic<uint64_t> fallbackAllocations;
+
+		static void* ENET_CALLBACK allocate(size_t size);
+		static void ENET_CALLBACK deallocate(void* memory);
+
+	public:
+		static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+		static bool install(const AllocatorOption& option);
+
+		static bool isInstalled() {
+			return installed.load(std::memory_order_acquire);
+		}
+
+		// Pools are never freed, since a packet can outlive its host; released pools are reused.
+		static SlabPool* acquirePool();
+		static void releasePool(SlabPool* pool);
+
+		// Binds pool to the calling thread and prefills it on first use.
+		static void bindCurrentThread(SlabPool* pool);
+
+		static uint64_t getFallbackAllocations() {
+			return fallbackAllocations.load(std::memory_order_relaxed);
+		}
+	};
+}
\ No newline at end of file
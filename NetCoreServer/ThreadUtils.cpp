@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "ThreadUtils.hpp"
+
+#if defined(_WIN32) || defined(_WIN64)
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace NetCoreServer {
+	bool ThreadUtils::setCurrentThreadName(const std::string& name) {
+#if defined(_WIN32) || defined(_WIN64)
+		std::wstring wname(name.begin(), name.end());
+		return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wname.c_str()));
+#elif defined(__APPLE__)
+		return pthread_setname_np(name.substr(0, 15).c_str()) == 0;
+#else
+		return pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) == 0;
+#endif
+	}
+
+	std::vector<uint32_t> ThreadUtils::getNumaNodeCores(int32_t numaNode) {
+		std::vector<uint32_t> cores;
+		if (numaNode < 0) return cores;
+#if defined(_WIN32) || defined(_WIN64)
+		GROUP_AFFINITY affinity = {};
+		if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numaNode), &affinity)) return cores;
+		for (uint32_t i = 0; i < sizeof(KAFFINITY) * 8; i++) {
+			if (affinity.Mask & (static_cast<KAFFINITY>(1) << i)) cores.push_back(affinity.Group * 64 + i);
+		}
+#elif defined(__linux__)
+		// cpulist looks like "0-3,8-11"
+		std::ifstream file(std::format("/sys/devices/system/node/node{}/cpulist", numaNode));
+		std::string range;
+		while (std::getline(file, range, ',')) {
+			uint32_t first = 0, last = 0;
+			char dash = 0;
+			std::istringstream stream(range);
+			if (!(stream >> first)) continue;
+			last = (stream >> dash >> last) ? last : first;
+			for (uint32_t core = first; core <= last; core++) cores.push_back(core);
+		}
+#endif
+		return cores;
+	}
+
+	bool ThreadUtils::applyPlacement(const ThreadPlacement& placement) {
+		if (placement.isDefault()) return true;
+
+		std::vector<uint32_t> cores = placement.cores;
+		if (placement.numaNode >= 0) {
+			auto nodeCores = getNumaNodeCores(placement.numaNode);
+			if (cores.empty()) {
+				cores = std::move(nodeCores);
+			} else {
+				std::erase_if(cores, [&](uint32_t core) {
+					return std::find(nodeCores.begin(), nodeCores.end(), core) == nodeCores.end();
+					});
+			}
+		}
+		if (cores.empty()) return false;
+
+#if defined(_WIN32) || defined(_WIN64)
+		// A thread can only be bound to one processor group; use the group of the first core.
+		GROUP_AFFINITY affinity = {};
+		affinity.Group = static_cast<WORD>(cores.front() / 64);
+		for (auto core : cores) {
+			if (core / 64 == affinity.Group) affinity.Mask |= static_cast<KAFFINITY>(1) << (core % 64);
+		}
+		return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (auto core : cores) {
+			if (core < CPU_SETSIZE) CPU_SET(core, &set);
+		}
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+		return false;
+#endif
+	}
+
+	PlacedWorker::PlacedWorker(const ThreadPlacement& placement, const std::string& name)
+		: thread(&PlacedWorker::run, this, placement, name) {
+	}
+
+	PlacedWorker::~PlacedWorker() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		thread.join();
+	}
+
+	void PlacedWorker::post(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+		}
+		wake.notify_one();
+	}
+
+	void PlacedWorker::run(ThreadPlacement placement, std::string name) {
+		ThreadUtils::setCurrentThreadName(name);
+		ThreadUtils::applyPlacement(placement);
+
+		std::vector<std::function<void()>> batch;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				// Callers block on their task, so nothing is left queued once stopping is set.
+				if (tasks.empty()) return;
+				batch.swap(tasks);
+			}
+			for (auto& task : batch) task();
+			batch.clear();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "pch.h"
+#include "NetCoreStructure.hpp"
+
+namespace NetCoreServer {
+	class ThreadUtils {
+	public:
+		// Names are truncated to 15 characters on Linux.
+		static bool setCurrentThreadName(const std::string& name);
+
+		static std::vector<uint32_t> getNumaNodeCores(int32_t numaNode);
+
+		static bool applyPlacement(const ThreadPlacement& placement);
+
+	};
+
+	// A thread pinned to placement that runs the callables handed to it, so memory they first touch is allocated on that
+	// node. Start one per placed server rather than a thread per call.
+	class PlacedWorker {
+	private:
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::vector<std::function<void()>> tasks;
+		bool stopping = false;
+		std::thread thread;
+
+		void run(ThreadPlacement placement, std::string name);
+		void post(std::function<void()> task);
+
+	public:
+		PlacedWorker(const ThreadPlacement& placement, const std::string& name);
+		~PlacedWorker();
+
+		PlacedWorker(const PlacedWorker&) = delete;
+		PlacedWorker& operator=(const PlacedWorker&) = delete;
+
+		// Blocks until func has run on the worker and returns its result or rethrows what it threw.
+		template<typename Func>
+		auto invoke(Func&& func) -> decltype(func()) {
+			auto task = std::make_shared<std::packaged_task<decltype(func())()>>(std::forward<Func>(func));
+			auto result = task->get_future();
+			post([task]() { (*task)(); });
+			return result.get();
+		}
+	};
+}
\ No newline at end of file
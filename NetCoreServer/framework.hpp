@@ -24,6 +24,11 @@
 #include <future>
 #include <type_traits>
 #include <mutex>
+#include <condition_variable>
+#include <span>
+#include <unordered_map>
+#include <cmath>
+#include <cassert>
 
 typedef float float32_t;
 typedef double float64_t;
@@ -0,0 +1,164 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <cstring>
+#include <thread>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	const char* backendName(ENetHostBackend backend) {
+		switch (backend) {
+		case ENET_HOST_BACKEND_IO_URING: return "io_uring";
+		case ENET_HOST_BACKEND_IO_URING_SQPOLL: return "io_uring+sqpoll";
+		default: return "socket";
+		}
+	}
+
+	// Pushes count reliable messages from client to server over loopback and returns the time in ms, or a negative value if some never arrived.
+	double transfer(ENetHostBackend backend, int count, ENetHostBackend& used) {
+		LinkedHosts hosts(1, 4, backend);
+		used = enet_host_get_backend(hosts.server);
+		if (!hosts.connect()) return -1.0;
+
+		uint8_t message[100] = {};
+		for (int i = 0; i < count; i++) {
+			std::memcpy(message, &i, sizeof(i));
+			enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+		}
+
+		// Steps without sleeping, so the backends are what is measured.
+		int received = 0;
+		const auto started = std::chrono::steady_clock::now();
+		while (received < count && elapsedMilliseconds(started) < 30000.0) {
+			hosts.step([&](const ENetEvent& event) {
+				if (event.type == ENET_EVENT_TYPE_RECEIVE) received++;
+				});
+		}
+
+		return received == count ? elapsedMilliseconds(started) : -1.0;
+	}
+
+	uint32_t datagramsSeen = 0;
+	int largestDatagram = 0;
+
+	// Sees each datagram the server takes in after GRO has split what the kernel coalesced.
+	int ENET_CALLBACK countDatagrams(ENetEvent*, ENetAddress*, uint8_t*, int length) {
+		datagramsSeen++;
+		if (length > largestDatagram) largestDatagram = length;
+		return 0;
+	}
+
+	// Fills a message so that its index and length can be checked from its bytes alone.
+	void fillMessage(uint8_t* message, int index, size_t length) {
+		for (size_t i = 0; i < length; i++) message[i] = static_cast<uint8_t>(index * 31 + i);
+		std::memcpy(message, &index, sizeof(index));
+	}
+}
+
+// A backend that cannot be set up falls back to the socket path, so every requested backend has to deliver everything.
+// SQPOLL falls back to plain io_uring with one CPU online, where its polling thread would only take turns with the host.
+// The rates are reported, not compared: on a single loopback flow io_uring is no faster than batched sockets.
+TEST_CASE(BackendDeliversOverEveryBackend) {
+	const ENetHostBackend backends[] = { ENET_HOST_BACKEND_SOCKET, ENET_HOST_BACKEND_IO_URING, ENET_HOST_BACKEND_IO_URING_SQPOLL };
+	const int count = 20000;
+	const bool spareCore = std::thread::hardware_concurrency() > 1;
+
+	for (ENetHostBackend backend : backends) {
+		ENetHostBackend used;
+		const double elapsed = transfer(backend, count, used);
+		CHECK(elapsed >= 0.0);
+		CHECK(used == backend || used == ENET_HOST_BACKEND_SOCKET || (backend == ENET_HOST_BACKEND_IO_URING_SQPOLL && used == ENET_HOST_BACKEND_IO_URING));
+		if (!spareCore) CHECK(used != ENET_HOST_BACKEND_IO_URING_SQPOLL);
+		if (elapsed > 0.0) report("%-16s (ran as %s): %d messages in %.1f ms, %.0f messages/s", backendName(backend), backendName(used), count, elapsed, count / elapsed * 1000.0);
+	}
+}
+
+// With GSO the client hands the kernel runs of equal datagrams as one send, and with GRO the server reads them back as one buffer.
+// Every datagram has to come out on its own boundary, so the server sees as many as the client sent and every message intact.
+TEST_CASE(BackendKeepsSegmentBoundariesWithUdpOffload) {
+	LinkedHosts hosts(1);
+	const uint32_t offload = ENET_HOST_OFFLOAD_GSO | ENET_HOST_OFFLOAD_GRO;
+	REQUIRE(enet_host_set_io_batch_size(hosts.server, 64) == 0);
+	REQUIRE(enet_host_set_io_batch_size(hosts.client, 64) == 0);
+	const uint32_t clientOffload = enet_host_set_udp_offload(hosts.client, offload);
+	const uint32_t serverOffload = enet_host_set_udp_offload(hosts.server, offload);
+	if (!(clientOffload & ENET_HOST_OFFLOAD_GSO) || !(serverOffload & ENET_HOST_OFFLOAD_GRO)) {
+		report("skipped: the kernel offers GSO %s and GRO %s", (clientOffload & ENET_HOST_OFFLOAD_GSO) ? "on" : "off", (serverOffload & ENET_HOST_OFFLOAD_GRO) ? "on" : "off");
+		return;
+	}
+	REQUIRE(hosts.connect());
+
+	datagramsSeen = 0;
+	largestDatagram = 0;
+	enet_host_set_intercept_callback(hosts.server, countDatagrams);
+	const uint32_t sentBefore = enet_host_get_packets_sent(hosts.client);
+
+	// Equal messages fill equal datagrams, which GSO sends together; the varied ones after them end runs at odd sizes.
+	const int count = 20000;
+	uint8_t message[512];
+	for (int i = 0; i < count; i++) {
+		const size_t length = i < count / 2 ? 100 : 8 + (i * 37) % 400;
+		fillMessage(message, i, length);
+		enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, length, ENET_PACKET_FLAG_RELIABLE));
+	}
+
+	int received = 0;
+	int corrupted = 0;
+	auto onServerEvent = [&](const ENetEvent& event) {
+		if (event.type != ENET_EVENT_TYPE_RECEIVE) return;
+		int index;
+		std::memcpy(&index, event.packet->data, sizeof(index));
+		const size_t length = index < count / 2 ? 100 : 8 + (index * 37) % 400;
+		fillMessage(message, index, length);
+		if (event.packet->dataLength != length || std::memcmp(event.packet->data, message, length) != 0) corrupted++;
+		received++;
+	};
+
+	CHECK(hosts.runUntil([&]() { return received == count; }, 30000, onServerEvent));
+	CHECK(received == count);
+	CHECK(corrupted == 0);
+	// Whatever the client sent last may still be on its way once the last message is in.
+	CHECK(hosts.runUntil([&]() { return datagramsSeen == enet_host_get_packets_sent(hosts.client) - sentBefore; }, 5000, onServerEvent));
+	CHECK(largestDatagram <= static_cast<int>(hosts.clientPeer->mtu));
+	CHECK(enet_host_get_udp_offload(hosts.client) & ENET_HOST_OFFLOAD_GSO);
+
+	report("%u datagrams, largest %d bytes, client offload %u, server offload %u", datagramsSeen, largestDatagram, enet_host_get_udp_offload(hosts.client), enet_host_get_udp_offload(hosts.server));
+}
+
+// A receive pass cut short by the budget can leave datagrams of a recvmmsg batch in user space, where no socket wait sees them.
+// Datagrams that raise no event come first, so the service call has nothing to return until it reads past the budget.
+TEST_CASE(BackendDrainsBatchLeftByReceiveBudget) {
+	const int budget = 5;
+	const int pings = 2 * budget;
+	LinkedHosts hosts(1);
+	REQUIRE(enet_host_get_io_batch_size(hosts.server) > (size_t)pings);
+	REQUIRE(hosts.connect());
+	enet_host_service_budget(hosts.server, budget, 0, 0);
+
+	// One datagram each, all in the server's socket before it is serviced.
+	for (int i = 0; i < pings; i++) {
+		enet_peer_ping(hosts.clientPeer);
+		enet_host_flush(hosts.client);
+	}
+	const uint8_t message[4] = {};
+	enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+	enet_host_flush(hosts.client);
+
+	const uint32_t serviceTimeout = 1000;
+	const uint32_t received = hosts.server->totalReceivedPackets;
+	bool delivered = false;
+	const auto started = std::chrono::steady_clock::now();
+	while (!delivered && elapsedMilliseconds(started) < 5000) {
+		ENetEvent event;
+		if (enet_host_service(hosts.server, &event, serviceTimeout) <= 0 || event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+		delivered = true;
+		enet_packet_destroy(event.packet);
+	}
+	const double elapsed = elapsedMilliseconds(started);
+
+	CHECK(delivered);
+	CHECK(hosts.server->totalReceivedPackets - received >= (uint32_t)pings + 1);
+	// Left waiting on the socket, the packet would sit until the next timer or the service timeout.
+	CHECK(elapsed < 100.0);
+	report("budget %d, batch %zu: packet behind %d pings handled after %.1f ms", budget, enet_host_get_io_batch_size(hosts.server), pings, elapsed);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace NetCoreServer;
+using namespace NetCoreServerTest;
+
+namespace {
+	const uint16_t valueType = 1;
+
+	Packet makeValue(uint32_t value) {
+		return PacketUtils::createPacket(valueType, value, ENET_PACKET_FLAG_RELIABLE);
+	}
+}
+
+// Sends and broadcasts from the test thread go through the queue the service thread drains. A broadcast reaches each target
+// after the packets queued for it before the broadcast, and skips a target whose slot has since been taken by another
+// connection, whether it was queued or sent from a handler.
+TEST_CASE(ServerBroadcastKeepsOrderAndDropsStaleTargets) {
+	Server server(27152, 8, 1);
+	std::mutex mutex;
+	std::map<uint32_t, PeerHandle> handles;
+	size_t connects = 0;
+	size_t disconnects = 0;
+	std::shared_ptr<const std::vector<PeerHandle>> captured, current;
+
+	// Server peers are matched to client peers by the connect id both sides share.
+	server.registerConnectionHandler([&](ENetPeer* peer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto handle = server.getPeerHandle(peer);
+		if (handle.has_value()) handles[peer->connectID] = *handle;
+		connects++;
+		});
+	server.registerDisconnectionHandler([&](ENetPeer*) {
+		std::lock_guard<std::mutex> lock(mutex);
+		disconnects++;
+		});
+	// Any packet from a client has the service thread broadcast to both target lists itself.
+	server.registerPacketReceivedHandler([&](ENetPeer*, ENetPacket*) {
+		std::lock_guard<std::mutex> lock(mutex);
+		server.broadcastPacket(captured, 0, makeValue(5000));
+		server.broadcastPacket(current, 0, makeValue(6000));
+		});
+
+	ENetHost* client = enet_host_create(nullptr, 4, 1, 0, 0, 0);
+	REQUIRE(client != nullptr);
+	ENetAddress address{};
+	enet_address_set_ip(&address, "::1");
+	address.port = server.getServerPort();
+
+	std::map<ENetPeer*, std::vector<uint32_t>> received;
+	auto serviceUntil = [&](const std::function<bool()>& until) {
+		const auto started = std::chrono::steady_clock::now();
+		while (elapsedMilliseconds(started) < 10000) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (until()) return true;
+			}
+			ENetEvent event;
+			while (enet_host_service(client, &event, 1) > 0) {
+				if (event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+				auto parsed = PacketUtils::parsePacket(Packet{ event.packet });
+				if (parsed.has_value()) received[event.peer].push_back(PacketUtils::parseRawData<uint32_t>(parsed->rawData));
+				enet_packet_destroy(event.packet);
+			}
+		}
+		return false;
+	};
+	auto handleOf = [&](ENetPeer* peer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return handles.at(peer->connectID);
+	};
+
+	ENetPeer* a = enet_host_connect(client, &address, 1, 0);
+	ENetPeer* b = enet_host_connect(client, &address, 1, 0);
+	ENetPeer* c = enet_host_connect(client, &address, 1, 0);
+	REQUIRE(a && b && c);
+	REQUIRE(serviceUntil([&]() { return connects == 3; }));
+	const PeerHandle handleA = handleOf(a), handleB = handleOf(b), handleC = handleOf(c);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		captured = std::make_shared<const std::vector<PeerHandle>>(std::vector<PeerHandle>{ handleA, handleB, handleC });
+	}
+
+	// Per-peer packets on either side of a broadcast keep the order they were queued in.
+	for (uint32_t i = 0; i < 50; i++) server.sendPacket(handleA.peer, 0, makeValue(i));
+	server.broadcastPacket(captured, 0, makeValue(1000));
+	for (uint32_t i = 50; i < 100; i++) server.sendPacket(handleA.peer, 0, makeValue(i));
+
+	CHECK(serviceUntil([&]() { return received[a].size() == 101 && received[b].size() == 1 && received[c].size() == 1; }));
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 0; i < 50; i++) expected.push_back(i);
+	expected.push_back(1000);
+	for (uint32_t i = 50; i < 100; i++) expected.push_back(i);
+	CHECK(received[a] == expected);
+	CHECK(received[b] == std::vector<uint32_t>{ 1000 });
+	CHECK(received[c] == std::vector<uint32_t>{ 1000 });
+
+	// A new connection takes the slot c left, and the handle captured for c must not reach it.
+	enet_peer_disconnect(c, 0);
+	REQUIRE(serviceUntil([&]() { return disconnects == 1; }));
+	// The client may hand d the slot c had, too.
+	received.erase(c);
+	ENetPeer* d = enet_host_connect(client, &address, 1, 0);
+	REQUIRE(d != nullptr);
+	REQUIRE(serviceUntil([&]() { return connects == 4; }));
+	const PeerHandle handleD = handleOf(d);
+	REQUIRE(handleD.peer == handleC.peer);
+	CHECK(handleD.generation != handleC.generation);
+
+	server.broadcastPacket(captured, 0, makeValue(2000), handleA.peer);
+	// Every target captured here is gone; the packet goes nowhere.
+	server.broadcastPacket(std::make_shared<const std::vector<PeerHandle>>(std::vector<PeerHandle>{ handleC }), 0, makeValue(3000));
+
+	// A later broadcast to the current handles marks where anything queued before it would have landed.
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		current = std::make_shared<const std::vector<PeerHandle>>(std::vector<PeerHandle>{ handleA, handleB, handleD });
+	}
+	server.broadcastPacket(current, 0, makeValue(4000));
+	CHECK(serviceUntil([&]() { return received[a].size() == 102 && received[b].size() == 3 && received[d].size() == 1; }));
+	CHECK(received[a].back() == 4000);
+	CHECK(received[b] == (std::vector<uint32_t>{ 1000, 2000, 4000 }));
+	CHECK(received[d] == std::vector<uint32_t>{ 4000 });
+
+	// Broadcast from a handler, the stale handle is dropped the same way.
+	enet_peer_send(d, 0, makeValue(0).enetPacket);
+	CHECK(serviceUntil([&]() { return received[a].size() == 104 && received[b].size() == 5 && received[d].size() == 2; }));
+	CHECK(received[b] == (std::vector<uint32_t>{ 1000, 2000, 4000, 5000, 6000 }));
+	CHECK(received[d] == (std::vector<uint32_t>{ 4000, 6000 }));
+
+	enet_host_destroy(client);
+	server.stop();
+}
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct BudgetHosts {
+		ENetHost* server = nullptr;
+		ENetHost* client = nullptr;
+		ENetAddress address{};
+		std::vector<ENetPeer*> serverPeers;
+
+		BudgetHosts() {
+			ENetAddress any{};
+			any.ipv6 = ENET_HOST_ANY;
+			server = enet_host_create(&any, 4, 1, 0, 0, 0);
+			client = enet_host_create(nullptr, 2, 1, 0, 0, 0);
+
+			enet_address_set_ip(&address, "::1");
+			if (server) address.port = server->address.port;
+		}
+
+		~BudgetHosts() {
+			if (client) enet_host_destroy(client);
+			if (server) enet_host_destroy(server);
+		}
+
+		// Services both hosts, handing each one's events to its callback.
+		void service(const std::function<void(const ENetEvent&)>& onServerEvent, const std::function<void(const ENetEvent&)>& onClientEvent) {
+			ENetEvent event;
+			while (enet_host_service(server, &event, 0) > 0) {
+				if (event.type == ENET_EVENT_TYPE_CONNECT) serverPeers.push_back(event.peer);
+				if (onServerEvent) onServerEvent(event);
+				if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+			while (enet_host_service(client, &event, 0) > 0) {
+				if (onClientEvent) onClientEvent(event);
+				if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+		}
+
+		bool serviceUntil(const std::function<bool()>& done, uint32_t timeout, const std::function<void(const ENetEvent&)>& onServerEvent = nullptr, const std::function<void(const ENetEvent&)>& onClientEvent = nullptr) {
+			const auto started = std::chrono::steady_clock::now();
+			while (!done()) {
+				if (elapsedMilliseconds(started) > timeout) return false;
+				service(onServerEvent, onClientEvent);
+			}
+			return true;
+		}
+	};
+
+	void sendTagged(ENetPeer* peer, uint8_t tag, size_t count, size_t size) {
+		std::vector<uint8_t> message(size, tag);
+		for (size_t i = 0; i < count; i++) enet_peer_send(peer, 0, enet_packet_create(message.data(), message.size(), ENET_PACKET_FLAG_RELIABLE));
+	}
+}
+
+// A chatty peer's backlog reaches the server ahead of a quiet peer's few messages. With the budgets set, the quiet peer is
+// dispatched long before the chatty one drains, no event waits out the service timeout behind a cut-short pass, each budget
+// records the passes it cut short, and sends rotate over both peers.
+TEST_CASE(BudgetsKeepQuietPeerMovingPastChattyOne) {
+	const size_t chattyCount = 1000;
+	const size_t quietCount = 10;
+	const uint32_t dispatchLimit = 2;
+	BudgetHosts hosts;
+	REQUIRE(hosts.server && hosts.client);
+
+	ENetPeer* chatty = enet_host_connect(hosts.client, &hosts.address, 1, 0);
+	ENetPeer* quiet = enet_host_connect(hosts.client, &hosts.address, 1, 0);
+	REQUIRE(chatty && quiet);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverPeers.size() == 2 && chatty->state == ENET_PEER_STATE_CONNECTED && quiet->state == ENET_PEER_STATE_CONNECTED; }, 5000));
+
+	enet_host_service_budget(hosts.server, 4, 1, dispatchLimit);
+	ENetHostBudgetStats before{};
+	enet_host_get_budget_stats(hosts.server, &before);
+
+	// Every chatty datagram is on the wire before the quiet peer sends anything.
+	sendTagged(chatty, 0, chattyCount, 16);
+	enet_host_flush(hosts.client);
+	REQUIRE(enet_list_empty(&chatty->outgoingCommands));
+	sendTagged(quiet, 1, quietCount, 16);
+	enet_host_flush(hosts.client);
+
+	// Everything is already in the server's socket, so no call may sit out its timeout while events are left to hand out.
+	const uint32_t serviceTimeout = 1000;
+	std::vector<uint8_t> order;
+	double slowestCall = 0.0;
+	size_t idleCalls = 0;
+	const auto started = std::chrono::steady_clock::now();
+	while (order.size() < chattyCount + quietCount && elapsedMilliseconds(started) < 10000) {
+		const auto callStarted = std::chrono::steady_clock::now();
+		ENetEvent event;
+		const int result = enet_host_service(hosts.server, &event, serviceTimeout);
+		const double callTime = elapsedMilliseconds(callStarted);
+		if (callTime > slowestCall) slowestCall = callTime;
+		if (result <= 0) {
+			idleCalls++;
+			continue;
+		}
+		if (event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+		order.push_back(event.packet->data[0]);
+		enet_packet_destroy(event.packet);
+	}
+	CHECK(order.size() == chattyCount + quietCount);
+	CHECK(idleCalls == 0);
+	CHECK(slowestCall < 100.0);
+
+	size_t lastQuiet = 0, lastChatty = 0;
+	for (size_t i = 0; i < order.size(); i++) (order[i] == 0 ? lastChatty : lastQuiet) = i;
+	CHECK(lastQuiet < lastChatty);
+	CHECK(lastQuiet < order.size() / 2);
+
+	// A burst that raises no event until its last datagram: a receive pass cut short on it has nothing to hand out, and
+	// what it left of its batch must not wait on the drained socket. The send budget is lifted for it, as acks left over
+	// from a cut-short send pass would keep the wait from sleeping anyway.
+	enet_host_service_budget(hosts.server, 4, 0, dispatchLimit);
+	for (int i = 0; i < 3 * 4; i++) {
+		enet_peer_ping(quiet);
+		enet_host_flush(hosts.client);
+	}
+	sendTagged(quiet, 1, 1, 16);
+	enet_host_flush(hosts.client);
+	const auto burstSent = std::chrono::steady_clock::now();
+	while (order.size() < chattyCount + quietCount + 1 && elapsedMilliseconds(burstSent) < 5000) {
+		ENetEvent event;
+		if (enet_host_service(hosts.server, &event, serviceTimeout) <= 0 || event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+		order.push_back(event.packet->data[0]);
+		enet_packet_destroy(event.packet);
+	}
+	const double burstTime = elapsedMilliseconds(burstSent);
+	CHECK(order.size() == chattyCount + quietCount + 1);
+	CHECK(burstTime < 100.0);
+	enet_host_service_budget(hosts.server, 4, 1, dispatchLimit);
+
+	// The other way, each server peer has a backlog larger than the send budget allows in one pass.
+	size_t received[2] = {};
+	auto onClientEvent = [&](const ENetEvent& event) {
+		if (event.type == ENET_EVENT_TYPE_RECEIVE) received[event.peer == quiet]++;
+	};
+	for (auto peer : hosts.serverPeers) sendTagged(peer, 2, 100, 200);
+	CHECK(hosts.serviceUntil([&]() { return received[0] == 100 && received[1] == 100; }, 10000, nullptr, onClientEvent));
+
+	ENetHostBudgetStats after{};
+	enet_host_get_budget_stats(hosts.server, &after);
+	CHECK(after.receiveBudgetExhausted > before.receiveBudgetExhausted);
+	CHECK(after.sendBudgetExhausted > before.sendBudgetExhausted);
+	CHECK(after.peerDispatchLimitReached > before.peerDispatchLimitReached);
+
+	report("quiet peer done at event %zu of %zu, slowest service call %.1f ms, burst after %.1f ms; budgets hit: receive %llu, send %llu, dispatch %llu", lastQuiet + 1, order.size(), slowestCall, burstTime,
+		static_cast<unsigned long long>(after.receiveBudgetExhausted - before.receiveBudgetExhausted),
+		static_cast<unsigned long long>(after.sendBudgetExhausted - before.sendBudgetExhausted),
+		static_cast<unsigned long long>(after.peerDispatchLimitReached - before.peerDispatchLimitReached));
+}
+
+// The Server hands its budgets to the host, and getBudgetStats reports them to a handler on the service thread.
+TEST_CASE(ServerBudgetsKeepQuietPeerMoving) {
+	const size_t chattyCount = 1000;
+	const size_t quietCount = 10;
+	const uint16_t chattyType = 1, quietType = 2, doneType = 3;
+	NetCoreServer::Server server(27151, 8, 1);
+	server.setReceiveBudget(4);
+	server.setSendBudget(1);
+	server.setPeerDispatchLimit(2);
+
+	std::mutex mutex;
+	size_t connects = 0;
+	size_t chattyReceived = 0, quietReceived = 0;
+	bool quietDoneFirst = false;
+	bool done = false;
+	ENetHostBudgetStats stats{};
+	std::vector<ENetPeer*> peers;
+
+	server.registerConnectionHandler([&](ENetPeer* peer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		connects++;
+		peers.push_back(peer);
+		});
+	server.registerPacketReceivedHandler([&](ENetPeer*, ENetPacket* packet) {
+		auto parsed = NetCoreServer::PacketUtils::parsePacket(NetCoreServer::Packet{ packet });
+		if (!parsed.has_value()) return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		switch (parsed->header.packetTypeId) {
+		case chattyType:
+			chattyReceived++;
+			break;
+		case quietType:
+			if (++quietReceived == quietCount) quietDoneFirst = chattyReceived < chattyCount;
+			break;
+		case doneType:
+			stats = server.getBudgetStats();
+			done = true;
+			return;
+		}
+
+		// Once everything is in, each peer is sent a backlog larger than one send pass carries.
+		if (chattyReceived == chattyCount && quietReceived == quietCount) {
+			for (auto target : peers) {
+				for (int i = 0; i < 100; i++) server.sendPacket(target, 0, NetCoreServer::PacketUtils::createPacket(chattyType, std::vector<uint8_t>(200, 2), ENET_PACKET_FLAG_RELIABLE));
+			}
+		}
+		});
+
+	ENetHost* client = enet_host_create(nullptr, 2, 1, 0, 0, 0);
+	REQUIRE(client != nullptr);
+	ENetAddress address{};
+	enet_address_set_ip(&address, "::1");
+	address.port = server.getServerPort();
+	ENetPeer* chatty = enet_host_connect(client, &address, 1, 0);
+	ENetPeer* quiet = enet_host_connect(client, &address, 1, 0);
+	REQUIRE(chatty && quiet);
+
+	size_t replies[2] = {};
+	auto serviceUntil = [&](const std::function<bool()>& until) {
+		const auto started = std::chrono::steady_clock::now();
+		while (elapsedMilliseconds(started) < 10000) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (until()) return true;
+			}
+			ENetEvent event;
+			while (enet_host_service(client, &event, 1) > 0) {
+				if (event.type != ENET_EVENT_TYPE_RECEIVE) continue;
+				replies[event.peer == quiet]++;
+				enet_packet_destroy(event.packet);
+			}
+		}
+		return false;
+	};
+
+	REQUIRE(serviceUntil([&]() { return connects == 2 && chatty->state == ENET_PEER_STATE_CONNECTED && quiet->state == ENET_PEER_STATE_CONNECTED; }));
+
+	for (size_t i = 0; i < chattyCount; i++) enet_peer_send(chatty, 0, NetCoreServer::PacketUtils::createEmptyPacket(chattyType, ENET_PACKET_FLAG_RELIABLE).enetPacket);
+	enet_host_flush(client);
+	for (size_t i = 0; i < quietCount; i++) enet_peer_send(quiet, 0, NetCoreServer::PacketUtils::createEmptyPacket(quietType, ENET_PACKET_FLAG_RELIABLE).enetPacket);
+	enet_host_flush(client);
+
+	CHECK(serviceUntil([&]() { return replies[0] == 100 && replies[1] == 100; }));
+	enet_peer_send(quiet, 0, NetCoreServer::PacketUtils::createEmptyPacket(doneType, ENET_PACKET_FLAG_RELIABLE).enetPacket);
+	CHECK(serviceUntil([&]() { return done; }));
+
+	enet_host_destroy(client);
+	server.stop();
+
+	CHECK(chattyReceived == chattyCount);
+	CHECK(quietReceived == quietCount);
+	CHECK(quietDoneFirst);
+	CHECK(stats.receiveBudgetExhausted > 0);
+	CHECK(stats.sendBudgetExhausted > 0);
+	CHECK(stats.peerDispatchLimitReached > 0);
+}
\ No newline at end of file
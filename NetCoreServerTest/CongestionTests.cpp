@@ -0,0 +1,120 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct BulkResult {
+		LinkRunResult link;
+		int received = 0;
+		bool inOrder = true;
+		double throughput = 0.0;
+		uint32_t bandwidthEstimate = 0;
+		double meanQueueDelay = 0.0;
+		double maxQueueDelay = 0.0;
+		uint64_t queueDropped = 0;
+		std::vector<uint32_t> estimateSamples;
+	};
+
+	// Keeps a reliable stream of 1000-byte messages queued from client to server for duration ms over the link.
+	BulkResult bulk(ENetCongestionControl control, uint32_t duration, const LinkOptions& link, bool simulatedClock = false) {
+		BulkResult result;
+		uint8_t message[1000] = {};
+		int sent = 0;
+		double nextSample = 0.0;
+
+		LinkRun run;
+		run.link = link;
+		run.simulatedClock = simulatedClock;
+		run.duration = duration;
+		run.configure = [&](LinkedHosts& hosts) {
+			enet_host_congestion_control(hosts.server, control);
+			enet_host_congestion_control(hosts.client, control);
+		};
+		// Enough is queued that the sender is never short of data, but not so much that the queue outlives the run.
+		run.send = [&](LinkedHosts& hosts, double elapsed) {
+			// Samples the estimate every 100 ms over the second half, once it has had time to settle.
+			if (elapsed >= duration / 2 && elapsed >= nextSample) {
+				result.estimateSamples.push_back(enet_peer_get_bandwidth_estimate(hosts.clientPeer));
+				nextSample = elapsed + 100.0;
+			}
+			while (sent - result.received < 256) {
+				std::memcpy(message, &sent, sizeof(sent));
+				enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+				sent++;
+			}
+		};
+		run.receive = [&](const ENetEvent& event, double) {
+			int index;
+			std::memcpy(&index, event.packet->data, sizeof(index));
+			if (index != result.received) result.inOrder = false;
+			result.received++;
+		};
+		run.finish = [&](LinkedHosts& hosts) {
+			result.bandwidthEstimate = enet_peer_get_bandwidth_estimate(hosts.clientPeer);
+			result.meanQueueDelay = hosts.link->getMeanQueueDelay();
+			result.maxQueueDelay = hosts.link->getMaxQueueDelay();
+			result.queueDropped = hosts.link->getQueueDropped();
+		};
+		result.link = runLink(run);
+		result.throughput = result.received * sizeof(message) / result.link.elapsed;
+
+		return result;
+	}
+}
+
+// Random loss is not congestion, so delay control must not keep halving its rate on it and fall far behind the throttle.
+TEST_CASE(DelayControlHoldsRateOnLossyLink) {
+	const uint32_t duration = 3000;
+	// Drops 5% of datagrams each way.
+	LinkOptions link;
+	link.lossPerTenThousand = 500;
+	link.delay = 10;
+	const BulkResult throttle = bulk(ENET_CONGESTION_CONTROL_THROTTLE, duration, link);
+	const BulkResult delay = bulk(ENET_CONGESTION_CONTROL_DELAY, duration, link);
+
+	REQUIRE(throttle.link.connected);
+	REQUIRE(delay.link.connected);
+	CHECK(throttle.inOrder);
+	CHECK(delay.inOrder);
+	CHECK(delay.throughput > throttle.throughput / 2);
+
+	report("throttle:      %.0f KB/s, %llu retransmitted", throttle.throughput, static_cast<unsigned long long>(throttle.link.retransmitted));
+	report("delay control: %.0f KB/s, %llu retransmitted, estimate %u KB/s", delay.throughput, static_cast<unsigned long long>(delay.link.retransmitted), delay.bandwidthEstimate / 1024);
+}
+
+// Behind a bottleneck with a deep queue, the throttle fills the queue until it overflows, while delay control sends at about
+// what the bottleneck carries and keeps the queue a fraction as deep. Its bandwidth estimate has to find that rate.
+TEST_CASE(DelayControlKeepsBottleneckQueueShort) {
+	const uint32_t duration = 8000;
+	LinkOptions link;
+	link.delay = 10;
+	link.rate = 256 * 1024;
+	link.queueLimit = 128 * 1024;
+	const BulkResult throttle = bulk(ENET_CONGESTION_CONTROL_THROTTLE, duration, link, true);
+	const BulkResult delay = bulk(ENET_CONGESTION_CONTROL_DELAY, duration, link, true);
+
+	REQUIRE(throttle.link.connected);
+	REQUIRE(delay.link.connected);
+	CHECK(throttle.inOrder);
+	CHECK(delay.inOrder);
+
+	// The estimate saws around the rate as the queue fills past the target and drains; on average it has to sit on the rate.
+	REQUIRE(!delay.estimateSamples.empty());
+	double estimate = 0.0;
+	for (auto sample : delay.estimateSamples) estimate += static_cast<double>(sample) / delay.estimateSamples.size();
+	const auto [lowest, highest] = std::minmax_element(delay.estimateSamples.begin(), delay.estimateSamples.end());
+
+	CHECK(delay.throughput * 1000.0 > link.rate * 0.8);
+	CHECK(delay.queueDropped < throttle.queueDropped);
+	CHECK(delay.meanQueueDelay < throttle.meanQueueDelay / 2);
+	CHECK(delay.maxQueueDelay < throttle.maxQueueDelay / 2);
+	CHECK(estimate > link.rate * 0.75 && estimate < link.rate * 1.25);
+
+	report("bottleneck %u KB/s, %u KB queue", link.rate / 1024, link.queueLimit / 1024);
+	report("throttle:      %.0f KB/s, queue delay mean %.0f ms max %.0f ms, %llu dropped at the queue, %llu retransmitted", throttle.throughput, throttle.meanQueueDelay, throttle.maxQueueDelay, static_cast<unsigned long long>(throttle.queueDropped), static_cast<unsigned long long>(throttle.link.retransmitted));
+	report("delay control: %.0f KB/s, queue delay mean %.0f ms max %.0f ms, %llu dropped at the queue, %llu retransmitted, estimate %.0f KB/s (%u to %u)", delay.throughput, delay.meanQueueDelay, delay.maxQueueDelay, static_cast<unsigned long long>(delay.queueDropped), static_cast<unsigned long long>(delay.link.retransmitted), estimate / 1024, *lowest / 1024, *highest / 1024);
+}
\ No newline at end of file
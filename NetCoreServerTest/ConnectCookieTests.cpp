@@ -0,0 +1,174 @@
+#include "TestFramework.hpp"
+#include <enet/enet.h>
+#include <cstring>
+#include <functional>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	const uint8_t cookieSecret[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+	struct CookieHosts {
+		ENetHost* server = nullptr;
+		ENetHost* client = nullptr;
+		ENetAddress address{};
+		size_t serverConnects = 0;
+
+		CookieHosts(bool cookies) {
+			ENetAddress any{};
+			any.ipv6 = ENET_HOST_ANY;
+			server = enet_host_create(&any, 4, 2, 0, 0, 0);
+
+			// The client is bound up front so a challenge can be spoofed to its port.
+			client = enet_host_create(&any, 1, 2, 0, 0, 0);
+			if (server && cookies) enet_host_connect_cookies(server, cookieSecret);
+
+			enet_address_set_ip(&address, "::1");
+			if (server) address.port = server->address.port;
+		}
+
+		~CookieHosts() {
+			if (client) enet_host_destroy(client);
+			if (server) enet_host_destroy(server);
+		}
+
+		void service(ENetHost* host) {
+			ENetEvent event;
+			while (enet_host_service(host, &event, 0) > 0) {
+				if (event.type == ENET_EVENT_TYPE_CONNECT && host == server) serverConnects++;
+				else if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+		}
+
+		bool serviceUntil(const std::function<bool()>& done, uint32_t timeout) {
+			const auto started = std::chrono::steady_clock::now();
+			while (!done()) {
+				if (elapsedMilliseconds(started) > timeout) return false;
+				service(server);
+				service(client);
+			}
+			return true;
+		}
+
+		// Sends a challenge to the client from the server's socket, as a spoofer using the server's address would.
+		void sendChallenge(ENetPeer* peer, uint32_t echo, uint32_t cookie) {
+			uint16_t peerId = ENET_HOST_TO_NET_16(peer->incomingPeerID);
+			ENetProtocolVerifyConnect verify{};
+			verify.header.command = ENET_PROTOCOL_COMMAND_VERIFY_CONNECT;
+			verify.header.channelID = 0xFF;
+			verify.outgoingPeerID = ENET_HOST_TO_NET_16(ENET_PROTOCOL_MAXIMUM_PEER_ID);
+			verify.channelCount = ENET_HOST_TO_NET_32(2);
+			verify.windowSize = echo;
+			verify.connectID = cookie;
+
+			ENetBuffer buffers[2];
+			buffers[0].data = &peerId;
+			buffers[0].dataLength = sizeof(peerId);
+			buffers[1].data = &verify;
+			buffers[1].dataLength = sizeof(verify);
+
+			ENetAddress to{};
+			enet_address_set_ip(&to, "::1");
+			to.port = client->address.port;
+			enet_socket_send(server->socket, &to, buffers, 2);
+		}
+
+		// Counts the server's slots that have left the disconnected state.
+		size_t committedSlots() const {
+			size_t committed = 0;
+			for (size_t slot = 0; slot < server->peerSlotCount; slot++) if (server->peers[slot].state != ENET_PEER_STATE_DISCONNECTED) committed++;
+			return committed;
+		}
+	};
+
+	size_t challengesSeen = 0;
+	bool dropChallenges = false;
+
+	// A challenge goes out with the bare two-byte header and a single verify command.
+	bool isChallenge(const uint8_t* data, int length) {
+		if (length != 2 + (int)sizeof(ENetProtocolVerifyConnect) || (ENET_NET_TO_HOST_16(*reinterpret_cast<const uint16_t*>(data)) & ENET_PROTOCOL_HEADER_FLAG_MASK) != 0) return false;
+
+		const ENetProtocolVerifyConnect* verify = reinterpret_cast<const ENetProtocolVerifyConnect*>(&data[2]);
+		return (verify->header.command & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_VERIFY_CONNECT && ENET_NET_TO_HOST_16(verify->outgoingPeerID) == ENET_PROTOCOL_MAXIMUM_PEER_ID;
+	}
+
+	// Counts challenges reaching the client, and swallows them for a client that predates cookies and could not answer one.
+	int ENET_CALLBACK watchChallenges(ENetEvent*, ENetAddress*, uint8_t* data, int length) {
+		if (!isChallenge(data, length)) return 0;
+		challengesSeen++;
+		return dropChallenges ? 1 : 0;
+	}
+}
+
+// Checks the connect handshake with cookies off and on, against a client that cannot answer a challenge, and against spoofed challenges.
+TEST_CASE(ConnectCookieHandshake) {
+	{
+		CookieHosts hosts(false);
+		REQUIRE(hosts.server && hosts.client);
+		enet_host_set_intercept_callback(hosts.client, watchChallenges);
+		challengesSeen = 0;
+		dropChallenges = false;
+
+		ENetPeer* peer = enet_host_connect(hosts.client, &hosts.address, 2, 0);
+		REQUIRE(peer != nullptr);
+		CHECK(hosts.serviceUntil([&]() { return hosts.serverConnects == 1 && peer->state == ENET_PEER_STATE_CONNECTED; }, 5000));
+		CHECK(challengesSeen == 0);
+	}
+
+	{
+		CookieHosts hosts(true);
+		REQUIRE(hosts.server && hosts.client);
+		enet_host_set_intercept_callback(hosts.client, watchChallenges);
+		challengesSeen = 0;
+		dropChallenges = false;
+
+		ENetPeer* peer = enet_host_connect(hosts.client, &hosts.address, 2, 0);
+		REQUIRE(peer != nullptr);
+		const uint32_t connectId = peer->connectID;
+		CHECK(hosts.serviceUntil([&]() { return hosts.serverConnects == 1 && peer->state == ENET_PEER_STATE_CONNECTED; }, 5000));
+		CHECK(challengesSeen == 1);
+		CHECK(peer->connectID != connectId);
+		CHECK(hosts.committedSlots() == 1);
+	}
+
+	// A client that cannot answer keeps sending its first connect, and the server never commits a slot for it.
+	{
+		CookieHosts hosts(true);
+		REQUIRE(hosts.server && hosts.client);
+		enet_host_set_intercept_callback(hosts.client, watchChallenges);
+		challengesSeen = 0;
+		dropChallenges = true;
+
+		ENetPeer* peer = enet_host_connect(hosts.client, &hosts.address, 2, 0);
+		REQUIRE(peer != nullptr);
+		hosts.serviceUntil([]() { return false; }, 2000);
+		CHECK(challengesSeen > 1);
+		CHECK(hosts.serverConnects == 0);
+		CHECK(hosts.committedSlots() == 0);
+		dropChallenges = false;
+	}
+
+	// A challenge that does not echo the connect id, or a second one for the same attempt, leaves the connect as it was.
+	{
+		CookieHosts hosts(true);
+		REQUIRE(hosts.server && hosts.client);
+
+		ENetPeer* peer = enet_host_connect(hosts.client, &hosts.address, 2, 0);
+		REQUIRE(peer != nullptr);
+		const uint32_t connectId = peer->connectID;
+
+		hosts.sendChallenge(peer, connectId + 1, 0x5EC0FFEE);
+		hosts.service(hosts.client);
+		CHECK(peer->state == ENET_PEER_STATE_CONNECTING);
+		CHECK(peer->connectID == connectId);
+
+		REQUIRE(hosts.serviceUntil([&]() { return peer->connectID != connectId; }, 5000));
+		const uint32_t cookie = peer->connectID;
+
+		hosts.sendChallenge(peer, cookie, 0x5EC0FFEE);
+		hosts.service(hosts.client);
+		CHECK(peer->connectID == cookie);
+
+		CHECK(hosts.serviceUntil([&]() { return hosts.serverConnects == 1 && peer->state == ENET_PEER_STATE_CONNECTED; }, 5000));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "TestFramework.hpp"
+#include <enet/enet.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	const ENetCrc64Method methods[] = { ENET_CRC64_BYTEWISE, ENET_CRC64_SLICED, ENET_CRC64_FOLDED };
+	const char* const methodNames[] = { "bytewise", "sliced", "folded" };
+
+	// The reflected Jones polynomial a bit at a time, with the all-ones start and finish of enet_crc64, in the byte order it is sent in.
+	uint64_t referenceCrc(const uint8_t* data, size_t length) {
+		uint64_t crc = ~UINT64_C(0);
+		for (size_t i = 0; i < length; i++) {
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ ((crc & 1) ? UINT64_C(0x95ac9329ac4bc9b5) : 0);
+		}
+		return ENET_HOST_TO_NET_64(~crc);
+	}
+
+	uint64_t crc(const uint8_t* data, size_t length) {
+		ENetBuffer buffer;
+		buffer.data = const_cast<uint8_t*>(data);
+		buffer.dataLength = length;
+		return enet_crc64(&buffer, 1);
+	}
+
+	// Restores the method enet_initialize picked when a test is done with others.
+	struct MethodScope {
+		const ENetCrc64Method initial = enet_crc64_get_method();
+
+		~MethodScope() {
+			enet_crc64_set_method(initial);
+		}
+	};
+}
+
+// Every method agrees with the bitwise reference across lengths around the 8- and 16-byte steps, unaligned starts, and datagrams split over several buffers.
+TEST_CASE(Crc64MethodsMatchReference) {
+	MethodScope scope;
+	std::mt19937 random(7);
+	std::vector<uint8_t> data(4096 + 16);
+	for (uint8_t& byte : data) byte = static_cast<uint8_t>(random());
+
+	const char check[] = "123456789";
+	CHECK(referenceCrc(reinterpret_cast<const uint8_t*>(check), 9) == ENET_HOST_TO_NET_64(UINT64_C(0x3558e8e979f60d7e)));
+
+	std::vector<size_t> lengths;
+	for (size_t length = 0; length <= 160; length++) lengths.push_back(length);
+	for (size_t length : { 255, 256, 257, 511, 512, 513, 1023, 1392, 1400, 4095, 4096 }) lengths.push_back(length);
+
+	for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+		if (enet_crc64_set_method(methods[m]) != 0) {
+			report("%s: not available here", methodNames[m]);
+			continue;
+		}
+		CHECK(enet_crc64_get_method() == methods[m]);
+		CHECK(crc(reinterpret_cast<const uint8_t*>(check), 9) == referenceCrc(reinterpret_cast<const uint8_t*>(check), 9));
+
+		size_t mismatches = 0;
+		for (size_t length : lengths) {
+			for (size_t offset = 0; offset < 16; offset++) {
+				const uint8_t* start = data.data() + offset;
+				const uint64_t expected = referenceCrc(start, length);
+				if (crc(start, length) != expected) mismatches++;
+
+				// Header, command and payload arrive as separate buffers, cut anywhere.
+				ENetBuffer buffers[3];
+				const size_t first = length == 0 ? 0 : random() % (length + 1);
+				const size_t second = first + (length == first ? 0 : random() % (length - first + 1));
+				buffers[0].data = const_cast<uint8_t*>(start);
+				buffers[0].dataLength = first;
+				buffers[1].data = const_cast<uint8_t*>(start + first);
+				buffers[1].dataLength = second - first;
+				buffers[2].data = const_cast<uint8_t*>(start + second);
+				buffers[2].dataLength = length - second;
+				if (enet_crc64(buffers, 3) != expected) mismatches++;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+
+	CHECK(enet_crc64_set_method(static_cast<ENetCrc64Method>(3)) != 0);
+}
+
+TEST_CASE(Crc64Throughput) {
+	MethodScope scope;
+	const size_t sizes[] = { 64, 1392, 65536 };
+	std::vector<uint8_t> data(65536);
+	for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<uint8_t>(i * 131);
+
+	for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+		if (enet_crc64_set_method(methods[m]) != 0) continue;
+
+		for (size_t size : sizes) {
+			const size_t total = size_t(64) << 20;
+			volatile uint64_t sink = 0;
+			const auto started = std::chrono::steady_clock::now();
+			for (size_t done = 0; done < total; done += size) sink = sink ^ crc(data.data(), size);
+			const double elapsed = elapsedMilliseconds(started);
+			report("%-8s %5zu-byte buffers: %7.0f MB/s", methodNames[m], size, total / 1048576.0 / (elapsed / 1000.0));
+		}
+	}
+}
\ No newline at end of file
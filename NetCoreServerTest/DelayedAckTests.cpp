@@ -0,0 +1,76 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <cstring>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct TransferResult {
+		LinkRunResult link;
+		int reliable = 0;
+		int unreliable = 0;
+	};
+
+	// Sends reliable and unreliable messages from client to server over a loss-free link, with the server holding acknowledgements for delay ms.
+	// The run is on a simulated clock: on the system clock, a stall of a few ms anywhere in the run outlasts a retransmission timeout that sits close to the round trip of a steady link.
+	TransferResult transfer(uint32_t delay, int reliableCount, int unreliableCount) {
+		TransferResult result;
+		uint8_t message[200] = {};
+		int sent = 0;
+
+		LinkRun run;
+		run.channelCount = 2;
+		run.link.delay = 10;
+		run.simulatedClock = true;
+		run.configure = [&](LinkedHosts& hosts) {
+			enet_host_acknowledgement_delay(hosts.server, delay, 32);
+
+			// The link hands over everything due at once, which must not overflow the hosts' own buffers.
+			enet_socket_set_option(hosts.server->socket, ENET_SOCKOPT_RCVBUF, 8 << 20);
+			enet_socket_set_option(hosts.client->socket, ENET_SOCKOPT_RCVBUF, 8 << 20);
+		};
+		// Ten reliable messages a millisecond, so that acknowledging at once answers nearly every datagram on its own.
+		run.send = [&](LinkedHosts& hosts, double elapsed) {
+			while (sent < reliableCount && elapsed * 10.0 >= static_cast<double>(sent)) {
+				std::memcpy(message, &sent, sizeof(sent));
+				enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+
+				// Unreliable traffic shares the datagrams, and is dropped by the sender if it falls behind the reliable stream.
+				if (sent % (reliableCount / unreliableCount) == 0)
+					enet_peer_send(hosts.clientPeer, 1, enet_packet_create(message, sizeof(message), 0));
+				sent++;
+			}
+		};
+		run.receive = [&](const ENetEvent& event, double) {
+			if (event.channelID == 0) result.reliable++;
+			else result.unreliable++;
+		};
+		run.done = [&]() { return result.reliable >= reliableCount && result.unreliable >= unreliableCount; };
+		result.link = runLink(run);
+
+		return result;
+	}
+}
+
+// Holding acknowledgements must not slow a loss-free transfer down or make the sender retransmit; it should only send fewer datagrams back.
+TEST_CASE(DelayedAcknowledgementKeepsLossFreeThroughput) {
+	const int reliableCount = 5000;
+	const int unreliableCount = 500;
+	const TransferResult immediate = transfer(0, reliableCount, unreliableCount);
+	const TransferResult delayed = transfer(20, reliableCount, unreliableCount);
+
+	REQUIRE(immediate.link.connected);
+	REQUIRE(delayed.link.connected);
+	CHECK(immediate.reliable == reliableCount);
+	CHECK(delayed.reliable == reliableCount);
+	CHECK(immediate.unreliable == unreliableCount);
+	CHECK(delayed.unreliable == unreliableCount);
+	CHECK(delayed.link.elapsed < immediate.link.elapsed * 1.25 + 20.0);
+	// Nothing is lost on the link, so anything sent again timed out waiting on an acknowledgement.
+	CHECK(immediate.link.retransmitted == 0);
+	CHECK(delayed.link.retransmitted == 0);
+	CHECK(delayed.link.serverDatagrams < immediate.link.serverDatagrams);
+
+	report("acknowledged at once: %.0f ms, %llu retransmitted, %u datagrams back", immediate.link.elapsed, static_cast<unsigned long long>(immediate.link.retransmitted), immediate.link.serverDatagrams);
+	report("held up to 20 ms:     %.0f ms, %llu retransmitted, %u datagrams back", delayed.link.elapsed, static_cast<unsigned long long>(delayed.link.retransmitted), delayed.link.serverDatagrams);
+}
\ No newline at end of file
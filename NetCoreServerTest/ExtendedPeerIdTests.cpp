@@ -0,0 +1,218 @@
+#include "TestFramework.hpp"
+#include <enet/enet.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	// A host's own connects only take ids below 0xFFF, so several clients are needed to fill the server past them.
+	struct WideServer {
+		size_t clientPeers;
+		size_t clientCount;
+		ENetHost* server = nullptr;
+		std::vector<ENetHost*> clients;
+		std::vector<ENetPeer*> peers;
+		ENetAddress address{};
+		size_t serverConnects = 0;
+		size_t serverReceives = 0;
+		size_t serverReceivesHigh = 0;
+		size_t serverDisconnects = 0;
+		size_t clientReceives = 0;
+		uint16_t lastConnectId = 0;
+		uint32_t pingInterval = 0;
+
+		// With separateAddresses, each client binds its own IPv4 loopback address, as clients of a real server would arrive from many.
+		WideServer(size_t clientPeers, size_t clientCount, bool separateAddresses = false, int bufferSize = 0) : clientPeers(clientPeers), clientCount(clientCount) {
+			ENetAddress any{};
+			any.ipv6 = ENET_HOST_ANY;
+			server = enet_host_create(&any, clientPeers * clientCount + 100, 2, 0, 0, bufferSize);
+			if (server) enet_host_set_max_duplicate_peers(server, ENET_PROTOCOL_MAXIMUM_EXTENDED_PEER_ID);
+
+			for (size_t i = 0; i < clientCount; i++) {
+				ENetAddress bind{};
+				if (separateAddresses) enet_address_set_ip(&bind, ("127.0.1." + std::to_string(i + 1)).c_str());
+				clients.push_back(enet_host_create(separateAddresses ? &bind : nullptr, clientPeers, 2, 0, 0, bufferSize));
+			}
+
+			// The last client stands in for a peer that predates extended ids; it is bound up front so its port is known.
+			clients.push_back(enet_host_create(&any, 1, 2, 0, 0, 0));
+
+			enet_address_set_ip(&address, separateAddresses ? "127.0.0.1" : "::1");
+			if (server) address.port = server->address.port;
+		}
+
+		~WideServer() {
+			for (ENetHost* client : clients) if (client) enet_host_destroy(client);
+			if (server) enet_host_destroy(server);
+		}
+
+		bool created() const {
+			for (ENetHost* client : clients) if (!client) return false;
+			return server != nullptr;
+		}
+
+		void service(ENetHost* host, bool isServer) {
+			ENetEvent event;
+			while (enet_host_service(host, &event, 0) > 0) {
+				switch (event.type) {
+				case ENET_EVENT_TYPE_CONNECT:
+					if (isServer) {
+						serverConnects++;
+						lastConnectId = event.peer->incomingPeerID;
+						if (pingInterval) enet_peer_ping_interval(event.peer, pingInterval);
+					}
+					break;
+				case ENET_EVENT_TYPE_RECEIVE:
+					if (isServer) {
+						serverReceives++;
+						if (event.peer->incomingPeerID > ENET_PROTOCOL_MAXIMUM_PEER_ID) serverReceivesHigh++;
+					}
+					else clientReceives++;
+					enet_packet_destroy(event.packet);
+					break;
+				case ENET_EVENT_TYPE_DISCONNECT:
+				case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+					if (isServer) serverDisconnects++;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		void serviceAll() {
+			service(server, true);
+			for (ENetHost* client : clients) service(client, false);
+		}
+
+		bool serviceUntil(const std::function<bool()>& done, uint32_t timeout) {
+			const auto started = std::chrono::steady_clock::now();
+			while (!done()) {
+				if (elapsedMilliseconds(started) > timeout) return false;
+				serviceAll();
+			}
+			return true;
+		}
+	};
+
+	// Connects every client peer, in one burst when wave is 0, and reports how long the server took to accept them all.
+	bool connectAll(WideServer& wide, size_t wave) {
+		const size_t total = wide.clientPeers * wide.clientCount;
+		const auto connectStarted = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < wide.clientCount; i++) {
+			for (size_t k = 0; k < wide.clientPeers; k++) {
+				ENetPeer* peer = enet_host_connect(wide.clients[i], &wide.address, 2, 0);
+				if (!peer) return false;
+				if (wide.pingInterval) enet_peer_ping_interval(peer, wide.pingInterval);
+				wide.peers.push_back(peer);
+
+				if (wave && wide.peers.size() % wave == 0 && !wide.serviceUntil([&]() { return wide.serverConnects == wide.peers.size(); }, 60000)) return false;
+			}
+		}
+		if (!wide.serviceUntil([&]() { return wide.serverConnects == total; }, 60000)) return false;
+		report("%zu connections set up in %.0f ms", total, elapsedMilliseconds(connectStarted));
+		return true;
+	}
+
+	// Services every host for a while with all peers connected and idle apart from pings.
+	void measureSteadyState(WideServer& wide, double duration) {
+		size_t rounds = 0;
+		const auto serviceStarted = std::chrono::steady_clock::now();
+		while (elapsedMilliseconds(serviceStarted) < duration) {
+			wide.serviceAll();
+			rounds++;
+		}
+		report("steady-state service with %zu peers: %.3f ms per round over %zu rounds", wide.peers.size(), elapsedMilliseconds(serviceStarted) / rounds, rounds);
+	}
+
+	uint16_t legacyPort = 0;
+
+	// Clears the extended-id flag from the legacy client's connect, as a peer built before the flag existed would send it.
+	int ENET_CALLBACK stripExtendedPeerId(ENetEvent*, ENetAddress* address, uint8_t* data, int length) {
+		if (address->port == legacyPort && length > 4 && (data[4] & ENET_PROTOCOL_COMMAND_MASK) == ENET_PROTOCOL_COMMAND_CONNECT)
+			data[4] &= static_cast<uint8_t>(~ENET_PROTOCOL_COMMAND_FLAG_EXTENDED_PEER_ID);
+		return 0;
+	}
+}
+
+// Fills a server past 4095 peers, exchanges traffic with the peers above 0xFFF, and checks that a legacy peer is only given a low id.
+TEST_CASE(ExtendedPeerIdBeyondFourThousandPeers) {
+	const size_t clientPeers = 2200;
+	const size_t clientCount = 2;
+	auto wide = std::make_unique<WideServer>(clientPeers, clientCount);
+	REQUIRE(wide->created());
+
+	// All connects go out at once; retransmissions have to back off for the burst to settle.
+	const size_t total = clientPeers * clientCount;
+	REQUIRE(connectAll(*wide, 0));
+
+	size_t highPeers = 0;
+	for (size_t slot = 0; slot < wide->server->peerSlotCount; slot++) {
+		ENetPeer& peer = wide->server->peers[slot];
+		if (peer.state == ENET_PEER_STATE_CONNECTED && peer.incomingPeerID > ENET_PROTOCOL_MAXIMUM_PEER_ID) highPeers++;
+	}
+	CHECK(highPeers == total - ENET_PROTOCOL_MAXIMUM_PEER_ID);
+
+	// Both directions carry the extended header byte for these peers.
+	size_t sentToServer = 0, sentToClients = 0;
+	for (ENetPeer* peer : wide->peers) {
+		if (peer->outgoingPeerID <= ENET_PROTOCOL_MAXIMUM_PEER_ID) continue;
+		enet_peer_send(peer, 0, enet_packet_create("up", 2, ENET_PACKET_FLAG_RELIABLE));
+		sentToServer++;
+	}
+	for (size_t slot = 0; slot < wide->server->peerSlotCount; slot++) {
+		ENetPeer& peer = wide->server->peers[slot];
+		if (peer.state != ENET_PEER_STATE_CONNECTED || peer.incomingPeerID <= ENET_PROTOCOL_MAXIMUM_PEER_ID) continue;
+		enet_peer_send(&peer, 1, enet_packet_create("down", 4, ENET_PACKET_FLAG_RELIABLE));
+		sentToClients++;
+	}
+	REQUIRE(sentToServer > 0);
+	CHECK(wide->serviceUntil([&]() { return wide->serverReceives == sentToServer && wide->clientReceives == sentToClients; }, 30000));
+	CHECK(wide->serverReceivesHigh == sentToServer);
+
+	measureSteadyState(*wide, 1000);
+
+	// The low ids are all taken, so the legacy peer cannot be seated until one frees up.
+	legacyPort = wide->clients[clientCount]->address.port;
+	enet_host_set_intercept_callback(wide->server, stripExtendedPeerId);
+
+	ENetPeer* legacy = enet_host_connect(wide->clients[clientCount], &wide->address, 2, 0);
+	REQUIRE(legacy != nullptr);
+	wide->serviceUntil([]() { return false; }, 1000);
+	CHECK(wide->serverConnects == total);
+
+	enet_peer_reset(legacy);
+	for (size_t k = 0; k < wide->peers.size(); k += clientCount) enet_peer_disconnect(wide->peers[k], 0);
+	REQUIRE(wide->serviceUntil([&]() { return wide->serverDisconnects == clientPeers; }, 30000));
+
+	legacy = enet_host_connect(wide->clients[clientCount], &wide->address, 2, 0);
+	REQUIRE(legacy != nullptr);
+	CHECK(wide->serviceUntil([&]() { return wide->serverConnects == total + 1 && legacy->state == ENET_PEER_STATE_CONNECTED; }, 30000));
+	CHECK(wide->lastConnectId < ENET_PROTOCOL_MAXIMUM_PEER_ID);
+}
+
+// Benchmarks connection setup and steady-state servicing with the server close to its 65535-peer ceiling.
+TEST_CASE(ExtendedPeerIdSixtyFourThousandPeers) {
+	auto wide = std::make_unique<WideServer>(4000, 16, true, ENET_HOST_BUFFER_SIZE_MAX);
+	REQUIRE(wide->created());
+
+	// Clients arrive in waves, and pings are spread out so a single test thread can keep every peer serviced.
+	wide->pingInterval = 5000;
+	REQUIRE(connectAll(*wide, 1000));
+
+	size_t connected = 0;
+	for (ENetPeer* peer : wide->peers) if (peer->state == ENET_PEER_STATE_CONNECTED) connected++;
+	CHECK(connected == wide->peers.size());
+
+	// Long enough for every peer to ping once.
+	measureSteadyState(*wide, wide->pingInterval);
+
+	// One reliable packet up from every peer, so lookup of every id is exercised under load.
+	for (ENetPeer* peer : wide->peers) enet_peer_send(peer, 0, enet_packet_create("up", 2, ENET_PACKET_FLAG_RELIABLE));
+	const auto deliveryStarted = std::chrono::steady_clock::now();
+	CHECK(wide->serviceUntil([&]() { return wide->serverReceives == wide->peers.size(); }, 60000));
+	report("%zu reliable packets delivered in %.0f ms", wide->peers.size(), elapsedMilliseconds(deliveryStarted));
+}
\ No newline at end of file
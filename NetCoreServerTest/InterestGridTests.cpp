@@ -0,0 +1,240 @@
+#include "TestFramework.hpp"
+#include <InterestGrid.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace NetCoreServer;
+using namespace NetCoreServerTest;
+
+namespace {
+	struct Position {
+		float x;
+		float y;
+	};
+
+	// Stands in for a connected player; the grid only copies the handle, so it is never dereferenced.
+	PeerHandle handleOf(size_t uid) {
+		return PeerHandle{ reinterpret_cast<ENetPeer*>(static_cast<uintptr_t>(uid + 1)), 0 };
+	}
+
+	bool within(const Position& a, const Position& b, float radius) {
+		const float dx = a.x - b.x;
+		const float dy = a.y - b.y;
+		return dx * dx + dy * dy <= radius * radius;
+	}
+
+	// A grid alongside the positions it was given, checked against testing every viewer with every entity.
+	// Everything starts inside the grid's bounds and drifts past them as it moves, into the edge cells.
+	struct World {
+		InterestGrid grid;
+		float radius;
+		std::vector<Position> entities;
+		std::vector<Position> viewers;
+		std::vector<bool> entityPresent;
+		std::vector<bool> viewerPresent;
+		std::mt19937 random{ 3 };
+
+		World(float cellSize, float radius, size_t entityCount, size_t viewerCount)
+			: grid(cellSize, radius, -500.0f, -500.0f, 500.0f, 500.0f), radius(radius), entities(entityCount), viewers(viewerCount), entityPresent(entityCount, true), viewerPresent(viewerCount, true) {
+			std::uniform_real_distribution<float> place(-500.0f, 500.0f);
+			for (size_t i = 0; i < entities.size(); i++) {
+				entities[i] = { place(random), place(random) };
+				grid.setEntity(i, entities[i].x, entities[i].y);
+			}
+			for (size_t uid = 0; uid < viewers.size(); uid++) {
+				viewers[uid] = { place(random), place(random) };
+				grid.setViewer(uid, handleOf(uid), viewers[uid].x, viewers[uid].y);
+			}
+		}
+
+		// Most moves are a step within the cell or into the next one; one in fifty is a jump across the map.
+		Position moved(const Position& position) {
+			std::uniform_real_distribution<float> step(-5.0f, 5.0f), jump(-500.0f, 500.0f);
+			if (random() % 50 == 0) return { jump(random), jump(random) };
+			return { position.x + step(random), position.y + step(random) };
+		}
+
+		// Without the grid only the positions move, as a server testing everyone against everyone would keep them.
+		void tick(bool withGrid = true) {
+			for (size_t i = 0; i < entities.size(); i++) {
+				if (!entityPresent[i]) continue;
+				entities[i] = moved(entities[i]);
+				if (withGrid) grid.setEntity(i, entities[i].x, entities[i].y);
+			}
+			for (size_t uid = 0; uid < viewers.size(); uid++) {
+				if (!viewerPresent[uid]) continue;
+				viewers[uid] = moved(viewers[uid]);
+				if (withGrid) grid.setViewer(uid, handleOf(uid), viewers[uid].x, viewers[uid].y);
+			}
+		}
+
+		// Returns how many queries differed from brute force.
+		size_t mismatches() const {
+			size_t mismatches = 0;
+			std::vector<PeerHandle> peers;
+			std::vector<uintptr_t> found, expected;
+			for (size_t i = 0; i < entities.size(); i++) {
+				grid.collectViewers(i, peers);
+				found.clear();
+				expected.clear();
+				for (const PeerHandle& peer : peers) found.push_back(reinterpret_cast<uintptr_t>(peer.peer));
+				if (entityPresent[i]) {
+					for (size_t uid = 0; uid < viewers.size(); uid++) {
+						if (viewerPresent[uid] && within(entities[i], viewers[uid], radius)) expected.push_back(uid + 1);
+					}
+				}
+				std::sort(found.begin(), found.end());
+				if (found != expected) mismatches++;
+			}
+
+			std::vector<uint64_t> ids, expectedIds;
+			for (size_t uid = 0; uid < viewers.size(); uid++) {
+				grid.collectEntities(uid, ids);
+				expectedIds.clear();
+				if (viewerPresent[uid]) {
+					for (size_t i = 0; i < entities.size(); i++) {
+						if (entityPresent[i] && within(entities[i], viewers[uid], radius)) expectedIds.push_back(i);
+					}
+				}
+				std::sort(ids.begin(), ids.end());
+				if (ids != expectedIds) mismatches++;
+			}
+			return mismatches;
+		}
+	};
+}
+
+// Queries match brute force as entities and viewers move, cross cells, jump, and leave, with cells smaller than, equal to, and larger than the radius.
+TEST_CASE(InterestGridMatchesBruteForce) {
+	const float cellSizes[] = { 20.0f, 50.0f, 120.0f };
+	for (float cellSize : cellSizes) {
+		World world(cellSize, 50.0f, 1000, 200);
+		CHECK(world.mismatches() == 0);
+
+		for (int tick = 0; tick < 20; tick++) world.tick();
+		CHECK(world.mismatches() == 0);
+
+		// Every other entity and every third viewer leave, and the rest keep moving.
+		for (size_t i = 0; i < world.entities.size(); i += 2) {
+			CHECK(world.grid.removeEntity(i));
+			world.entityPresent[i] = false;
+		}
+		for (size_t uid = 0; uid < world.viewers.size(); uid += 3) {
+			CHECK(world.grid.removeViewer(uid));
+			world.viewerPresent[uid] = false;
+		}
+		CHECK(!world.grid.removeEntity(0));
+		CHECK(!world.grid.removeViewer(0));
+		CHECK(world.grid.getEntityCount() == world.entities.size() / 2);
+		CHECK(world.grid.getViewerCount() == world.viewers.size() - (world.viewers.size() + 2) / 3);
+
+		for (int tick = 0; tick < 5; tick++) world.tick();
+		CHECK(world.mismatches() == 0);
+	}
+}
+
+// Bad sizes and bounds are refused, a tiny cell is widened so a query and the array stay bounded, and coordinates outside the bounds are kept apart from real ones.
+TEST_CASE(InterestGridRejectsBadArguments) {
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float badSizes[][6] = {
+		{ 0.0f, 50.0f, 0.0f, 0.0f, 100.0f, 100.0f }, { -1.0f, 50.0f, 0.0f, 0.0f, 100.0f, 100.0f }, { nan, 50.0f, 0.0f, 0.0f, 100.0f, 100.0f },
+		{ infinity, 50.0f, 0.0f, 0.0f, 100.0f, 100.0f }, { 50.0f, -1.0f, 0.0f, 0.0f, 100.0f, 100.0f }, { 50.0f, nan, 0.0f, 0.0f, 100.0f, 100.0f },
+		{ 50.0f, infinity, 0.0f, 0.0f, 100.0f, 100.0f }, { 50.0f, 50.0f, 100.0f, 0.0f, 0.0f, 100.0f }, { 50.0f, 50.0f, 0.0f, 100.0f, 100.0f, 0.0f },
+		{ 50.0f, 50.0f, -infinity, 0.0f, 100.0f, 100.0f }, { 50.0f, 50.0f, 0.0f, 0.0f, 100.0f, nan } };
+	for (const auto& size : badSizes) {
+		bool thrown = false;
+		try {
+			InterestGrid grid(size[0], size[1], size[2], size[3], size[4], size[5]);
+		} catch (const std::invalid_argument&) {
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+
+	World world(0.001f, 50.0f, 300, 60);
+	CHECK(world.grid.getCellSize() >= 50.0f / 8);
+	CHECK(InterestGrid(1.0f, 1.0f, -1e6f, 0.0f, 1e6f, 1.0f).getCellSize() >= 2e6f / 1024);
+	CHECK(world.mismatches() == 0);
+	world.tick();
+	CHECK(world.mismatches() == 0);
+
+	InterestGrid grid(50.0f, 50.0f, -500.0f, -500.0f, 500.0f, 500.0f);
+	grid.setViewer(1, handleOf(1), 0.0f, 0.0f);
+	grid.setViewer(2, handleOf(2), infinity, -infinity);
+	grid.setEntity(10, nan, 0.0f);
+	grid.setEntity(11, 3e38f, -3e38f);
+	grid.setEntity(12, infinity, -infinity);
+	grid.setEntity(13, 10.0f, 10.0f);
+
+	std::vector<PeerHandle> peers;
+	grid.collectViewers(10, peers);
+	CHECK(peers.empty());
+	grid.collectViewers(12, peers);
+	CHECK(peers.empty());
+	grid.collectViewers(13, peers);
+	CHECK(peers.size() == 1 && peers[0].peer == handleOf(1).peer);
+
+	std::vector<uint64_t> ids;
+	grid.collectEntities(2, ids);
+	CHECK(ids.empty());
+	grid.collectEntities(1, ids);
+	CHECK(ids == std::vector<uint64_t>{ 13 });
+
+	CHECK(grid.removeEntity(10));
+	CHECK(grid.removeEntity(11));
+	CHECK(grid.removeEntity(12));
+	CHECK(grid.removeViewer(2));
+}
+
+// One session tick at 1k entities and 200 players: every entity and player moves, then every entity's update finds its audience.
+// Testing every player against every entity does the same moves and builds the same peer lists; the grid has to cost less.
+TEST_CASE(InterestGridTickBenchmark) {
+	// Both worlds start from the same seed, so they make the same moves and find the same audiences.
+	World gridWorld(50.0f, 50.0f, 1000, 200);
+	World bruteWorld(50.0f, 50.0f, 1000, 200);
+	const int rounds = 10;
+	const int ticksPerRound = 20;
+	std::vector<PeerHandle> peers;
+	size_t gridTargets = 0;
+	size_t bruteTargets = 0;
+	double gridMilliseconds = std::numeric_limits<double>::max();
+	double bruteMilliseconds = std::numeric_limits<double>::max();
+
+	// Rounds alternate between the two and each keeps its fastest, so a stall on a shared machine does not land on one side.
+	for (int round = 0; round < rounds; round++) {
+		auto started = std::chrono::steady_clock::now();
+		for (int tick = 0; tick < ticksPerRound; tick++) {
+			gridWorld.tick();
+			for (size_t i = 0; i < gridWorld.entities.size(); i++) {
+				gridWorld.grid.collectViewers(i, peers);
+				gridTargets += peers.size();
+			}
+		}
+		gridMilliseconds = std::min(gridMilliseconds, elapsedMilliseconds(started) / ticksPerRound);
+
+		started = std::chrono::steady_clock::now();
+		for (int tick = 0; tick < ticksPerRound; tick++) {
+			bruteWorld.tick(false);
+			for (const Position& entity : bruteWorld.entities) {
+				peers.clear();
+				for (size_t uid = 0; uid < bruteWorld.viewers.size(); uid++) {
+					if (within(entity, bruteWorld.viewers[uid], bruteWorld.radius)) peers.push_back(handleOf(uid));
+				}
+				bruteTargets += peers.size();
+			}
+		}
+		bruteMilliseconds = std::min(bruteMilliseconds, elapsedMilliseconds(started) / ticksPerRound);
+	}
+
+	const double averageTargets = static_cast<double>(gridTargets) / (rounds * ticksPerRound) / gridWorld.entities.size();
+	CHECK(gridTargets == bruteTargets);
+	CHECK(averageTargets < static_cast<double>(gridWorld.viewers.size()) / 10);
+	CHECK(gridMilliseconds < bruteMilliseconds);
+
+	report("grid: %.3f ms per tick, %.2f players per update instead of %zu", gridMilliseconds, averageTargets, gridWorld.viewers.size());
+	report("every player against every entity: %.3f ms per tick", bruteMilliseconds);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "LinkSimulator.hpp"
+#include "TestFramework.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace NetCoreServerTest {
+	std::atomic<uint32_t> SimulatedClock::now = 0;
+
+	uint32_t ENET_CALLBACK SimulatedClock::get() {
+		return now.load();
+	}
+
+	SimulatedClock::SimulatedClock() {
+		// Carries on from the system clock, so nothing already timed against it jumps.
+		now = enet_time_get();
+		enet_time_set_source(get);
+	}
+
+	SimulatedClock::~SimulatedClock() {
+		enet_time_set_source(nullptr);
+	}
+
+	LinkSimulator::LinkSimulator(uint16_t serverPort, LinkOptions options) : options(options), random(options.seed) {
+		socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+		if (socket == ENET_SOCKET_NULL) throw std::runtime_error("link socket could not be created");
+
+		ENetAddress any{};
+		any.ipv6 = ENET_HOST_ANY;
+		if (enet_socket_bind(socket, &any) < 0 || enet_socket_get_address(socket, &address) < 0) {
+			enet_socket_destroy(socket);
+			throw std::runtime_error("link socket could not be bound");
+		}
+		enet_socket_set_option(socket, ENET_SOCKOPT_NONBLOCK, 1);
+		enet_socket_set_option(socket, ENET_SOCKOPT_RCVBUF, 8 << 20);
+
+		const uint16_t port = address.port;
+		enet_address_set_ip(&address, "::1");
+		address.port = port;
+
+		enet_address_set_ip(&server, "::1");
+		server.port = serverPort;
+	}
+
+	LinkSimulator::~LinkSimulator() {
+		enet_socket_destroy(socket);
+	}
+
+	void LinkSimulator::pump() {
+		const uint32_t now = enet_time_get();
+		std::uniform_int_distribution<uint32_t> roll(0, 9999);
+
+		for (;;) {
+			uint8_t data[ENET_PROTOCOL_MAXIMUM_MTU];
+			ENetAddress from;
+			ENetBuffer buffer{};
+			buffer.data = data;
+			buffer.dataLength = sizeof(data);
+
+			const int length = enet_socket_receive(socket, &from, &buffer, 1);
+			if (length <= 0) break;
+
+			const bool toServer = from.port != server.port;
+			if (toServer && !haveClient) {
+				client = from;
+				haveClient = true;
+			}
+
+			relayed++;
+			if ((options.mtu != 0 && static_cast<uint32_t>(length) > options.mtu) || roll(random) < options.lossPerTenThousand) {
+				dropped++;
+				continue;
+			}
+
+			uint32_t due = now + options.delay;
+			if (toServer && options.rate != 0) {
+				// What the bottleneck holds is what it has yet to send at its rate.
+				const double start = std::max(bottleneckFree, static_cast<double>(now));
+				const double wait = start - now;
+				if (wait * options.rate / 1000.0 + length > options.queueLimit) {
+					queueDropped++;
+					dropped++;
+					continue;
+				}
+
+				bottleneckFree = start + static_cast<double>(length) * 1000.0 / options.rate;
+				queued++;
+				queueDelayTotal += wait;
+				queueDelayMax = std::max(queueDelayMax, wait);
+				due = static_cast<uint32_t>(std::ceil(bottleneckFree)) + options.delay;
+			}
+
+			inFlight.push_back({ due, toServer, std::vector<uint8_t>(data, data + length) });
+		}
+
+		// Each direction keeps its order, but a backlog at the bottleneck lets replies overtake the client's datagrams.
+		for (auto datagram = inFlight.begin(); datagram != inFlight.end();) {
+			if (!ENET_TIME_LESS_EQUAL(datagram->due, now)) {
+				++datagram;
+				continue;
+			}
+
+			ENetBuffer buffer{};
+			buffer.data = datagram->data.data();
+			buffer.dataLength = datagram->data.size();
+			enet_socket_send(socket, datagram->toServer ? &server : &client, &buffer, 1);
+			datagram = inFlight.erase(datagram);
+		}
+	}
+
+	LinkedHosts::LinkedHosts(size_t channelCount, size_t serverPeers, ENetHostBackend backend) {
+		ENetAddress address{};
+		address.ipv6 = ENET_HOST_ANY;
+
+		server = enet_host_create_with_backend(&address, serverPeers, channelCount, 0, 0, 0, backend);
+		client = enet_host_create_with_backend(nullptr, 1, channelCount, 0, 0, 0, backend);
+		if (!server || !client) {
+			if (server) enet_host_destroy(server);
+			if (client) enet_host_destroy(client);
+			throw std::runtime_error("hosts could not be created");
+		}
+	}
+
+	LinkedHosts::~LinkedHosts() {
+		enet_host_destroy(client);
+		enet_host_destroy(server);
+	}
+
+	bool LinkedHosts::connect(const LinkOptions& options, uint32_t timeout) {
+		link = std::make_unique<LinkSimulator>(server->address.port, options);
+		return connectTo(link->getAddress(), timeout);
+	}
+
+	bool LinkedHosts::connect(uint32_t timeout) {
+		ENetAddress address{};
+		enet_address_set_ip(&address, "::1");
+		address.port = server->address.port;
+		return connectTo(address, timeout);
+	}
+
+	bool LinkedHosts::connectTo(const ENetAddress& address, uint32_t timeout) {
+		clientPeer = enet_host_connect(client, &address, client->channelLimit, 0);
+		if (!clientPeer) return false;
+
+		bool clientConnected = false;
+		return runUntil([&]() { return clientConnected && serverPeer != nullptr; }, timeout,
+			[&](const ENetEvent& event) {
+				if (event.type == ENET_EVENT_TYPE_CONNECT) serverPeer = event.peer;
+			},
+			[&](const ENetEvent& event) {
+				if (event.type == ENET_EVENT_TYPE_CONNECT) clientConnected = true;
+			});
+	}
+
+	void LinkedHosts::step(const std::function<void(const ENetEvent&)>& onServerEvent, const std::function<void(const ENetEvent&)>& onClientEvent) {
+		ENetEvent event;
+
+		if (link) link->pump();
+
+		while (enet_host_service(client, &event, 0) > 0) {
+			if (onClientEvent) onClientEvent(event);
+			if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+		}
+
+		while (enet_host_service(server, &event, 0) > 0) {
+			if (onServerEvent) onServerEvent(event);
+			if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+		}
+	}
+
+	bool LinkedHosts::runUntil(const std::function<bool()>& done, uint32_t timeout, const std::function<void(const ENetEvent&)>& onServerEvent, const std::function<void(const ENetEvent&)>& onClientEvent) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+		const uint32_t simulatedDeadline = clock != nullptr ? clock->milliseconds() + timeout : 0;
+
+		while (!done()) {
+			if (clock != nullptr ? ENET_TIME_GREATER_EQUAL(clock->milliseconds(), simulatedDeadline) : std::chrono::steady_clock::now() >= deadline) return false;
+			step(onServerEvent, onClientEvent);
+			if (clock != nullptr) clock->advance(1);
+			else std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+
+		return true;
+	}
+
+	LinkRunResult runLink(const LinkRun& run) {
+		LinkRunResult result;
+		std::unique_ptr<SimulatedClock> clock = run.simulatedClock ? std::make_unique<SimulatedClock>() : nullptr;
+		LinkedHosts hosts(run.channelCount);
+		hosts.clock = clock.get();
+		if (run.configure) run.configure(hosts);
+
+		result.connected = hosts.connect(run.link);
+		if (!result.connected) return result;
+		if (run.start) run.start(hosts);
+
+		const uint32_t datagramsBefore = enet_host_get_packets_sent(hosts.server);
+		const auto started = std::chrono::steady_clock::now();
+		const uint32_t simulatedStart = clock != nullptr ? clock->milliseconds() : 0;
+		auto elapsed = [&]() {
+			return clock != nullptr ? static_cast<double>(clock->milliseconds() - simulatedStart) : elapsedMilliseconds(started);
+		};
+
+		while (!(run.done && run.done())) {
+			const double now = elapsed();
+			if (now >= run.duration) break;
+
+			run.send(hosts, now);
+			hosts.step([&](const ENetEvent& event) {
+				if (event.type == ENET_EVENT_TYPE_RECEIVE && run.receive) run.receive(event, elapsed());
+				});
+			if (clock != nullptr) clock->advance(1);
+			else std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+
+		result.elapsed = elapsed();
+		result.retransmitted = enet_peer_get_packets_lost(hosts.clientPeer);
+		result.dropped = hosts.link->getDropped();
+		result.serverDatagrams = enet_host_get_packets_sent(hosts.server) - datagramsBefore;
+		if (run.finish) run.finish(hosts);
+
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+#include <enet/enet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace NetCoreServerTest {
+	struct LinkOptions {
+		uint32_t lossPerTenThousand = 0;	// Chance of dropping each datagram, either way.
+		uint32_t delay = 0;					// One-way delay in ms.
+		uint32_t mtu = 0;					// Largest datagram passed either way, or 0 for any.
+		uint32_t rate = 0;					// Bytes per second the client's uplink carries, or 0 for no bottleneck.
+		uint32_t queueLimit = 64 * 1024;	// Bytes the bottleneck holds waiting to go out before it drops what arrives.
+		uint32_t seed = 1;
+	};
+
+	// While one exists, ENet and the link read the time from it instead of the system clock, and it only moves when advanced.
+	// A run on it takes the same steps however long the machine holds the test up between them.
+	class SimulatedClock final {
+	private:
+		static std::atomic<uint32_t> now;
+
+		static uint32_t ENET_CALLBACK get();
+
+	public:
+		SimulatedClock();
+		~SimulatedClock();
+
+		SimulatedClock(const SimulatedClock&) = delete;
+		SimulatedClock& operator=(const SimulatedClock&) = delete;
+
+		void advance(uint32_t milliseconds) {
+			now += milliseconds;
+		}
+
+		uint32_t milliseconds() const {
+			return now.load();
+		}
+	};
+
+	// UDP relay on the loopback interface between one server and the first client that sends through it.
+	// Datagrams are dropped at random or when larger than the path, and held for a fixed delay each way, so their order is kept.
+	// With a rate set, the client's datagrams first queue at a bottleneck sending that many bytes a second, dropped once its queue is full.
+	class LinkSimulator final {
+	private:
+		struct Datagram {
+			uint32_t due;
+			bool toServer;
+			std::vector<uint8_t> data;
+		};
+
+		ENetSocket socket;
+		ENetAddress address;
+		ENetAddress server;
+		ENetAddress client{};
+		bool haveClient = false;
+		LinkOptions options;
+		std::mt19937 random;
+		std::deque<Datagram> inFlight;
+		uint64_t relayed = 0;
+		uint64_t dropped = 0;
+		// When the bottleneck finishes sending what it holds, in ms on the ENet clock.
+		double bottleneckFree = 0.0;
+		uint64_t queueDropped = 0;
+		uint64_t queued = 0;
+		double queueDelayTotal = 0.0;
+		double queueDelayMax = 0.0;
+
+	public:
+		LinkSimulator(uint16_t serverPort, LinkOptions options);
+		~LinkSimulator();
+
+		LinkSimulator(const LinkSimulator&) = delete;
+		LinkSimulator& operator=(const LinkSimulator&) = delete;
+
+		// Where the client connects to reach the server through the link.
+		const ENetAddress& getAddress() const {
+			return address;
+		}
+
+		// Takes in whatever either side sent and passes on what is due.
+		void pump();
+
+		// Changes the largest datagram passed from now on, as a route change would.
+		void setMtu(uint32_t mtu) {
+			options.mtu = mtu;
+		}
+
+		uint64_t getRelayed() const {
+			return relayed;
+		}
+
+		// All datagrams dropped, at random, for their size or by a full bottleneck.
+		uint64_t getDropped() const {
+			return dropped;
+		}
+
+		uint64_t getQueueDropped() const {
+			return queueDropped;
+		}
+
+		// Time the client's datagrams waited at the bottleneck, over those it took in.
+		double getMeanQueueDelay() const {
+			return queued > 0 ? queueDelayTotal / queued : 0.0;
+		}
+
+		double getMaxQueueDelay() const {
+			return queueDelayMax;
+		}
+	};
+
+	// A server host and a client host, joined directly or through a LinkSimulator. Configure both hosts before connect().
+	class LinkedHosts final {
+	private:
+		bool connectTo(const ENetAddress& address, uint32_t timeout);
+
+	public:
+		ENetHost* server = nullptr;
+		ENetHost* client = nullptr;
+		ENetPeer* clientPeer = nullptr;	// The client's peer for the server.
+		ENetPeer* serverPeer = nullptr;	// The server's peer for the client.
+		std::unique_ptr<LinkSimulator> link;
+		// When set, runUntil advances it a millisecond a step instead of sleeping, and its timeout counts simulated time.
+		SimulatedClock* clock = nullptr;
+
+		LinkedHosts(size_t channelCount, size_t serverPeers = 4, ENetHostBackend backend = ENET_HOST_BACKEND_SOCKET);
+		~LinkedHosts();
+
+		LinkedHosts(const LinkedHosts&) = delete;
+		LinkedHosts& operator=(const LinkedHosts&) = delete;
+
+		// Connects through a new link and returns whether both sides saw the connection within timeout ms.
+		bool connect(const LinkOptions& options, uint32_t timeout = 5000);
+
+		// Connects straight to the server, with no link in between.
+		bool connect(uint32_t timeout = 5000);
+
+		// Services the link and both hosts once. Received packets are destroyed after the handler sees them.
+		void step(const std::function<void(const ENetEvent&)>& onServerEvent, const std::function<void(const ENetEvent&)>& onClientEvent = nullptr);
+
+		// Steps until done returns true or timeout ms pass, and returns done's last answer.
+		bool runUntil(const std::function<bool()>& done, uint32_t timeout, const std::function<void(const ENetEvent&)>& onServerEvent, const std::function<void(const ENetEvent&)>& onClientEvent = nullptr);
+	};
+
+	// Traffic from client to server through a link: fresh hosts are set up, connected, and stepped until done or the duration is up.
+	// Every callback but send is optional; the ms passed to send and receive count from the end of the handshake.
+	struct LinkRun {
+		size_t channelCount = 1;
+		LinkOptions link;
+		// Steps a simulated millisecond at a time instead of following the system clock.
+		bool simulatedClock = false;
+		// Applied to the fresh hosts before they connect.
+		std::function<void(LinkedHosts&)> configure;
+		// Called once connected, before the first send.
+		std::function<void(LinkedHosts&)> start;
+		// Called before every step to queue whatever is due by then.
+		std::function<void(LinkedHosts&, double)> send;
+		// Sees every packet the server receives; it is destroyed afterwards.
+		std::function<void(const ENetEvent&, double)> receive;
+		std::function<bool()> done;
+		double duration = 30000.0;
+		// Called with the hosts still connected once the run ends, to read their counters.
+		std::function<void(LinkedHosts&)> finish;
+	};
+
+	struct LinkRunResult {
+		bool connected = false;
+		double elapsed = 0.0;
+		uint64_t retransmitted = 0;		// Reliable commands the client sent again.
+		uint64_t dropped = 0;			// Datagrams the link dropped.
+		uint32_t serverDatagrams = 0;	// Datagrams the server sent during the run.
+	};
+
+	LinkRunResult runLink(const LinkRun& run);
+}
\ No newline at end of file
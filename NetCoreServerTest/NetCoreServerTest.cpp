@@ -1,4 +1,5 @@
 #include <NetCoreServer.hpp>
+#include "TestFramework.hpp"
 
 using namespace NetCoreServer;
 using namespace std;
@@ -18,9 +19,15 @@ SessionPtr gen(const SessionInfo& info, const SessionCreationOption& opt) {
 	return make_shared<SimpleSession>(info, opt);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
 	initialize();
+
+	// "NetCoreServerTest test [filter]" runs the tests instead of the sample server.
+	if (argc > 1 && string(argv[1]) == "test") {
+		return NetCoreServerTest::TestRegistry::instance().run(argc > 2 ? argv[2] : "") == 0 ? 0 : 1;
+	}
+
 	Logger::start();
 	LoginFunc func = [](LoginData data) -> LoginResult {
 		LoginResult result;
@@ -29,7 +36,7 @@ int main()
 		return result;
 	};
 	MainServer mainServer(func, [](uint64_t _) {return ""; }, SessionServerOption{
-		10, 10, 10, make_pair(6000, 6010)
+		.maxConnection = 10, .maxChannel = 10, .maxSessions = 10, .portRange = make_pair(6000, 6010)
 	}, 12345, 10, 10);
 	mainServer.registerSessionGenerator("", gen);
 	
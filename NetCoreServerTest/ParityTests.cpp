@@ -0,0 +1,97 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct ParityResult {
+		LinkRunResult link;
+		int received = 0;
+		bool intact = true;
+		uint64_t repaired = 0;
+		uint32_t clientDatagrams = 0;
+	};
+
+	// Streams count unreliable messages from client to server over a link dropping 10% of datagrams each way.
+	// They go a burst at a time, one message a millisecond on average, so a burst shares its datagrams the way a session tick's updates do.
+	ParityResult stream(bool parity, uint32_t flags, int burst, int count) {
+		ParityResult result;
+		std::vector<bool> seen(count, false);
+		int sent = 0;
+
+		LinkRun run;
+		run.channelCount = 2;
+		run.link.lossPerTenThousand = 1000;
+		run.link.delay = 5;
+		// Each step is one simulated millisecond, so every run packs messages into datagrams the same way.
+		run.simulatedClock = true;
+		// A last stretch of idle steps lets the final parity command and stragglers arrive.
+		run.duration = count + 200.0;
+		run.start = [&](LinkedHosts& hosts) {
+			enet_peer_channel_parity(hosts.clientPeer, 1, parity);
+		};
+		run.send = [&](LinkedHosts& hosts, double elapsed) {
+			while (sent < count && elapsed >= static_cast<double>(sent / burst * burst)) {
+				uint8_t message[120];
+				for (size_t i = 0; i < sizeof(message); i++) message[i] = static_cast<uint8_t>(sent * 31 + i);
+				std::memcpy(message, &sent, sizeof(sent));
+				enet_peer_send(hosts.clientPeer, 1, enet_packet_create(message, sizeof(message), flags));
+				sent++;
+			}
+		};
+		run.receive = [&](const ENetEvent& event, double) {
+			int index;
+			std::memcpy(&index, event.packet->data, sizeof(index));
+			if (event.packet->dataLength != 120 || index < 0 || index >= count || seen[index]) {
+				result.intact = false;
+				return;
+			}
+			for (size_t i = sizeof(index); i < event.packet->dataLength; i++) {
+				if (event.packet->data[i] != static_cast<uint8_t>(index * 31 + i)) result.intact = false;
+			}
+			seen[index] = true;
+			result.received++;
+		};
+		run.finish = [&](LinkedHosts& hosts) {
+			result.repaired = enet_peer_get_packets_repaired(hosts.serverPeer);
+			result.clientDatagrams = enet_host_get_packets_sent(hosts.client);
+		};
+		result.link = runLink(run);
+
+		return result;
+	}
+
+	void compare(uint32_t flags, int burst, const char* name) {
+		const int count = 1500;
+		const ParityResult plain = stream(false, flags, burst, count);
+		const ParityResult repaired = stream(true, flags, burst, count);
+
+		REQUIRE(plain.link.connected);
+		REQUIRE(repaired.link.connected);
+		CHECK(plain.intact);
+		CHECK(repaired.intact);
+		CHECK(plain.repaired == 0);
+		CHECK(repaired.repaired > 0);
+		CHECK(repaired.received > plain.received);
+		// Parity rides in the next datagram the client sends anyway. A burst fills its datagram, and the parity of the groups
+		// it completes together, each as long as a message, needs one more; pings and acknowledgements vary a little either way.
+		if (burst == 1) CHECK(repaired.clientDatagrams <= plain.clientDatagrams + plain.clientDatagrams / 50);
+
+		report("%s without parity: %d of %d delivered, %u datagrams sent, %llu dropped", name, plain.received, count, plain.clientDatagrams, static_cast<unsigned long long>(plain.link.dropped));
+		report("%s with parity:    %d of %d delivered, %u datagrams sent, %llu dropped, %llu repaired", name, repaired.received, count, repaired.clientDatagrams, static_cast<unsigned long long>(repaired.link.dropped), static_cast<unsigned long long>(repaired.repaired));
+	}
+}
+
+// With one datagram in ten dropped, parity rebuilds a lost unreliable message from the rest of its group instead of leaving it to the next update.
+// A sequenced channel drops a message rebuilt after a later one was delivered, so there it only saves the last member of a group.
+TEST_CASE(ParityRepairsUnreliableLoss) {
+	compare(0, 1, "unreliable, one at a time: ");
+	compare(0, 8, "unreliable, bursts of 8:   ");
+}
+
+TEST_CASE(ParityRepairsUnsequencedLoss) {
+	compare(ENET_PACKET_FLAG_UNSEQUENCED, 1, "unsequenced, one at a time:");
+	compare(ENET_PACKET_FLAG_UNSEQUENCED, 8, "unsequenced, bursts of 8:  ");
+}
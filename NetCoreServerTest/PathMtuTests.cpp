@@ -0,0 +1,63 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+// A path that shrinks below the discovered MTU silently drops every full datagram; the client must notice, fall back and keep delivering.
+TEST_CASE(PathMtuBlackHoleFallsBack) {
+	SimulatedClock clock;
+	LinkedHosts hosts(1);
+	hosts.clock = &clock;
+	enet_host_mtu_discovery(hosts.client, ENET_HOST_DEFAULT_MTU);
+	enet_socket_set_option(hosts.server->socket, ENET_SOCKOPT_RCVBUF, 8 << 20);
+	enet_socket_set_option(hosts.client->socket, ENET_SOCKOPT_RCVBUF, 8 << 20);
+
+	LinkOptions options;
+	options.delay = 5;
+	options.mtu = ENET_HOST_DEFAULT_MTU;
+	REQUIRE(hosts.connect(options));
+
+	// The server's replies stay under any path the test shrinks to, so only the client has to adapt.
+	hosts.serverPeer->mtu = ENET_PROTOCOL_MINIMUM_MTU;
+
+	REQUIRE(hosts.runUntil([&]() { return hosts.clientPeer->mtu == ENET_HOST_DEFAULT_MTU; }, 5000, nullptr));
+
+	const uint32_t pathMtu = 1000;
+	hosts.link->setMtu(pathMtu);
+
+	// Messages pack each datagram up to the MTU the client last confirmed.
+	const int messageCount = 3000;
+	uint8_t message[100] = {};
+	int received = 0;
+	size_t largeReceived = 0;
+	bool disconnected = false;
+	auto onServerEvent = [&](const ENetEvent& event) {
+		if (event.type == ENET_EVENT_TYPE_DISCONNECT) disconnected = true;
+		if (event.type != ENET_EVENT_TYPE_RECEIVE) return;
+		if (event.packet->dataLength == sizeof(message)) received++;
+		else largeReceived = event.packet->dataLength;
+	};
+
+	for (int i = 0; i < messageCount; i++) {
+		std::memcpy(message, &i, sizeof(i));
+		enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+	}
+
+	CHECK(hosts.runUntil([&]() { return received == messageCount || disconnected; }, 20000, onServerEvent));
+	CHECK(received == messageCount);
+	CHECK(hosts.clientPeer->mtu <= pathMtu);
+
+	// New fragments are cut to what the path carries, and the search settles just under it again.
+	std::vector<uint8_t> large(20000, 0x5A);
+	enet_peer_send(hosts.clientPeer, 0, enet_packet_create(large.data(), large.size(), ENET_PACKET_FLAG_RELIABLE));
+	CHECK(hosts.runUntil([&]() { return largeReceived != 0 || disconnected; }, 20000, onServerEvent));
+	CHECK(largeReceived == large.size());
+	CHECK(hosts.runUntil([&]() { return hosts.clientPeer->mtuSearchLimit <= hosts.clientPeer->mtu + ENET_PEER_MTU_PROBE_GRANULARITY; }, 20000, onServerEvent));
+	CHECK(hosts.clientPeer->mtu > pathMtu - ENET_PEER_MTU_PROBE_GRANULARITY && hosts.clientPeer->mtu <= pathMtu);
+	CHECK(!disconnected);
+	CHECK(hosts.clientPeer->state == ENET_PEER_STATE_CONNECTED);
+
+	report("path %u: settled at mtu %u, %llu datagrams dropped", pathMtu, hosts.clientPeer->mtu, static_cast<unsigned long long>(hosts.link->getDropped()));
+}
\ No newline at end of file
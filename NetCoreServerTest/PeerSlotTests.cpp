@@ -0,0 +1,323 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct SlotHosts {
+		ENetHost* server = nullptr;
+		ENetHost* client = nullptr;
+		ENetAddress address{};
+		size_t serverConnects = 0;
+		size_t serverDisconnects = 0;
+		ENetPeer* lastConnected = nullptr;
+
+		SlotHosts(size_t serverPeers, size_t clientPeers) {
+			ENetAddress any{};
+			any.ipv6 = ENET_HOST_ANY;
+			server = enet_host_create(&any, serverPeers, 1, 0, 0, 0);
+			client = enet_host_create(nullptr, clientPeers, 1, 0, 0, 0);
+
+			enet_address_set_ip(&address, "::1");
+			if (server) address.port = server->address.port;
+		}
+
+		~SlotHosts() {
+			if (client) enet_host_destroy(client);
+			if (server) enet_host_destroy(server);
+		}
+
+		void service() {
+			ENetEvent event;
+			while (enet_host_service(client, &event, 0) > 0) {
+				if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+			while (enet_host_service(server, &event, 0) > 0) {
+				if (event.type == ENET_EVENT_TYPE_CONNECT) {
+					serverConnects++;
+					lastConnected = event.peer;
+				}
+				else if (event.type == ENET_EVENT_TYPE_DISCONNECT) serverDisconnects++;
+				else if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+		}
+
+		bool serviceUntil(const std::function<bool()>& done, uint32_t timeout) {
+			const auto started = std::chrono::steady_clock::now();
+			while (!done()) {
+				if (elapsedMilliseconds(started) > timeout) return false;
+				service();
+			}
+			return true;
+		}
+
+		std::vector<ENetPeer*> connect(size_t count) {
+			std::vector<ENetPeer*> peers;
+			for (size_t i = 0; i < count; i++) peers.push_back(enet_host_connect(client, &address, 1, 0));
+			return peers;
+		}
+
+		// The client's own slots are free again only once it has seen each disconnect through.
+		bool clientIdle() const {
+			for (size_t slot = 0; slot < client->peerSlotCount; slot++) if (client->peers[slot].state != ENET_PEER_STATE_DISCONNECTED) return false;
+			return true;
+		}
+
+		// Every slot in use sits in exactly one address bucket and every free slot on exactly one free list, both within the slot range.
+		bool slotListsConsistent() const {
+			size_t bucketed = 0, free = 0, inUse = 0;
+			auto walk = [&](const ENetList* list, bool wantFree, size_t& count) {
+				for (ENetListIterator node = enet_list_begin(list); node != enet_list_end(list); node = enet_list_next(node)) {
+					const ENetPeer* peer = reinterpret_cast<const ENetPeer*>(reinterpret_cast<const uint8_t*>(node) - offsetof(ENetPeer, slotList));
+					if (peer < server->peers || peer >= server->peers + server->peerSlotCount) return false;
+					if ((peer->state == ENET_PEER_STATE_DISCONNECTED) != wantFree) return false;
+					count++;
+				}
+				return true;
+			};
+
+			for (size_t bucket = 0; bucket <= server->addressBucketMask; bucket++) {
+				if (!walk(&server->addressBuckets[bucket], false, bucketed)) return false;
+			}
+			if (!walk(&server->freePeerSlots[0], true, free) || !walk(&server->freePeerSlots[1], true, free)) return false;
+
+			for (size_t slot = 0; slot < server->peerSlotCount; slot++) if (server->peers[slot].state != ENET_PEER_STATE_DISCONNECTED) inUse++;
+			return bucketed == inUse && bucketed + free == server->peerSlotCount;
+		}
+	};
+}
+
+// Slot pages are committed as peers connect and handed back once enough trailing slots are free, so usage follows load.
+TEST_CASE(PeerSlotMemoryFollowsLoad) {
+	const size_t slotCount = 4096;
+	const size_t peerCount = 256;
+	SlotHosts hosts(slotCount, peerCount);
+	REQUIRE(hosts.server && hosts.client);
+	REQUIRE(peerCount * sizeof(ENetPeer) >= ENET_HOST_PEER_TRIM_THRESHOLD);
+
+	ENetHostMemoryUsage idle{};
+	enet_host_get_memory_usage(hosts.server, &idle);
+	CHECK(idle.peerSlots == slotCount);
+	CHECK(idle.usedPeerSlots == 0);
+	CHECK(idle.connectedPeers == 0);
+	CHECK(idle.usedBytes < idle.reservedBytes / 16);
+
+	auto peers = hosts.connect(peerCount);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == peerCount; }, 10000));
+
+	ENetHostMemoryUsage loaded{};
+	enet_host_get_memory_usage(hosts.server, &loaded);
+	CHECK(loaded.usedPeerSlots == peerCount);
+	CHECK(loaded.connectedPeers == peerCount);
+	CHECK(loaded.usedBytes >= idle.usedBytes + peerCount * (sizeof(ENetPeer) + sizeof(ENetChannel)));
+	CHECK(loaded.usedBytes <= loaded.reservedBytes);
+	CHECK(loaded.reservedBytes == idle.reservedBytes);
+
+	for (auto peer : peers) enet_peer_disconnect(peer, 0);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverDisconnects == peerCount; }, 10000));
+	// Slots are trimmed at the start of the service call after the one that reported them disconnected.
+	hosts.service();
+
+	ENetHostMemoryUsage drained{};
+	enet_host_get_memory_usage(hosts.server, &drained);
+	CHECK(drained.usedPeerSlots == 0);
+	CHECK(drained.connectedPeers == 0);
+	CHECK(drained.usedBytes == idle.usedBytes);
+
+	report("%zu of %zu slots: %zu KB used of %zu KB reserved, %zu KB once drained", peerCount, slotCount, loaded.usedBytes / 1024, loaded.reservedBytes / 1024, drained.usedBytes / 1024);
+}
+
+// Server::getMemoryUsage reports the host as its handlers see it.
+TEST_CASE(ServerReportsMemoryUsage) {
+	const size_t peerCount = 16;
+	NetCoreServer::Server server(27150, 64, 2);
+	std::mutex mutex;
+	ENetHostMemoryUsage connected{};
+	ENetHostMemoryUsage disconnected{};
+	size_t connects = 0;
+	size_t disconnects = 0;
+
+	server.registerConnectionHandler([&](ENetPeer*) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (++connects == peerCount) connected = server.getMemoryUsage();
+		});
+	server.registerDisconnectionHandler([&](ENetPeer*) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (++disconnects == peerCount) disconnected = server.getMemoryUsage();
+		});
+
+	ENetHost* client = enet_host_create(nullptr, peerCount, 2, 0, 0, 0);
+	REQUIRE(client != nullptr);
+	ENetAddress address{};
+	enet_address_set_ip(&address, "::1");
+	address.port = server.getServerPort();
+
+	std::vector<ENetPeer*> peers;
+	for (size_t i = 0; i < peerCount; i++) peers.push_back(enet_host_connect(client, &address, 2, 0));
+
+	auto serviceUntil = [&](const std::function<bool()>& done) {
+		const auto started = std::chrono::steady_clock::now();
+		while (elapsedMilliseconds(started) < 10000) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (done()) return true;
+			}
+			ENetEvent event;
+			while (enet_host_service(client, &event, 1) > 0) {
+				if (event.type == ENET_EVENT_TYPE_RECEIVE) enet_packet_destroy(event.packet);
+			}
+		}
+		return false;
+	};
+
+	CHECK(serviceUntil([&]() { return connects == peerCount; }));
+	for (auto peer : peers) enet_peer_disconnect(peer, 0);
+	CHECK(serviceUntil([&]() { return disconnects == peerCount; }));
+	enet_host_destroy(client);
+	server.stop();
+
+	CHECK(connected.peerSlots == 64);
+	CHECK(connected.usedPeerSlots == peerCount);
+	CHECK(connected.connectedPeers == peerCount);
+	CHECK(connected.usedBytes >= peerCount * sizeof(ENetPeer));
+	CHECK(connected.usedBytes <= connected.reservedBytes);
+	CHECK(disconnected.connectedPeers == 0);
+}
+
+// Waves of peers from one address connect and leave; the bucket they share and the free slots must stay exact, and slots are reused rather than grown.
+TEST_CASE(PeerSlotReconnectStorm) {
+	const size_t peerCount = 64;
+	const int rounds = 20;
+	SlotHosts hosts(1024, peerCount);
+	REQUIRE(hosts.server && hosts.client);
+
+	bool consistent = true;
+	size_t mostSlots = 0;
+	for (int round = 0; round < rounds; round++) {
+		const size_t connects = hosts.serverConnects;
+		const size_t disconnects = hosts.serverDisconnects;
+
+		auto peers = hosts.connect(peerCount);
+		REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == connects + peerCount; }, 10000));
+		consistent = consistent && hosts.slotListsConsistent();
+
+		ENetHostMemoryUsage usage{};
+		enet_host_get_memory_usage(hosts.server, &usage);
+		CHECK(usage.connectedPeers == peerCount);
+		if (usage.usedPeerSlots > mostSlots) mostSlots = usage.usedPeerSlots;
+
+		// Half leave gracefully, the rest are dropped by the client and must be disconnected by the server.
+		for (size_t i = 0; i < peerCount; i++) {
+			if (i % 2 == 0) enet_peer_disconnect(peers[i], 0);
+			else enet_peer_disconnect_now(peers[i], 0);
+		}
+		REQUIRE(hosts.serviceUntil([&]() { return hosts.serverDisconnects == disconnects + peerCount && hosts.clientIdle(); }, 10000));
+		hosts.service();
+		consistent = consistent && hosts.slotListsConsistent();
+	}
+
+	ENetHostMemoryUsage drained{};
+	enet_host_get_memory_usage(hosts.server, &drained);
+	CHECK(consistent);
+	CHECK(mostSlots == peerCount);
+	CHECK(drained.connectedPeers == 0);
+	CHECK(hosts.serverConnects == peerCount * rounds);
+
+	report("%d rounds of %zu peers from one address, at most %zu slots in use", rounds, peerCount, mostSlots);
+}
+
+// Peers sharing an address count against the duplicate limit, and a slot that leaves the bucket makes room for the next one.
+TEST_CASE(PeerSlotDuplicateLimitAcrossSharedAddress) {
+	const size_t limit = 4;
+	const size_t peerCount = 8;
+	SlotHosts hosts(64, peerCount);
+	REQUIRE(hosts.server && hosts.client);
+	enet_host_set_max_duplicate_peers(hosts.server, limit);
+
+	auto peers = hosts.connect(peerCount);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == limit; }, 5000));
+	// The rest keep retrying their connects and are turned away every time.
+	hosts.serviceUntil([]() { return false; }, 1000);
+	CHECK(hosts.serverConnects == limit);
+	CHECK(hosts.slotListsConsistent());
+
+	ENetHostMemoryUsage usage{};
+	enet_host_get_memory_usage(hosts.server, &usage);
+	CHECK(usage.connectedPeers == limit);
+
+	size_t connected = 0;
+	for (auto peer : peers) if (peer->state == ENET_PEER_STATE_CONNECTED) connected++;
+	CHECK(connected == limit);
+
+	// Each peer that leaves lets one waiting connect through, never more.
+	for (size_t released = 1; released <= peerCount - limit; released++) {
+		for (auto peer : peers) {
+			if (peer->state != ENET_PEER_STATE_CONNECTED) continue;
+			enet_peer_disconnect(peer, 0);
+			break;
+		}
+		CHECK(hosts.serviceUntil([&]() { return hosts.serverConnects == limit + released; }, 10000));
+		enet_host_get_memory_usage(hosts.server, &usage);
+		CHECK(usage.connectedPeers <= limit);
+	}
+	CHECK(hosts.slotListsConsistent());
+}
+
+// Trimmed slots come off the free lists, so the range grows back from the bottom; below the trimmed tail a freed slot is the next one handed out.
+TEST_CASE(PeerSlotTrimThenGrowReusesSlots) {
+	const size_t peerCount = 256;
+	SlotHosts hosts(4096, peerCount);
+	REQUIRE(hosts.server && hosts.client);
+	REQUIRE(peerCount * sizeof(ENetPeer) >= ENET_HOST_PEER_TRIM_THRESHOLD);
+
+	ENetHostMemoryUsage idle{};
+	enet_host_get_memory_usage(hosts.server, &idle);
+
+	auto peers = hosts.connect(peerCount);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == peerCount; }, 10000));
+	for (auto peer : peers) enet_peer_disconnect(peer, 0);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverDisconnects == peerCount && hosts.clientIdle(); }, 10000));
+	hosts.service();
+
+	CHECK(hosts.server->peerSlotCount == 0);
+	CHECK(enet_list_empty(&hosts.server->freePeerSlots[0]));
+	CHECK(hosts.slotListsConsistent());
+
+	ENetHostMemoryUsage trimmed{};
+	enet_host_get_memory_usage(hosts.server, &trimmed);
+	CHECK(trimmed.usedBytes == idle.usedBytes);
+
+	peers = hosts.connect(peerCount);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == peerCount * 2; }, 10000));
+	CHECK(hosts.server->peerSlotCount == peerCount);
+	CHECK(hosts.slotListsConsistent());
+
+	size_t idleSlots = 0;
+	for (size_t slot = 0; slot < hosts.server->peerSlotCount; slot++) if (hosts.server->peers[slot].state != ENET_PEER_STATE_CONNECTED) idleSlots++;
+	CHECK(idleSlots == 0);
+
+	// Frees two slots inside the range one after the other; the last one freed is reused first and the range does not grow.
+	ENetPeer* earlier = &hosts.server->peers[10];
+	ENetPeer* latest = &hosts.server->peers[200];
+	for (ENetPeer* peer : { earlier, latest }) {
+		const size_t disconnects = hosts.serverDisconnects;
+		enet_peer_disconnect(peer, 0);
+		REQUIRE(hosts.serviceUntil([&]() { return hosts.serverDisconnects == disconnects + 1; }, 10000));
+	}
+	hosts.service();
+	CHECK(hosts.server->peerSlotCount == peerCount);
+
+	hosts.connect(1);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == peerCount * 2 + 1; }, 10000));
+	CHECK(hosts.lastConnected == latest);
+
+	hosts.connect(1);
+	REQUIRE(hosts.serviceUntil([&]() { return hosts.serverConnects == peerCount * 2 + 2; }, 10000));
+	CHECK(hosts.lastConnected == earlier);
+	CHECK(hosts.server->peerSlotCount == peerCount);
+	CHECK(hosts.slotListsConsistent());
+}
\ No newline at end of file
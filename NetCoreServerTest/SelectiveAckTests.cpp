@@ -0,0 +1,101 @@
+#include "TestFramework.hpp"
+#include "LinkSimulator.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	struct StreamResult {
+		int runs = 0;
+		int connected = 0;
+		int received = 0;
+		bool inOrder = true;
+		uint64_t retransmitted = 0;
+		uint64_t dropped = 0;
+		std::vector<double> latencies;
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p99 = 0.0;
+
+		void summarize() {
+			if (latencies.empty()) return;
+			std::sort(latencies.begin(), latencies.end());
+			mean = 0.0;
+			for (double latency : latencies) mean += latency / latencies.size();
+			p50 = latencies[latencies.size() / 2];
+			p99 = latencies[latencies.size() * 99 / 100];
+		}
+	};
+
+	// Streams count reliable messages from client to server over a lossy link, one per simulated millisecond, and adds the
+	// time of each from send to delivery to result.
+	void stream(bool selectiveAcknowledge, int count, uint32_t seed, StreamResult& result) {
+		std::vector<double> sentAt;
+		int received = 0;
+
+		LinkRun run;
+		run.simulatedClock = true;
+		run.link.lossPerTenThousand = 200;
+		run.link.delay = 25;
+		run.link.seed = seed;
+		run.configure = [&](LinkedHosts& hosts) {
+			enet_host_selective_acknowledge(hosts.server, selectiveAcknowledge);
+			enet_host_selective_acknowledge(hosts.client, selectiveAcknowledge);
+		};
+		run.send = [&](LinkedHosts& hosts, double elapsed) {
+			if (static_cast<int>(sentAt.size()) < count && elapsed >= static_cast<double>(sentAt.size())) {
+				const int index = static_cast<int>(sentAt.size());
+				uint8_t message[64] = {};
+				std::memcpy(message, &index, sizeof(index));
+				sentAt.push_back(elapsed);
+				enet_peer_send(hosts.clientPeer, 0, enet_packet_create(message, sizeof(message), ENET_PACKET_FLAG_RELIABLE));
+			}
+		};
+		run.receive = [&](const ENetEvent& event, double elapsed) {
+			int index;
+			std::memcpy(&index, event.packet->data, sizeof(index));
+			if (index != received) result.inOrder = false;
+			result.latencies.push_back(elapsed - sentAt[index]);
+			received++;
+		};
+		run.done = [&]() { return received >= count; };
+		const LinkRunResult link = runLink(run);
+
+		result.runs++;
+		if (link.connected) result.connected++;
+		result.received += received;
+		result.retransmitted += link.retransmitted;
+		result.dropped += link.dropped;
+	}
+}
+
+// With 2% loss each way, a loss is repaired after a few later acknowledgements instead of a full retransmission timeout.
+// Which datagrams the link drops decides the tail of a single run, so the same set of loss patterns is run both ways and
+// the percentiles are taken over all of them.
+TEST_CASE(SelectiveAcknowledgeRepairsLossSoonerThanTimeout) {
+	const int count = 4000;
+	const uint32_t seeds = 8;
+	StreamResult plain, selective;
+	for (uint32_t seed = 1; seed <= seeds; seed++) {
+		stream(false, count, seed, plain);
+		stream(true, count, seed, selective);
+	}
+	plain.summarize();
+	selective.summarize();
+
+	REQUIRE(plain.connected == plain.runs);
+	REQUIRE(selective.connected == selective.runs);
+	CHECK(plain.received == count * plain.runs);
+	CHECK(selective.received == count * selective.runs);
+	CHECK(plain.inOrder);
+	CHECK(selective.inOrder);
+	CHECK(selective.mean < plain.mean);
+	CHECK(selective.p99 < plain.p99);
+	CHECK(selective.retransmitted < plain.retransmitted);
+
+	report("%u loss patterns of %d messages each", seeds, count);
+	report("without selective ack: mean %.1f ms, p50 %.1f ms, p99 %.1f ms, %llu retransmitted, %llu datagrams dropped", plain.mean, plain.p50, plain.p99, static_cast<unsigned long long>(plain.retransmitted), static_cast<unsigned long long>(plain.dropped));
+	report("with selective ack:    mean %.1f ms, p50 %.1f ms, p99 %.1f ms, %llu retransmitted, %llu datagrams dropped", selective.mean, selective.p50, selective.p99, static_cast<unsigned long long>(selective.retransmitted), static_cast<unsigned long long>(selective.dropped));
+}
\ No newline at end of file
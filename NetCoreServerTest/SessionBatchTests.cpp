@@ -0,0 +1,183 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <functional>
+#include <thread>
+
+using namespace NetCoreServer;
+using namespace NetCoreServerTest;
+
+namespace {
+	struct Counter {
+		int ticks = 0;
+	};
+
+	class CountingSession : public BatchSession<Counter> {
+	public:
+		CountingSession(SessionInfo info, const SessionCreationOption& opt) : BatchSession<Counter>(std::move(info), opt) {}
+	};
+
+	class CountingBatch : public SessionBatch<Counter> {
+	public:
+		CountingBatch() : SessionBatch<Counter>(200.0) {}
+
+	protected:
+		void tickBatch(std::span<Counter> states, double) override {
+			for (auto& state : states) state.ticks++;
+		}
+	};
+
+	class ThrowingBatch : public SessionBatch<Counter> {
+	public:
+		std::atomic<int> ticks = 0;
+
+		ThrowingBatch() : SessionBatch<Counter>(200.0) {}
+
+		bool release(std::shared_ptr<AbstractSession> session) {
+			return detach(std::move(session));
+		}
+
+	protected:
+		void tickBatch(std::span<Counter>, double) override {
+			ticks++;
+			throw std::runtime_error("tick failed");
+		}
+	};
+
+	// Holds every tick until let go, so a test can act while one is running.
+	class HoldingBatch : public SessionBatch<Counter> {
+	public:
+		std::atomic<bool> hold = true;
+		std::atomic<bool> inTick = false;
+
+		HoldingBatch() : SessionBatch<Counter>(200.0) {}
+
+		bool join(AbstractSession* session) {
+			return attach(session);
+		}
+
+		bool release(std::shared_ptr<AbstractSession> session) {
+			return detach(std::move(session));
+		}
+
+	protected:
+		void tickBatch(std::span<Counter> states, double) override {
+			inTick = true;
+			while (hold.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			for (auto& state : states) state.ticks++;
+		}
+	};
+
+	bool waitFor(const std::function<bool()>& until) {
+		const auto started = std::chrono::steady_clock::now();
+		while (!until()) {
+			if (elapsedMilliseconds(started) > 2000) return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	struct Other {
+		float value = 0.0f;
+	};
+
+	class OtherSession : public BatchSession<Other> {
+	public:
+		OtherSession(SessionInfo info, const SessionCreationOption& opt) : BatchSession<Other>(std::move(info), opt) {}
+	};
+
+	SessionInfo infoOf(const std::string& name) {
+		return SessionInfo{ name, SessionIdentifier{ 0, 0 }, 4, 0, false, false, "", "counting" };
+	}
+
+	const SessionCreationOption option{ "", std::nullopt, 4, false, UserIdentifier{ 1, "" }, "counting" };
+}
+
+// A session the batch cannot take, or a batch session without its batch, is refused instead of getting a thread that ticks at 1/0.
+TEST_CASE(SessionBatchRejectsSessionsItCannotTick) {
+	auto batch = std::make_shared<CountingBatch>();
+	batch->start();
+	{
+		auto server = std::make_shared<SessionServer>(0, 4, 2);
+
+		bool thrown = false;
+		try {
+			server->attachSession(std::make_shared<OtherSession>(infoOf("other"), option), batch);
+		} catch (const SessionAttachError&) {
+			thrown = true;
+		}
+		CHECK(thrown);
+
+		thrown = false;
+		try {
+			server->attachSession(std::make_shared<CountingSession>(infoOf("unbatched"), option));
+		} catch (const SessionAttachError&) {
+			thrown = true;
+		}
+		CHECK(thrown);
+		CHECK(server->getSessionsCount() == 0);
+		CHECK(batch->getSessionsCount() == 0);
+
+		auto session = std::make_shared<CountingSession>(infoOf("counted"), option);
+		CHECK(server->attachSession(session, batch) == 0);
+		CHECK(server->getSessionsCount() == 1);
+		CHECK(batch->getSessionsCount() == 1);
+
+		// States are only read once the batch thread is joined, so give it a few ticks first.
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+		// The batch thread is joined before the server releases its sessions, and before the batch itself goes.
+		batch->stop();
+		CHECK(!batch->isRunning());
+		CHECK(session->getState().ticks > 0);
+	}
+}
+
+// A tick that throws still ends the tick, so detaching from another thread does not wait on it forever, and the batch keeps ticking.
+TEST_CASE(SessionBatchSurvivesThrowingTick) {
+	auto batch = std::make_shared<ThrowingBatch>();
+	batch->start();
+	{
+		auto server = std::make_shared<SessionServer>(0, 4, 2);
+		auto session = std::make_shared<CountingSession>(infoOf("throwing"), option);
+		CHECK(server->attachSession(session, batch) == 0);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(batch->ticks.load() > 1);
+		CHECK(batch->isRunning());
+		CHECK(batch->release(session));
+		CHECK(batch->getSessionsCount() == 0);
+
+		batch->stop();
+	}
+}
+
+// Detaching from another thread mid-tick returns at once; the batch holds the session until the tick ends, then lets it go.
+TEST_CASE(SessionBatchDetachDoesNotWaitForTick) {
+	auto batch = std::make_shared<HoldingBatch>();
+	auto session = std::make_shared<CountingSession>(infoOf("held"), option);
+	auto other = std::make_shared<CountingSession>(infoOf("other"), option);
+	REQUIRE(batch->join(session.get()));
+	REQUIRE(batch->join(other.get()));
+	batch->start();
+	REQUIRE(waitFor([&]() { return batch->inTick.load(); }));
+
+	std::weak_ptr<CountingSession> watched = session;
+	const auto started = std::chrono::steady_clock::now();
+	CHECK(batch->release(session));
+	const double detachMilliseconds = elapsedMilliseconds(started);
+	CHECK(!batch->release(session));
+	session.reset();
+
+	CHECK(detachMilliseconds < 50.0);
+	CHECK(!watched.expired());
+	CHECK(batch->getSessionsCount() == 1);
+
+	batch->hold = false;
+	CHECK(waitFor([&]() { return watched.expired(); }));
+
+	// The other session went on ticking, and leaves the same way; stopping the batch ends the tick it is queued behind.
+	CHECK(batch->release(other));
+	batch->stop();
+	CHECK(other->getState().ticks > 0);
+	CHECK(batch->getSessionsCount() == 0);
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <thread>
+
+using namespace NetCoreServer;
+using namespace NetCoreServerTest;
+
+namespace {
+	// A session on its own tick thread, which the session server stops and joins when it goes.
+	class TickingSession : public AbstractSession {
+	public:
+		std::atomic<int> ticks = 0;
+
+		TickingSession(SessionInfo info, const SessionCreationOption& opt) : AbstractSession(std::move(info), opt, 200.0) {}
+
+		void tick(double) override {
+			ticks++;
+		}
+	};
+
+	// Looks a player up through its session server every tick, which needs the server to be set before the first one.
+	class ProbingSession : public TickingSession {
+	public:
+		std::atomic<int> probes = 0;
+
+		ProbingSession(SessionInfo info, const SessionCreationOption& opt) : TickingSession(std::move(info), opt) {}
+
+		void tick(double deltaTime) override {
+			TickingSession::tick(deltaTime);
+			if (!getPlayerHandle(1).has_value()) probes++;
+		}
+	};
+
+	// Each test gets its own ports, since the servers a manager creates outlive it while their sessions hold them.
+	SessionServerOption serverOption(uint16_t firstPort) {
+		SessionServerOption option{ 8, 2, 4, { firstPort, static_cast<uint16_t>(firstPort + 3) } };
+		return option;
+	}
+
+	SessionCreationOption optionOf(const std::string& name, const std::string& sessionType) {
+		return SessionCreationOption{ name, std::nullopt, 4, false, UserIdentifier{ 1, "" }, sessionType };
+	}
+
+	SessionInfo infoOf(const std::string& name, const std::string& sessionType) {
+		return SessionInfo{ name, SessionIdentifier{ 0, 0 }, 4, 0, false, false, "", sessionType };
+	}
+}
+
+// Attaching a session marks it running, so the tick thread it is given keeps calling tick instead of returning at once.
+// Destroying the server stops the session and joins that thread.
+TEST_CASE(SessionServerTicksAttachedSessions) {
+	auto server = std::make_shared<SessionServer>(0, 4, 2);
+	auto session = std::make_shared<TickingSession>(infoOf("ticking", "ticking"), optionOf("ticking", "ticking"));
+	CHECK(!session->isRunning());
+	CHECK(server->attachSession(session) == 0);
+	CHECK(session->isRunning());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	CHECK(session->ticks.load() > 1);
+
+	server.reset();
+	CHECK(!session->isRunning());
+	const int ticks = session->ticks.load();
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CHECK(session->ticks.load() == ticks);
+}
+
+// Sessions get their server whether they land on a session server the manager already has or on one it creates for them.
+TEST_CASE(SessionManagerGivesSessionsTheirServer) {
+	std::vector<std::shared_ptr<ProbingSession>> created;
+	{
+		SessionManager manager(serverOption(27160), [](uint64_t) { return std::string("author"); });
+		manager.registerSessionGenerator("probing", [&](const SessionInfo& info, const SessionCreationOption& opt) {
+			auto session = std::make_shared<ProbingSession>(info, opt);
+			created.push_back(session);
+			return session;
+			});
+
+		CHECK(manager.createNewSession(optionOf("first", "probing")).success);
+		CHECK(manager.createNewSession(optionOf("second", "probing")).success);
+		REQUIRE(created.size() == 2);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		for (auto& session : created) CHECK(session->probes.load() > 0);
+	}
+	// A session holds its server, so neither goes with the manager; stop the sessions' ticks here.
+	for (auto& session : created) session->stop();
+}
+
+// Created sessions report the port and number they were attached under, and their type, which the session list filters on.
+TEST_CASE(SessionManagerReportsSessionTypeAndIdentifier) {
+	std::vector<std::shared_ptr<TickingSession>> created;
+	{
+		SessionManager manager(serverOption(27164), [](uint64_t) { return std::string("author"); });
+		auto generator = [&](const SessionInfo& info, const SessionCreationOption& opt) {
+			auto session = std::make_shared<TickingSession>(info, opt);
+			created.push_back(session);
+			return session;
+		};
+		manager.registerSessionGenerator("alpha", generator);
+		manager.registerSessionGenerator("beta", generator);
+
+		const auto first = manager.createNewSession(optionOf("first", "alpha"));
+		const auto second = manager.createNewSession(optionOf("second", "alpha"));
+		const auto third = manager.createNewSession(optionOf("third", "beta"));
+		REQUIRE(first.success && second.success && third.success);
+		REQUIRE(first.sessionInfo.has_value() && second.sessionInfo.has_value() && third.sessionInfo.has_value());
+
+		// Both alpha sessions share the first server; beta gets one of its own.
+		CHECK(first.sessionInfo->sessionType == "alpha");
+		CHECK(first.sessionInfo->identifier.sessionPort == 27164);
+		CHECK(first.sessionInfo->identifier.sessionNumber == 0);
+		CHECK(second.sessionInfo->identifier.sessionPort == 27164);
+		CHECK(second.sessionInfo->identifier.sessionNumber == 1);
+		CHECK(third.sessionInfo->sessionType == "beta");
+		CHECK(third.sessionInfo->identifier.sessionPort == 27165);
+		CHECK(third.sessionInfo->identifier.sessionNumber == 0);
+
+		const auto alpha = manager.getSessionList(SessionListOption{ std::nullopt, 1, 10, "alpha" });
+		CHECK(alpha.totalSessionCount == 2);
+		for (auto& info : alpha.sessionInfoList) CHECK(info.sessionType == "alpha");
+		const auto beta = manager.getSessionList(SessionListOption{ std::nullopt, 1, 10, "beta" });
+		CHECK(beta.totalSessionCount == 1);
+		CHECK(beta.sessionInfoList.size() == 1 && beta.sessionInfoList[0].name == "third");
+	}
+	for (auto& session : created) session->stop();
+}
+
+// A placed server runs every construction on the one worker thread it started, not on a thread per call.
+TEST_CASE(PlacedServerReusesItsWorker) {
+	ThreadPlacement placement;
+	for (uint32_t core = 0; core < std::max(1u, std::thread::hardware_concurrency()); core++) placement.cores.push_back(core);
+	auto server = std::make_shared<SessionServer>(0, 4, 2, 1024, 0, 0, BufferSize::DEFAULT, placement);
+
+	const auto first = server->invokeOnNode([]() { return std::this_thread::get_id(); });
+	CHECK(first != std::this_thread::get_id());
+	for (int i = 0; i < 100; i++) {
+		CHECK(server->invokeOnNode([]() { return std::this_thread::get_id(); }) == first);
+	}
+
+	bool thrown = false;
+	try {
+		server->invokeOnNode([]() -> int { throw std::runtime_error("construction failed"); });
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	// The default placement keeps construction on the caller.
+	auto unplaced = std::make_shared<SessionServer>(0, 4, 2);
+	CHECK(unplaced->invokeOnNode([]() { return std::this_thread::get_id(); }) == std::this_thread::get_id());
+}
+
+// Code written against the reference-returning accessors still compiles and sees what was published last.
+TEST_CASE(SessionInfoAccessorsStayCompatible) {
+	TickingSession session(infoOf("before", "ticking"), optionOf("before", "ticking"));
+	const SessionInfo& info = session.getSessionInfo();
+	const std::string& type = session.getSessionType();
+	auto snapshot = session.getSessionInfoSnapshot();
+
+	session.setSessionInfo(infoOf("after", "ticking"));
+	CHECK(info.name == "before");
+	CHECK(type == "ticking");
+	CHECK(snapshot->name == "before");
+	CHECK(session.getSessionInfo().name == "after");
+	CHECK(session.getSessionInfoSnapshot()->name == "after");
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "TestFramework.hpp"
+#include <NetCoreServer.hpp>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace NetCoreServer;
+using namespace NetCoreServerTest;
+
+namespace {
+	// Hands blocks from the owning thread to a freeing thread.
+	struct Handoff {
+		std::mutex mutex;
+		std::deque<void*> blocks;
+		bool done = false;
+	};
+}
+
+// Blocks freed on another thread while the owner keeps allocating come back to the owner through the remote list,
+// so the owner keeps reusing the memory it already carved, and no block is handed out twice.
+TEST_CASE(SlabAllocatorReclaimsCrossThreadFrees) {
+	REQUIRE(SlabAllocator::isInstalled());
+
+	SlabPool* pool = SlabAllocator::acquirePool();
+	REQUIRE(pool != nullptr);
+	// A pool released by an earlier host keeps its counts.
+	const AllocatorStats start = pool->getStats();
+
+	const size_t total = 200000;
+	const size_t blockSize = 200;
+	Handoff handoff;
+	size_t corrupted = 0;
+
+	std::thread freer([&]() {
+		for (;;) {
+			void* block = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(handoff.mutex);
+				if (!handoff.blocks.empty()) {
+					block = handoff.blocks.front();
+					handoff.blocks.pop_front();
+				} else if (handoff.done) {
+					break;
+				}
+			}
+			if (block == nullptr) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Each block is filled with its first byte; a block handed out twice is overwritten before it gets here.
+			auto bytes = static_cast<uint8_t*>(block);
+			for (size_t i = 1; i < blockSize; i++) {
+				if (bytes[i] != bytes[0]) {
+					corrupted++;
+					break;
+				}
+			}
+			enet_free(block);
+		}
+		});
+
+	AllocatorStats warm{}, end{};
+	std::thread owner([&]() {
+		SlabAllocator::bindCurrentThread(pool);
+		for (size_t i = 0; i < total; i++) {
+			void* block = enet_malloc(blockSize);
+			memset(block, static_cast<int>(i & 0xFF), blockSize);
+
+			std::lock_guard<std::mutex> lock(handoff.mutex);
+			handoff.blocks.push_back(block);
+			if (i == total / 10) warm = pool->getStats();
+		}
+		{
+			std::lock_guard<std::mutex> lock(handoff.mutex);
+			handoff.done = true;
+		}
+		end = pool->getStats();
+		SlabAllocator::bindCurrentThread(nullptr);
+		});
+
+	owner.join();
+	freer.join();
+
+	CHECK(corrupted == 0);
+	CHECK(pool->getStats().remoteFrees - start.remoteFrees == total);
+	CHECK(end.hits + end.misses - start.hits - start.misses >= total);
+	// After the first tenth the freer keeps up, so nearly every later allocation is a reclaimed block.
+	CHECK(end.hits - warm.hits > (total - total / 10) * 9 / 10);
+	report("%llu hits, %llu misses, %llu KB reserved after %zu allocations freed on another thread",
+		static_cast<unsigned long long>(end.hits), static_cast<unsigned long long>(end.misses), static_cast<unsigned long long>(end.reservedBytes / 1024), total);
+
+	// A released pool is handed to the next host with the memory it already carved.
+	SlabAllocator::releasePool(pool);
+	SlabPool* reused = SlabAllocator::acquirePool();
+	CHECK(reused == pool);
+	CHECK(reused->getStats().reservedBytes == end.reservedBytes);
+	SlabAllocator::releasePool(reused);
+}
+
+// Requests above the largest class, and requests from a thread with no bound pool, go to malloc and are freed there.
+TEST_CASE(SlabAllocatorFallsBackToMalloc) {
+	REQUIRE(SlabAllocator::isInstalled());
+
+	const uint64_t before = SlabAllocator::getFallbackAllocations();
+	void* unbound = enet_malloc(64);
+	REQUIRE(unbound != nullptr);
+	memset(unbound, 1, 64);
+	enet_free(unbound);
+
+	SlabPool* pool = SlabAllocator::acquirePool();
+	REQUIRE(pool != nullptr);
+	std::thread owner([&]() {
+		SlabAllocator::bindCurrentThread(pool);
+		void* large = enet_malloc(SlabAllocator::MAX_BLOCK_SIZE + 1);
+		if (large != nullptr) {
+			memset(large, 2, SlabAllocator::MAX_BLOCK_SIZE + 1);
+			enet_free(large);
+		}
+		SlabAllocator::bindCurrentThread(nullptr);
+		});
+	owner.join();
+	SlabAllocator::releasePool(pool);
+
+	CHECK(SlabAllocator::getFallbackAllocations() - before == 2);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "TestFramework.hpp"
+#include <exception>
+
+namespace NetCoreServerTest {
+	TestRegistry& TestRegistry::instance() {
+		static TestRegistry registry;
+		return registry;
+	}
+
+	void TestRegistry::fail(const char* file, int line, const std::string& message) {
+		failures++;
+		std::printf("    %s:%d: %s\n", file, line, message.c_str());
+		std::fflush(stdout);
+	}
+
+	size_t TestRegistry::run(const std::string& filter) {
+		size_t failed = 0, ran = 0;
+		for (auto& test : tests) {
+			if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) continue;
+			ran++;
+			std::printf("[ RUN  ] %s\n", test.name);
+			std::fflush(stdout);
+			const size_t failuresBefore = failures;
+			const auto started = std::chrono::steady_clock::now();
+			try {
+				test.body();
+			}
+			catch (const std::exception& e) {
+				fail(__FILE__, __LINE__, std::string("uncaught exception: ") + e.what());
+			}
+			const bool passed = failures == failuresBefore;
+			if (!passed) failed++;
+			std::printf("[ %s ] %s (%.0f ms)\n", passed ? " OK " : "FAIL", test.name, elapsedMilliseconds(started));
+		}
+		std::printf("%zu of %zu tests passed\n", ran - failed, ran);
+		return failed;
+	}
+}
\ No newline at end of file
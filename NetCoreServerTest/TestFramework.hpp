@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static NetCoreServerTest::TestRegistrar name##Registrar(#name, name); \
+	static void name()
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) NetCoreServerTest::TestRegistry::instance().fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+	} while (0)
+
+// Stops the test at the first failure, for checks later steps depend on.
+#define REQUIRE(condition) \
+	do { \
+		if (!(condition)) { \
+			NetCoreServerTest::TestRegistry::instance().fail(__FILE__, __LINE__, "REQUIRE(" #condition ") failed"); \
+			return; \
+		} \
+	} while (0)
+
+namespace NetCoreServerTest {
+	// A test case registers itself at static initialization and fails through CHECK; a test that throws fails as well.
+	struct TestCase {
+		const char* name;
+		std::function<void()> body;
+	};
+
+	class TestRegistry final {
+	private:
+		std::vector<TestCase> tests;
+		size_t failures = 0;
+
+	public:
+		static TestRegistry& instance();
+
+		void add(const char* name, std::function<void()> body) {
+			tests.push_back({ name, std::move(body) });
+		}
+
+		void fail(const char* file, int line, const std::string& message);
+
+		// Runs every test whose name contains filter and returns the number of failed tests.
+		size_t run(const std::string& filter);
+	};
+
+	struct TestRegistrar {
+		TestRegistrar(const char* name, void (*body)()) {
+			TestRegistry::instance().add(name, body);
+		}
+	};
+
+	// Prints one line of a test's measurements, so benchmarks show up next to the verdicts.
+	template<typename... Args>
+	void report(const char* format, Args... args) {
+		std::printf("    ");
+		std::printf(format, args...);
+		std::printf("\n");
+		std::fflush(stdout);
+	}
+
+	inline double elapsedMilliseconds(std::chrono::steady_clock::time_point since) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "TestFramework.hpp"
+#include <enet/enet.h>
+#include <random>
+#include <vector>
+
+using namespace NetCoreServerTest;
+
+namespace {
+	bool isActive(ENetHost* host, ENetPeer* peer) {
+		for (ENetListIterator node = enet_list_begin(&host->activePeers); node != enet_list_end(&host->activePeers); node = enet_list_next(node)) {
+			if (node == &peer->sendList) return true;
+		}
+		return false;
+	}
+}
+
+// Schedules peers at random deadlines against a model of when each is due, with the clock wrapping past zero part way.
+// After every advance exactly the peers that are due must be active, and the wheel must never report a wake-up later than the earliest deadline.
+TEST_CASE(TimerWheelFiresRandomDeadlinesAcrossWraparound) {
+	const size_t peerCount = 2000;
+	ENetHost* host = enet_host_create(nullptr, peerCount, 1, 0, 0, 0);
+	REQUIRE(host != nullptr);
+
+	std::vector<ENetPeer*> peers;
+	for (size_t i = 0; i < peerCount; i++) peers.push_back(enet_host_grow_peer_slots(host));
+	REQUIRE(peers.back() != nullptr);
+
+	// Starts a little under the wrap, so deadlines on both sides of it are in the wheel at once.
+	host->serviceTime = host->timerWheelTime = 0xFFFFFFFFu - 200000;
+
+	std::mt19937 random(35);
+	// Mostly within the finest levels, some spanning the coarsest one.
+	auto randomDelay = [&]() -> uint32_t {
+		switch (random() % 4) {
+		case 0: return random() % 64;
+		case 1: return random() % 4096;
+		case 2: return random() % 262144;
+		default: return random() % (1u << 23);
+		}
+	};
+
+	std::vector<bool> scheduled(peerCount, false);
+	std::vector<uint32_t> deadlines(peerCount, 0);
+	auto schedule = [&](size_t index) {
+		deadlines[index] = host->serviceTime + randomDelay();
+		scheduled[index] = true;
+		enet_timer_wheel_schedule(host, peers[index], deadlines[index]);
+	};
+
+	for (size_t i = 0; i < peerCount; i++) schedule(i);
+
+	size_t fired = 0, early = 0, late = 0, lateWakeups = 0;
+	bool wrapped = false;
+	for (int round = 0; round < 3000; round++) {
+		// Peers already due are on the active list, which a send pass serves without waiting.
+		uint32_t earliest = host->serviceTime + (1u << 24);
+		for (size_t i = 0; i < peerCount; i++) {
+			if (scheduled[i] && peers[i]->sendState == ENET_PEER_SEND_TIMER && ENET_TIME_LESS(deadlines[i], earliest)) earliest = deadlines[i];
+		}
+
+		const uint32_t limit = host->serviceTime + 1000000;
+		const uint32_t wakeup = enet_timer_wheel_next_deadline(host, limit);
+		if (ENET_TIME_GREATER(wakeup, earliest) && ENET_TIME_LESS(earliest, limit)) lateWakeups++;
+
+		// Usually steps to the reported wake-up or just short of it, and now and then jumps far enough to rebuild the wheel.
+		const uint32_t before = host->serviceTime;
+		switch (random() % 8) {
+		case 0: host->serviceTime += (1u << 18) + random() % (1u << 20); break;
+		case 1: host->serviceTime += random() % 5000; break;
+		case 2: host->serviceTime = wakeup - 1; break;
+		default: host->serviceTime = wakeup; break;
+		}
+		if (host->serviceTime < before) wrapped = true;
+		enet_timer_wheel_advance(host);
+
+		for (size_t i = 0; i < peerCount; i++) {
+			if (!scheduled[i]) continue;
+
+			const bool due = ENET_TIME_LESS_EQUAL(deadlines[i], host->serviceTime);
+			const bool active = peers[i]->sendState == ENET_PEER_SEND_ACTIVE;
+			if (active && !due) early++;
+			if (due && !active) late++;
+			if (!due || !active) continue;
+
+			// A peer served here is rescheduled or left off every list, as a send pass would.
+			fired++;
+			enet_list_remove(&peers[i]->sendList);
+			peers[i]->sendState = ENET_PEER_SEND_NONE;
+			scheduled[i] = false;
+			if (random() % 4 != 0) schedule(i);
+		}
+
+		// Rescheduling a waiting peer moves it rather than leaving a second entry behind.
+		for (int moves = 0; moves < 20; moves++) schedule(random() % peerCount);
+
+		// Peers left idle come back eventually.
+		for (size_t i = 0; i < peerCount; i++) {
+			if (!scheduled[i] && random() % 16 == 0) schedule(i);
+		}
+	}
+
+	size_t listed = 0;
+	for (size_t i = 0; i < peerCount; i++) {
+		if (scheduled[i] && peers[i]->sendState == ENET_PEER_SEND_ACTIVE && !isActive(host, peers[i])) listed++;
+	}
+
+	CHECK(wrapped);
+	CHECK(fired > peerCount);
+	CHECK(early == 0);
+	CHECK(late == 0);
+	CHECK(lateWakeups == 0);
+	CHECK(listed == 0);
+
+	report("%zu peers fired %zu times over %u ms", peerCount, fired, host->serviceTime - (0xFFFFFFFFu - 200000));
+	enet_host_destroy(host);
+}
\ No newline at end of file